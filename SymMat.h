@@ -28,699 +28,4555 @@ the operations are performed are less.
 #include <iomanip>  			//to use setw()
 #include <cassert>  			//to use assert function
 #include <cmath>				//to calculate the squareroot of a number
+#include <limits>				//to use the machine epsilon
 #include <cstdlib>  			//to use std::exit function 
+#include <cstring>				//to use std::memcpy
+#include <algorithm>			//to use std::copy
+#include <array>				//storage of the fixed order matrix
+#include <type_traits>			//to use std::enable_if
+#include <new>					//to use std::bad_alloc
 #include <Eigen/Eigen> 			//to pass eigen matrix as arguments to functions
 
+//Vector instructions used by the kernels(can be switched off by defining SYMMAT_NO_SIMD)
+#if !defined(SYMMAT_NO_SIMD) && defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define SYMMAT_X86_DISPATCH
+#include <immintrin.h>
+#elif !defined(SYMMAT_NO_SIMD) && (defined(__ARM_NEON) || defined(__aarch64__))
+#define SYMMAT_HAVE_NEON
+#include <arm_neon.h>
+#endif
+
+//Transparent huge pages for the large matrices(SymMatHugePages), only on Linux
+#if defined(__linux__)
+#include <sys/mman.h>
+#if defined(MADV_HUGEPAGE)
+#define SYMMAT_HAVE_HUGEPAGES
+#endif
+#endif
+
 
 /*************************************************************************************************
-						CLASS DEFINITION
-						----------------
-Template parameters used are same as in eigen so that it will be easy to merge with the main branch
+						SIMD REDUCTION KERNELS
+						----------------------
+The reductions(sum, prod, min, max) run over the packed vector, which is one contiguous block of memory.
+They are written with several independent accumulators so that the additions/multiplications of
+consecutive elements do not wait on each other, and the loads can stay ahead of the arithmetic.
+
+For float and double there are explicit kernels for AVX2 and AVX-512(chosen when the program runs,
+depending on what the processor supports) and for NEON(on ARM, where it is always available).
+For other scalar types, or when SYMMAT_NO_SIMD is defined, the portable version is used.
 **************************************************************************************************/
-template <typename _Scalar>
-class SymMat
+namespace SymMatInternal
+{
+
+//Instruction sets the kernels can be dispatched to
+enum SimdLevel { SimdScalar=0, SimdNeon=1, SimdAvx2=2, SimdAvx512=3 };
+
+//Detects once which instruction set the processor supports
+inline int simdLevel()
+{
+#if defined(SYMMAT_NO_SIMD)
+	return SimdScalar;
+#elif defined(SYMMAT_X86_DISPATCH)
+	static const int level= __builtin_cpu_supports("avx512f") ? SimdAvx512 :
+							(__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) ? SimdAvx2 : SimdScalar;
+	return level;
+#elif defined(SYMMAT_HAVE_NEON)
+	return SimdNeon;
+#else
+	return SimdScalar;
+#endif
+}
+
+//Portable reductions with four accumulators--------------------------------------------------------
+template<typename _Scalar>
+_Scalar sumScalar(const _Scalar* p,Eigen::Index n)
+{
+	_Scalar a0=0,a1=0,a2=0,a3=0;
+	Eigen::Index k=0;
+	for(;k+4<=n;k+=4)
+	{
+		a0+=p[k]; a1+=p[k+1]; a2+=p[k+2]; a3+=p[k+3];
+	}
+	for(;k<n;k++)
+	{
+		a0+=p[k];
+	}
+	return (a0+a1)+(a2+a3);
+}
+
+template<typename _Scalar>
+_Scalar prodScalar(const _Scalar* p,Eigen::Index n)
+{
+	_Scalar a0=1,a1=1,a2=1,a3=1;
+	Eigen::Index k=0;
+	for(;k+4<=n;k+=4)
+	{
+		a0*=p[k]; a1*=p[k+1]; a2*=p[k+2]; a3*=p[k+3];
+	}
+	for(;k<n;k++)
+	{
+		a0*=p[k];
+	}
+	return (a0*a1)*(a2*a3);
+}
+
+template<typename _Scalar>
+_Scalar maxScalar(const _Scalar* p,Eigen::Index n)
+{
+	_Scalar a0=p[0],a1=p[0],a2=p[0],a3=p[0];
+	Eigen::Index k=0;
+	for(;k+4<=n;k+=4)
+	{
+		a0=p[k]>a0?p[k]:a0;       a1=p[k+1]>a1?p[k+1]:a1;
+		a2=p[k+2]>a2?p[k+2]:a2;   a3=p[k+3]>a3?p[k+3]:a3;
+	}
+	for(;k<n;k++)
+	{
+		a0=p[k]>a0?p[k]:a0;
+	}
+	a0=a1>a0?a1:a0;
+	a2=a3>a2?a3:a2;
+	return a2>a0?a2:a0;
+}
+
+template<typename _Scalar>
+_Scalar minScalar(const _Scalar* p,Eigen::Index n)
+{
+	_Scalar a0=p[0],a1=p[0],a2=p[0],a3=p[0];
+	Eigen::Index k=0;
+	for(;k+4<=n;k+=4)
+	{
+		a0=p[k]<a0?p[k]:a0;       a1=p[k+1]<a1?p[k+1]:a1;
+		a2=p[k+2]<a2?p[k+2]:a2;   a3=p[k+3]<a3?p[k+3]:a3;
+	}
+	for(;k<n;k++)
+	{
+		a0=p[k]<a0?p[k]:a0;
+	}
+	a0=a1<a0?a1:a0;
+	a2=a3<a2?a3:a2;
+	return a2<a0?a2:a0;
+}
+
+/*
+Vector kernels: each one keeps four vector registers of accumulators, then combines them and
+finishes the elements which do not fill a whole vector with the portable code.
+The macro is expanded once per instruction set and scalar type.
+*/
+#define SYMMAT_VECTOR_REDUCTION(NAME,ATTR,T,VEC,W,LOADU,OP,INIT,SCALARFN)		\
+ATTR inline T NAME(const T* p,Eigen::Index n)										\
+{																					\
+	if(n<4*(W))																		\
+	{																				\
+		return SCALARFN(p,n);														\
+	}																				\
+	VEC a0=INIT,a1=INIT,a2=INIT,a3=INIT;											\
+	Eigen::Index k=0;																\
+	for(;k+4*(W)<=n;k+=4*(W))														\
+	{																				\
+		a0=OP(a0,LOADU(p+k));														\
+		a1=OP(a1,LOADU(p+k+(W)));													\
+		a2=OP(a2,LOADU(p+k+2*(W)));													\
+		a3=OP(a3,LOADU(p+k+3*(W)));													\
+	}																				\
+	a0=OP(OP(a0,a1),OP(a2,a3));														\
+	T lanes[(W)+4*(W)];																\
+	std::memcpy(lanes,&a0,sizeof(VEC));												\
+	std::copy(p+k,p+n,lanes+(W));													\
+	return SCALARFN(lanes,(W)+(n-k));												\
+}
+
+#if defined(SYMMAT_X86_DISPATCH)
+#define SYMMAT_AVX2 __attribute__((target("avx2,fma")))
+#define SYMMAT_AVX512 __attribute__((target("avx512f")))
+
+SYMMAT_VECTOR_REDUCTION(sumAvx2,SYMMAT_AVX2,float,__m256,8,_mm256_loadu_ps,_mm256_add_ps,_mm256_setzero_ps(),sumScalar)
+SYMMAT_VECTOR_REDUCTION(prodAvx2,SYMMAT_AVX2,float,__m256,8,_mm256_loadu_ps,_mm256_mul_ps,_mm256_set1_ps(1.0f),prodScalar)
+SYMMAT_VECTOR_REDUCTION(maxAvx2,SYMMAT_AVX2,float,__m256,8,_mm256_loadu_ps,_mm256_max_ps,_mm256_set1_ps(p[0]),maxScalar)
+SYMMAT_VECTOR_REDUCTION(minAvx2,SYMMAT_AVX2,float,__m256,8,_mm256_loadu_ps,_mm256_min_ps,_mm256_set1_ps(p[0]),minScalar)
+SYMMAT_VECTOR_REDUCTION(sumAvx2,SYMMAT_AVX2,double,__m256d,4,_mm256_loadu_pd,_mm256_add_pd,_mm256_setzero_pd(),sumScalar)
+SYMMAT_VECTOR_REDUCTION(prodAvx2,SYMMAT_AVX2,double,__m256d,4,_mm256_loadu_pd,_mm256_mul_pd,_mm256_set1_pd(1.0),prodScalar)
+SYMMAT_VECTOR_REDUCTION(maxAvx2,SYMMAT_AVX2,double,__m256d,4,_mm256_loadu_pd,_mm256_max_pd,_mm256_set1_pd(p[0]),maxScalar)
+SYMMAT_VECTOR_REDUCTION(minAvx2,SYMMAT_AVX2,double,__m256d,4,_mm256_loadu_pd,_mm256_min_pd,_mm256_set1_pd(p[0]),minScalar)
+
+SYMMAT_VECTOR_REDUCTION(sumAvx512,SYMMAT_AVX512,float,__m512,16,_mm512_loadu_ps,_mm512_add_ps,_mm512_setzero_ps(),sumScalar)
+SYMMAT_VECTOR_REDUCTION(prodAvx512,SYMMAT_AVX512,float,__m512,16,_mm512_loadu_ps,_mm512_mul_ps,_mm512_set1_ps(1.0f),prodScalar)
+SYMMAT_VECTOR_REDUCTION(maxAvx512,SYMMAT_AVX512,float,__m512,16,_mm512_loadu_ps,_mm512_max_ps,_mm512_set1_ps(p[0]),maxScalar)
+SYMMAT_VECTOR_REDUCTION(minAvx512,SYMMAT_AVX512,float,__m512,16,_mm512_loadu_ps,_mm512_min_ps,_mm512_set1_ps(p[0]),minScalar)
+SYMMAT_VECTOR_REDUCTION(sumAvx512,SYMMAT_AVX512,double,__m512d,8,_mm512_loadu_pd,_mm512_add_pd,_mm512_setzero_pd(),sumScalar)
+SYMMAT_VECTOR_REDUCTION(prodAvx512,SYMMAT_AVX512,double,__m512d,8,_mm512_loadu_pd,_mm512_mul_pd,_mm512_set1_pd(1.0),prodScalar)
+SYMMAT_VECTOR_REDUCTION(maxAvx512,SYMMAT_AVX512,double,__m512d,8,_mm512_loadu_pd,_mm512_max_pd,_mm512_set1_pd(p[0]),maxScalar)
+SYMMAT_VECTOR_REDUCTION(minAvx512,SYMMAT_AVX512,double,__m512d,8,_mm512_loadu_pd,_mm512_min_pd,_mm512_set1_pd(p[0]),minScalar)
+
+//Chooses the kernel for the instruction set found at run time
+#define SYMMAT_DISPATCH(NAME,T)															\
+inline T NAME(const T* p,Eigen::Index n)												\
+{																						\
+	switch(simdLevel())																	\
+	{																					\
+		case SimdAvx512: return NAME##Avx512(p,n);										\
+		case SimdAvx2:   return NAME##Avx2(p,n);										\
+		default:         return NAME##Scalar(p,n);										\
+	}																					\
+}
+
+#elif defined(SYMMAT_HAVE_NEON)
+SYMMAT_VECTOR_REDUCTION(sumNeon,,float,float32x4_t,4,vld1q_f32,vaddq_f32,vdupq_n_f32(0.0f),sumScalar)
+SYMMAT_VECTOR_REDUCTION(prodNeon,,float,float32x4_t,4,vld1q_f32,vmulq_f32,vdupq_n_f32(1.0f),prodScalar)
+SYMMAT_VECTOR_REDUCTION(maxNeon,,float,float32x4_t,4,vld1q_f32,vmaxq_f32,vdupq_n_f32(p[0]),maxScalar)
+SYMMAT_VECTOR_REDUCTION(minNeon,,float,float32x4_t,4,vld1q_f32,vminq_f32,vdupq_n_f32(p[0]),minScalar)
+#if defined(__aarch64__)
+SYMMAT_VECTOR_REDUCTION(sumNeon,,double,float64x2_t,2,vld1q_f64,vaddq_f64,vdupq_n_f64(0.0),sumScalar)
+SYMMAT_VECTOR_REDUCTION(prodNeon,,double,float64x2_t,2,vld1q_f64,vmulq_f64,vdupq_n_f64(1.0),prodScalar)
+SYMMAT_VECTOR_REDUCTION(maxNeon,,double,float64x2_t,2,vld1q_f64,vmaxq_f64,vdupq_n_f64(p[0]),maxScalar)
+SYMMAT_VECTOR_REDUCTION(minNeon,,double,float64x2_t,2,vld1q_f64,vminq_f64,vdupq_n_f64(p[0]),minScalar)
+#else
+inline double sumNeon(const double* p,Eigen::Index n) { return sumScalar(p,n); }
+inline double prodNeon(const double* p,Eigen::Index n) { return prodScalar(p,n); }
+inline double maxNeon(const double* p,Eigen::Index n) { return maxScalar(p,n); }
+inline double minNeon(const double* p,Eigen::Index n) { return minScalar(p,n); }
+#endif
+
+#define SYMMAT_DISPATCH(NAME,T)															\
+inline T NAME(const T* p,Eigen::Index n)												\
+{																						\
+	return simdLevel()==SimdNeon ? NAME##Neon(p,n) : NAME##Scalar(p,n);					\
+}
+#else
+
+#define SYMMAT_DISPATCH(NAME,T)															\
+inline T NAME(const T* p,Eigen::Index n)												\
+{																						\
+	return NAME##Scalar(p,n);															\
+}
+#endif
+
+//Entry points: generic types use the portable kernels, float and double are dispatched
+template<typename _Scalar> _Scalar packedSum(const _Scalar* p,Eigen::Index n)  { return sumScalar(p,n); }
+template<typename _Scalar> _Scalar packedProd(const _Scalar* p,Eigen::Index n) { return prodScalar(p,n); }
+template<typename _Scalar> _Scalar packedMax(const _Scalar* p,Eigen::Index n)  { return maxScalar(p,n); }
+template<typename _Scalar> _Scalar packedMin(const _Scalar* p,Eigen::Index n)  { return minScalar(p,n); }
+
+namespace Dispatch
+{
+SYMMAT_DISPATCH(sum,float)
+SYMMAT_DISPATCH(prod,float)
+SYMMAT_DISPATCH(max,float)
+SYMMAT_DISPATCH(min,float)
+SYMMAT_DISPATCH(sum,double)
+SYMMAT_DISPATCH(prod,double)
+SYMMAT_DISPATCH(max,double)
+SYMMAT_DISPATCH(min,double)
+}
+
+template<> inline float  packedSum<float>(const float* p,Eigen::Index n)    { return Dispatch::sum(p,n); }
+template<> inline float  packedProd<float>(const float* p,Eigen::Index n)   { return Dispatch::prod(p,n); }
+template<> inline float  packedMax<float>(const float* p,Eigen::Index n)    { return Dispatch::max(p,n); }
+template<> inline float  packedMin<float>(const float* p,Eigen::Index n)    { return Dispatch::min(p,n); }
+template<> inline double packedSum<double>(const double* p,Eigen::Index n)  { return Dispatch::sum(p,n); }
+template<> inline double packedProd<double>(const double* p,Eigen::Index n) { return Dispatch::prod(p,n); }
+template<> inline double packedMax<double>(const double* p,Eigen::Index n)  { return Dispatch::max(p,n); }
+template<> inline double packedMin<double>(const double* p,Eigen::Index n)  { return Dispatch::min(p,n); }
+
+#undef SYMMAT_DISPATCH
+#undef SYMMAT_VECTOR_REDUCTION
+
+} //namespace SymMatInternal
+
+
+/*************************************************************************************************
+						SYMMETRIC MATRIX-VECTOR PRODUCT KERNELS
+						---------------------------------------
+y = alpha*S*x + beta*y  on the packed vector.
+
+Row i of the packed vector holds S(i,i),S(i,i+1),...,S(i,order-1) one after another. Each of these
+elements is needed twice: S(i,j)*x(j) goes to y(i) and S(j,i)*x(i)=S(i,j)*x(i) goes to y(j).
+Both are done in the same loop over the row(a dot product and an axpy), so every stored element
+is read from memory only once.
+
+With OpenMP the rows are split between the threads so that each thread gets the same number of
+elements(the rows get shorter towards the bottom). The axpy part writes into the whole y, so every
+thread writes into its own copy of y, and the copies are added together at the end.
+**************************************************************************************************/
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+//Below this order the product is always done by one thread
+#ifndef SYMMAT_PARALLEL_THRESHOLD
+#define SYMMAT_PARALLEL_THRESHOLD 512
+#endif
+
+namespace SymMatInternal
+{
+
+//Returns a(0..n-1).x(0..n-1) and does y(0..n-1)+=a(0..n-1)*xi
+template<typename _Scalar>
+_Scalar dotAxpyScalar(const _Scalar* a,const _Scalar* x,_Scalar* y,Eigen::Index n,_Scalar xi)
+{
+	_Scalar t0=0,t1=0;
+	Eigen::Index k=0;
+	for(;k+2<=n;k+=2)
+	{
+		t0+=a[k]*x[k];       y[k]+=a[k]*xi;
+		t1+=a[k+1]*x[k+1];   y[k+1]+=a[k+1]*xi;
+	}
+	for(;k<n;k++)
+	{
+		t0+=a[k]*x[k];       y[k]+=a[k]*xi;
+	}
+	return t0+t1;
+}
+
+#define SYMMAT_VECTOR_DOTAXPY(NAME,ATTR,T,VEC,W,LOADU,STOREU,SET1,ZERO,FMA)			\
+ATTR inline T NAME(const T* a,const T* x,T* y,Eigen::Index n,T xi)					\
+{																					\
+	VEC vxi=SET1(xi),t0=ZERO,t1=ZERO;												\
+	Eigen::Index k=0;																\
+	for(;k+2*(W)<=n;k+=2*(W))														\
+	{																				\
+		VEC a0=LOADU(a+k),a1=LOADU(a+k+(W));										\
+		t0=FMA(a0,LOADU(x+k),t0);													\
+		t1=FMA(a1,LOADU(x+k+(W)),t1);												\
+		STOREU(y+k,FMA(a0,vxi,LOADU(y+k)));											\
+		STOREU(y+k+(W),FMA(a1,vxi,LOADU(y+k+(W))));								\
+	}																				\
+	T lanes[W];																		\
+	t0=FMA(t1,SET1(T(1)),t0);														\
+	std::memcpy(lanes,&t0,sizeof(VEC));												\
+	T total=0;																		\
+	for(int l=0;l<(W);l++)															\
+	{																				\
+		total+=lanes[l];															\
+	}																				\
+	return total+dotAxpyScalar(a+k,x+k,y+k,n-k,xi);									\
+}
+
+#if defined(SYMMAT_X86_DISPATCH)
+SYMMAT_VECTOR_DOTAXPY(dotAxpyAvx2,SYMMAT_AVX2,float,__m256,8,_mm256_loadu_ps,_mm256_storeu_ps,_mm256_set1_ps,_mm256_setzero_ps(),_mm256_fmadd_ps)
+SYMMAT_VECTOR_DOTAXPY(dotAxpyAvx2,SYMMAT_AVX2,double,__m256d,4,_mm256_loadu_pd,_mm256_storeu_pd,_mm256_set1_pd,_mm256_setzero_pd(),_mm256_fmadd_pd)
+SYMMAT_VECTOR_DOTAXPY(dotAxpyAvx512,SYMMAT_AVX512,float,__m512,16,_mm512_loadu_ps,_mm512_storeu_ps,_mm512_set1_ps,_mm512_setzero_ps(),_mm512_fmadd_ps)
+SYMMAT_VECTOR_DOTAXPY(dotAxpyAvx512,SYMMAT_AVX512,double,__m512d,8,_mm512_loadu_pd,_mm512_storeu_pd,_mm512_set1_pd,_mm512_setzero_pd(),_mm512_fmadd_pd)
+#elif defined(SYMMAT_HAVE_NEON)
+#define SYMMAT_NEON_FMA32(a,b,c) vmlaq_f32(c,a,b)
+SYMMAT_VECTOR_DOTAXPY(dotAxpyNeon,,float,float32x4_t,4,vld1q_f32,vst1q_f32,vdupq_n_f32,vdupq_n_f32(0.0f),SYMMAT_NEON_FMA32)
+#undef SYMMAT_NEON_FMA32
+#endif
+#undef SYMMAT_VECTOR_DOTAXPY
+
+//Generic types use the portable kernel, float and double are dispatched like the reductions
+template<typename _Scalar>
+_Scalar dotAxpy(const _Scalar* a,const _Scalar* x,_Scalar* y,Eigen::Index n,_Scalar xi)
+{
+	return dotAxpyScalar(a,x,y,n,xi);
+}
+
+#if defined(SYMMAT_X86_DISPATCH)
+template<>
+inline float dotAxpy<float>(const float* a,const float* x,float* y,Eigen::Index n,float xi)
+{
+	switch(simdLevel())
+	{
+		case SimdAvx512: return dotAxpyAvx512(a,x,y,n,xi);
+		case SimdAvx2:   return dotAxpyAvx2(a,x,y,n,xi);
+		default:         return dotAxpyScalar(a,x,y,n,xi);
+	}
+}
+
+template<>
+inline double dotAxpy<double>(const double* a,const double* x,double* y,Eigen::Index n,double xi)
+{
+	switch(simdLevel())
+	{
+		case SimdAvx512: return dotAxpyAvx512(a,x,y,n,xi);
+		case SimdAvx2:   return dotAxpyAvx2(a,x,y,n,xi);
+		default:         return dotAxpyScalar(a,x,y,n,xi);
+	}
+}
+#elif defined(SYMMAT_HAVE_NEON)
+template<>
+inline float dotAxpy<float>(const float* a,const float* x,float* y,Eigen::Index n,float xi)
+{
+	return dotAxpyNeon(a,x,y,n,xi);
+}
+#endif
+
+//Position of the diagonal element of row i in the packed vector of a matrix of order n
+inline Eigen::Index diagIndex(Eigen::Index n,Eigen::Index i)
+{
+	return i*n-(i*(i-1))/2;
+}
+
+/*
+No. of elements n(n+1)/2 of the packed vector of order n, or -1 when n is negative or the vector would not
+fit in the address space. The product is checked before it is made, so it never overflows.
+*/
+template<typename _Scalar>
+Eigen::Index packedElements(Eigen::Index n)
+{
+	const Eigen::Index limit=std::numeric_limits<Eigen::Index>::max()/Eigen::Index(sizeof(_Scalar));
+	if(n<0)
+	{
+		return -1;
+	}
+	//one of n and n+1 is even, it is halved before the product
+	const Eigen::Index a= n%2==0 ? n/2 : n;
+	const Eigen::Index b= n%2==0 ? n+1 : (n+1)/2;
+	if(a>0 && b>limit/a)
+	{
+		return -1;
+	}
+	return a*b;
+}
+
+/*
+Order n of a packed vector of the given no. of elements(elements=n(n+1)/2), or -1 when there is no such
+order. n*n<2*elements<(n+1)*(n+1), so n is the square root of 2*elements rounded down, which is only
+estimated with doubles and then corrected in integers(a double cannot hold every no. of elements exactly).
+*/
+inline Eigen::Index packedOrder(Eigen::Index elements)
+{
+	if(elements<0)
+	{
+		return -1;
+	}
+	Eigen::Index n=Eigen::Index(std::sqrt(2.0*double(elements)));
+	while(n>0 && (packedElements<char>(n)<0 || packedElements<char>(n)>elements))
+	{
+		n--;
+	}
+	while(packedElements<char>(n+1)>=0 && packedElements<char>(n+1)<=elements)
+	{
+		n++;
+	}
+	return packedElements<char>(n)==elements ? n : -1;
+}
+
+//No. of elements of a new matrix of order n, the program is terminated when it cannot be stored
+template<typename _Scalar>
+Eigen::Index checkedElements(Eigen::Index n)
+{
+	const Eigen::Index elements=packedElements<_Scalar>(n);
+	if(elements<0)
+	{
+		std::cout<<"Order "<<n<<" can not be stored in the packed vector!\nTerminating the program..."<<std::endl;
+		std::exit(0);
+	}
+	return elements;
+}
+
+/*
+Converts n elements stored as _Source to _Scalar. The kernels read the packed vector through it, so they
+also work on packed vectors of another element type than the one they compute in(like the 16 bit
+floats of SymMatHalf.h, which specializes it with the vector conversions).
+*/
+template<typename _Source,typename _Scalar>
+struct Convert
+{
+	static void run(const _Source* src,Eigen::Index n,_Scalar* dst)
+	{
+		for(Eigen::Index k=0;k<n;k++)
+		{
+			dst[k]=_Scalar(src[k]);
+		}
+	}
+};
+
+template<typename _Scalar>
+struct Convert<_Scalar,_Scalar>
+{
+	static void run(const _Scalar* src,Eigen::Index n,_Scalar* dst) { std::copy(src,src+n,dst); }
+};
+
+/*
+The kernels take the packed vector as _Packed: a pointer to its elements, or a cursor(which moves with +)
+of a packed vector stored in another form, like the quantized blocks of SymMatQuant.h, which overloads
+readPacked for it.
+*/
+template<typename _Scalar,typename _Source>
+inline void readPacked(const _Source* src,Eigen::Index n,_Scalar* dst)
+{
+	Convert<_Source,_Scalar>::run(src,n,dst);
+}
+
+//Whether the kernels can read the packed vector directly as _Scalar, without a buffer
+template<typename _Packed,typename _Scalar>
+struct DirectPacked : std::is_convertible<_Packed,const _Scalar*> {};
+
+//n elements as _Scalar: the packed vector itself when it holds _Scalar, otherwise their copy in buffer
+template<typename _Scalar>
+inline const _Scalar* rowData(const _Scalar* src,Eigen::Index,_Scalar*)
+{
+	return src;
+}
+
+template<typename _Scalar,typename _Packed>
+inline typename std::enable_if<!DirectPacked<_Packed,_Scalar>::value,const _Scalar*>::type
+rowData(_Packed src,Eigen::Index n,_Scalar* buffer)
+{
+	readPacked(src,n,buffer);
+	return buffer;
+}
+
+/*
+Temporaries of the kernels(rows converted from another element type, the partial results of the threads,
+the panels of mult) are kept by each thread between the calls and only grow, so calling a kernel again
+with the same order does not allocate. They are at most a block of rows(O(n*block)); the temporaries of
+O(n^2) elements are allocated by each call instead. _Slot tells apart the buffers used at the same time.
+*/
+enum ScratchSlot { ScratchRow, ScratchPartial, ScratchPanel, ScratchPanelRow, ScratchDenseRow, ScratchProduct, ScratchTile, ScratchPairs };
+
+template<typename _Scalar,int _Slot>
+inline _Scalar* scratch(size_t n)
+{
+	static thread_local std::vector<_Scalar> buffer;
+	if(buffer.size()<n)
+	{
+		buffer.resize(n);
+	}
+	return buffer.data();
+}
+
+//Adds alpha*(rows first..last-1 of S)*x and their transposed parts into y
+template<typename _Scalar,typename _Packed>
+void spmvRows(Eigen::Index n,Eigen::Index first,Eigen::Index last,_Scalar alpha,_Packed ap,const _Scalar* x,_Scalar* y)
+{
+	//Only needed when the elements are stored as another type
+	_Scalar* buffer=DirectPacked<_Packed,_Scalar>::value ? 0 : scratch<_Scalar,ScratchRow>(size_t(n-first));
+
+	Eigen::Index diag=diagIndex(n,first);
+	for(Eigen::Index i=first;i<last;i++)
+	{
+		const Eigen::Index len=n-i-1;
+		const _Scalar* row=rowData(ap+diag,len+1,buffer);
+		_Scalar temp=dotAxpy(row+1,x+i+1,y+i+1,len,_Scalar(alpha*x[i]));
+		y[i]+=alpha*(row[0]*x[i]+temp);
+		diag+=n-i;
+	}
+}
+
+//Splits the rows in parts holding about the same number of packed elements
+inline void splitRows(Eigen::Index n,int parts,std::vector<Eigen::Index>& bounds)
+{
+	bounds.assign(parts+1,n);
+	bounds[0]=0;
+	const double total=double(n)*double(n+1)/2;
+	int part=1;
+	double done=0;
+	for(Eigen::Index i=0;i<n && part<parts;i++)
+	{
+		done+=double(n-i);
+		while(part<parts && done>=total*part/parts)
+		{
+			bounds[part++]=i+1;
+		}
+	}
+}
+
+//y = alpha*S*x + beta*y, where S is a packed matrix of order n
+template<typename _Scalar,typename _Packed>
+void spmv(Eigen::Index n,_Scalar alpha,_Packed ap,const _Scalar* x,_Scalar beta,_Scalar* y)
+{
+	//beta==0 overwrites y, so that whatever was in y(even NaN) is not propagated
+	for(Eigen::Index i=0;i<n;i++)
+	{
+		y[i]= beta==_Scalar(0) ? _Scalar(0) : beta*y[i];
+	}
+
+#ifdef _OPENMP
+	int threads=omp_get_max_threads();
+	if(n>=SYMMAT_PARALLEL_THRESHOLD && threads>1 && !omp_in_parallel())
+	{
+		//The bounds are kept between the calls, but only on this thread: the others use them through the pointer
+		static thread_local std::vector<Eigen::Index> bounds;
+		splitRows(n,threads,bounds);
+		const Eigen::Index* bound=bounds.data();
+		_Scalar* partial=scratch<_Scalar,ScratchPartial>(size_t(threads)*n);
+		std::fill(partial,partial+size_t(threads)*n,_Scalar(0));
+
+		#pragma omp parallel num_threads(threads)
+		{
+			//The team can be smaller than asked for(OMP_THREAD_LIMIT, nesting), so every part is taken by some thread
+			for(int t=omp_get_thread_num();t<threads;t+=omp_get_num_threads())
+			{
+				spmvRows(n,bound[t],bound[t+1],alpha,ap,x,partial+size_t(t)*n);
+			}
+
+			//Adds the copies of all the threads together
+			#pragma omp barrier
+			#pragma omp for schedule(static)
+			for(Eigen::Index i=0;i<n;i++)
+			{
+				_Scalar total=0;
+				for(int p=0;p<threads;p++)
+				{
+					total+=partial[size_t(p)*n+i];
+				}
+				y[i]+=total;
+			}
+		}
+		return;
+	}
+#endif
+	spmvRows(n,Eigen::Index(0),n,alpha,ap,x,y);
+}
+
+} //namespace SymMatInternal
+
+
+/*************************************************************************************************
+						CONVERSIONS FROM AND TO EIGEN MATRICES
+						--------------------------------------
+A packed row(S(i,i..n-1)) is a piece of a row of a dense matrix: contiguous when the dense matrix is row
+major, but with a stride of n when it is column major. So the column major copies go tile by tile
+(SYMMAT_PACK_BLOCK x SYMMAT_PACK_BLOCK), the reads and the writes of a tile staying in the cache, and the
+contiguous pieces are copied whole. A dense symmetric matrix is the same in both orders, so the dense
+result is filled the same way whatever the order of the Eigen matrix.
+**************************************************************************************************/
+
+//Order of the tiles of the blocked copies
+#ifndef SYMMAT_PACK_BLOCK
+#define SYMMAT_PACK_BLOCK 16
+#endif
+
+namespace SymMatInternal
+{
+
+//Copies the upper triangle of the square matrix M into the packed vector ap(M is not evaluated again
+//when it is a matrix, a Map or a block with contiguous columns/rows)
+template<typename _Scalar,typename _Derived>
+void packUpper(const Eigen::MatrixBase<_Derived>& M,_Scalar* ap)
+{
+	typedef Eigen::Matrix<_Scalar,Eigen::Dynamic,Eigen::Dynamic,_Derived::IsRowMajor ? Eigen::RowMajor : Eigen::ColMajor> Plain;
+	typedef Eigen::Map< Eigen::Matrix<_Scalar,1,Eigen::Dynamic> > PackedRow;
+	const Eigen::Ref<const Plain> R(M.derived());
+	const Eigen::Index n=R.rows(),bs=SYMMAT_PACK_BLOCK;
+
+	if(_Derived::IsRowMajor)
+	{
+		for(Eigen::Index i=0;i<n;i++)
+		{
+			PackedRow(ap+diagIndex(n,i),n-i)=R.row(i).tail(n-i);
+		}
+		return;
+	}
+
+	//rows[i-I][j] is S(i,j) for the rows i of the tile
+	_Scalar* rows[SYMMAT_PACK_BLOCK];
+	for(Eigen::Index I=0;I<n;I+=bs)
+	{
+		const Eigen::Index lastI=std::min(n,I+bs);
+		for(Eigen::Index i=I;i<lastI;i++)
+		{
+			rows[i-I]=ap+diagIndex(n,i)-i;
+		}
+		for(Eigen::Index J=I;J<n;J+=bs)
+		{
+			const Eigen::Index lastJ=std::min(n,J+bs);
+			for(Eigen::Index j=J;j<lastJ;j++)
+			{
+				const _Scalar* column=R.col(j).data();
+				for(Eigen::Index i=I;i<std::min(lastI,j+1);i++)
+				{
+					rows[i-I][j]=column[i];
+				}
+			}
+		}
+	}
+}
+
+//Fills the dense n x n matrix D(either order) from the packed vector
+template<typename _Scalar,typename _Packed>
+void unpackDense(Eigen::Index n,_Packed ap,_Scalar* D)
+{
+	const Eigen::Index bs=SYMMAT_PACK_BLOCK;
+
+	//Packed row j is column j of D from the diagonal down
+	_Scalar* buffer=DirectPacked<_Packed,_Scalar>::value ? 0 : scratch<_Scalar,ScratchDenseRow>(size_t(n));
+	for(Eigen::Index j=0;j<n;j++)
+	{
+		const _Scalar* row=rowData(ap+diagIndex(n,j),n-j,buffer);
+		std::copy(row,row+(n-j),D+j*n+j);
+	}
+
+	//The part above the diagonal is the transposed lower part, copied tile by tile
+	for(Eigen::Index J=0;J<n;J+=bs)
+	{
+		const Eigen::Index lastJ=std::min(n,J+bs);
+		for(Eigen::Index I=0;I<=J;I+=bs)
+		{
+			for(Eigen::Index j=J;j<lastJ;j++)
+			{
+				_Scalar* column=D+j*n;
+				for(Eigen::Index i=I;i<std::min(j,I+bs);i++)
+				{
+					column[i]=D[i*n+j];
+				}
+			}
+		}
+	}
+}
+
+//D = beta*D + alpha*S for the dense n x n matrix D(either order), in place
+template<typename _Scalar>
+void addPacked(Eigen::Index n,_Scalar alpha,const _Scalar* ap,_Scalar beta,_Scalar* D)
+{
+	const Eigen::Index bs=SYMMAT_PACK_BLOCK;
+
+	//Column j from the diagonal down is packed row j
+	for(Eigen::Index j=0;j<n;j++)
+	{
+		const _Scalar* row=ap+diagIndex(n,j)-j;
+		_Scalar* column=D+j*n;
+		for(Eigen::Index i=j;i<n;i++)
+		{
+			column[i]=beta*column[i]+alpha*row[i];
+		}
+	}
+
+	//Above the diagonal S(i,j) is in packed row i, read tile by tile
+	const _Scalar* rows[SYMMAT_PACK_BLOCK];
+	for(Eigen::Index I=0;I<n;I+=bs)
+	{
+		const Eigen::Index lastI=std::min(n,I+bs);
+		for(Eigen::Index i=I;i<lastI;i++)
+		{
+			rows[i-I]=ap+diagIndex(n,i)-i;
+		}
+		for(Eigen::Index J=I;J<n;J+=bs)
+		{
+			const Eigen::Index lastJ=std::min(n,J+bs);
+			for(Eigen::Index j=J;j<lastJ;j++)
+			{
+				_Scalar* column=D+j*n;
+				for(Eigen::Index i=I;i<std::min(lastI,j);i++)
+				{
+					column[i]=beta*column[i]+alpha*rows[i-I][j];
+				}
+			}
+		}
+	}
+}
+
+} //namespace SymMatInternal
+
+
+/*************************************************************************************************
+						EXPRESSION TEMPLATES
+						--------------------
+Arithmetic between symmetric matrices (add, sub, +, -, scalar *) does not compute anything by itself,
+it only builds a small expression object which remembers the operands.
+The work is done when the expression is assigned to a SymMat, in one single loop over the packed
+vector, so an expression like  a*S1 + S2 - S3  reads every operand once and writes the result once
+without creating any temporary matrices in between.
+
+Since the operation is done element by element on the packed vectors, the position of the element
+in the vector is the same for all the operands and index() is never called.
+**************************************************************************************************/
+//_Order is the order of the matrix when it is known at compile time(see FIXED ORDER SYMMETRIC MATRIX)
+template <typename _Scalar,int _Order=Eigen::Dynamic>
+class SymMat;
+
+//Traits giving the scalar type of an expression and how it is stored inside another expression
+template<typename _Xpr>
+struct SymMatTraits
+{
+	typedef typename _Xpr::Scalar Scalar;
+	typedef const _Xpr Nested;				//expressions are small, so they are copied
+};
+
+template<typename _Scalar,int _Order>
+struct SymMatTraits< SymMat<_Scalar,_Order> >
+{
+	typedef _Scalar Scalar;
+	typedef const SymMat<_Scalar,_Order>& Nested;	//matrices are only referred to, never copied
+};
+
+//Base class of every symmetric expression (and of SymMat itself)
+template<typename _Derived>
+struct SymMatExpr
+{
+	const _Derived& derived() const { return static_cast<const _Derived&>(*this); }
+};
+
+//Operations applied element by element
+struct SymMatSumOp
+{
+	template<typename _Scalar>
+	_Scalar operator()(const _Scalar& a,const _Scalar& b) const { return a+b; }
+};
+
+struct SymMatDifferenceOp
+{
+	template<typename _Scalar>
+	_Scalar operator()(const _Scalar& a,const _Scalar& b) const { return a-b; }
+};
+
+//Expression of an element-wise operation between two symmetric expressions
+template<typename _Lhs,typename _Rhs,typename _Op>
+class SymMatBinaryExpr : public SymMatExpr< SymMatBinaryExpr<_Lhs,_Rhs,_Op> >
+{
+public:
+	typedef typename SymMatTraits<_Lhs>::Scalar Scalar;
+
+	//Order of the resulting matrix
+	int order;
+
+	SymMatBinaryExpr(const _Lhs& l,const _Rhs& r) :order(l.order),lhs(l),rhs(r)
+	{
+		assert(l.size()==r.size());       //Condition for matrices to be conformable
+	}
+
+	//No. of elements stored in the classical packed format
+	Eigen::Index size() const { return lhs.size(); }
+
+	//Element at position k of the packed vector
+	Scalar coeff(Eigen::Index k) const { return _Op()(lhs.coeff(k),rhs.coeff(k)); }
+
+private:
+	typename SymMatTraits<_Lhs>::Nested lhs;
+	typename SymMatTraits<_Rhs>::Nested rhs;
+};
+
+//Expression of a symmetric expression multiplied by a scalar
+template<typename _Xpr>
+class SymMatScaledExpr : public SymMatExpr< SymMatScaledExpr<_Xpr> >
+{
+public:
+	typedef typename SymMatTraits<_Xpr>::Scalar Scalar;
+
+	//Order of the resulting matrix
+	int order;
+
+	SymMatScaledExpr(const Scalar& a,const _Xpr& x) :order(x.order),alpha(a),xpr(x) {}
+
+	//No. of elements stored in the classical packed format
+	Eigen::Index size() const { return xpr.size(); }
+
+	//Element at position k of the packed vector
+	Scalar coeff(Eigen::Index k) const { return alpha*xpr.coeff(k); }
+
+private:
+	Scalar alpha;
+	typename SymMatTraits<_Xpr>::Nested xpr;
+};
+
+//Operators building the expressions
+template<typename _Lhs,typename _Rhs>
+SymMatBinaryExpr<_Lhs,_Rhs,SymMatSumOp> operator+(const SymMatExpr<_Lhs>& l,const SymMatExpr<_Rhs>& r)
+{
+	return SymMatBinaryExpr<_Lhs,_Rhs,SymMatSumOp>(l.derived(),r.derived());
+}
+
+template<typename _Lhs,typename _Rhs>
+SymMatBinaryExpr<_Lhs,_Rhs,SymMatDifferenceOp> operator-(const SymMatExpr<_Lhs>& l,const SymMatExpr<_Rhs>& r)
+{
+	return SymMatBinaryExpr<_Lhs,_Rhs,SymMatDifferenceOp>(l.derived(),r.derived());
+}
+
+template<typename _Xpr>
+SymMatScaledExpr<_Xpr> operator*(const typename SymMatTraits<_Xpr>::Scalar& a,const SymMatExpr<_Xpr>& x)
+{
+	return SymMatScaledExpr<_Xpr>(a,x.derived());
+}
+
+template<typename _Xpr>
+SymMatScaledExpr<_Xpr> operator*(const SymMatExpr<_Xpr>& x,const typename SymMatTraits<_Xpr>::Scalar& a)
+{
+	return SymMatScaledExpr<_Xpr>(a,x.derived());
+}
+
+template<typename _Xpr>
+SymMatScaledExpr<_Xpr> operator-(const SymMatExpr<_Xpr>& x)
+{
+	return SymMatScaledExpr<_Xpr>(typename SymMatTraits<_Xpr>::Scalar(-1),x.derived());
+}
+
+/*
+Compound assignment(S += expr, S -= expr, S *= a) is done in place on the packed vector. The operands are
+read at the same position as the element written, so S may be part of the expression(S += 2*S).
+An expiring SymMat(a temporary, or std::move(S)) in +, - or * gives its packed vector to the result, which
+is computed in place: R = std::move(S) + T or R = f() - T do not allocate.
+*/
+struct SymMatReverseDifferenceOp
+{
+	template<typename _Scalar>
+	_Scalar operator()(const _Scalar& a,const _Scalar& b) const { return b-a; }
+};
+
+namespace SymMatInternal
+{
+
+//dst[k] = op(dst[k],expr(k)) over the whole packed vector
+template<typename _Scalar,typename _Derived,typename _Op>
+void compoundAssign(_Scalar* dst,const _Derived& expr,_Op op)
+{
+	const Eigen::Index elements=expr.size();
+	for(Eigen::Index k=0;k<elements;k++)
+	{
+		dst[k]=op(dst[k],expr.coeff(k));
+	}
+}
+
+} //namespace SymMatInternal
+
+template<typename _Scalar,typename _Rhs>
+SymMat<_Scalar> operator+(SymMat<_Scalar>&& l,const SymMatExpr<_Rhs>& r)
+{
+	l+=r;
+	return std::move(l);
+}
+
+template<typename _Lhs,typename _Scalar>
+SymMat<_Scalar> operator+(const SymMatExpr<_Lhs>& l,SymMat<_Scalar>&& r)
+{
+	r+=l;
+	return std::move(r);
+}
+
+template<typename _Scalar>
+SymMat<_Scalar> operator+(SymMat<_Scalar>&& l,SymMat<_Scalar>&& r)
+{
+	l+=r;
+	return std::move(l);
+}
+
+template<typename _Scalar,typename _Rhs>
+SymMat<_Scalar> operator-(SymMat<_Scalar>&& l,const SymMatExpr<_Rhs>& r)
+{
+	l-=r;
+	return std::move(l);
+}
+
+template<typename _Lhs,typename _Scalar>
+SymMat<_Scalar> operator-(const SymMatExpr<_Lhs>& l,SymMat<_Scalar>&& r)
+{
+	assert(l.derived().size()==r.size());       //Condition for matrices to be conformable
+	SymMatInternal::compoundAssign(r.mat.data(),l.derived(),SymMatReverseDifferenceOp());
+	return std::move(r);
+}
+
+template<typename _Scalar>
+SymMat<_Scalar> operator-(SymMat<_Scalar>&& l,SymMat<_Scalar>&& r)
+{
+	l-=r;
+	return std::move(l);
+}
+
+template<typename _Scalar>
+SymMat<_Scalar> operator*(const typename SymMat<_Scalar>::Scalar& a,SymMat<_Scalar>&& x)
+{
+	x*=a;
+	return std::move(x);
+}
+
+template<typename _Scalar>
+SymMat<_Scalar> operator*(SymMat<_Scalar>&& x,const typename SymMat<_Scalar>::Scalar& a)
+{
+	x*=a;
+	return std::move(x);
+}
+
+template<typename _Scalar>
+SymMat<_Scalar> operator-(SymMat<_Scalar>&& x)
+{
+	x*=_Scalar(-1);
+	return std::move(x);
+}
+
+
+/*************************************************************************************************
+						TRACING
+						-------
+When SYMMAT_TRACE is defined, every operation on SymMat(constructors, reductions, add/sub, mult,
+spmv, syrk, the factorizations) records, for its name, scalar type and order:-
+
+	calls		no. of calls
+	elements	elements of the packed matrices it reads or writes
+	bytes		bytes it moves at least(the packed operands, the Eigen operands and the result)
+	seconds		wall time
+	allocations	no. of blocks(and allocbytes their bytes) taken by SymMatAllocator while it runs
+
+The operations call each other(sum() calls trace() and packedSum()), so the time, the elements and the
+allocations of an operation include those of the operations it calls. Element access through
+operator() is only counted(calls and elements, no time), the counts of each thread are added to the
+others every 4096 accesses, when the order changes, when the thread ends and on snapshot() from it.
+
+	std::vector<SymMatTraceRecord> r=SymMatTrace::snapshot();		//totals so far
+	SymMatTrace::dump("trace.json");							//for chrome://tracing or Perfetto
+	SymMatTrace::reset();
+
+The dump holds one event per call(the first SYMMAT_TRACE_EVENTS calls), with the totals in "symmat".
+The expressions(a*S1+S2) are recorded once, as "assign", when they are evaluated. The fixed order
+matrices are not traced, their operations take only a few nanoseconds.
+Without SYMMAT_TRACE nothing of this is compiled, and the code calling SymMatTrace must be left out
+the same way(#ifdef SYMMAT_TRACE).
+**************************************************************************************************/
+#if defined(SYMMAT_TRACE)
+
+#include <map>
+#include <mutex>
+#include <string>
+#include <tuple>
+#include <chrono>
+#include <atomic>
+#include <cstdio>
+#include <typeinfo>
+#include <stdint.h>
+
+//No. of calls kept as events for the dump
+#ifndef SYMMAT_TRACE_EVENTS
+#define SYMMAT_TRACE_EVENTS 100000
+#endif
+
+//Totals of one operation for one scalar type and order
+struct SymMatTraceRecord
+{
+	std::string op;
+	std::string scalar;
+	Eigen::Index order;
+	uint64_t calls;
+	uint64_t elements;
+	uint64_t bytes;
+	uint64_t allocations;
+	uint64_t allocbytes;
+	double seconds;
+};
+
+namespace SymMatInternal
+{
+
+//Name of the scalar type in the records
+template<typename _Scalar> inline const char* traceScalar() { return typeid(_Scalar).name(); }
+template<> inline const char* traceScalar<float>() { return "float"; }
+template<> inline const char* traceScalar<double>() { return "double"; }
+template<> inline const char* traceScalar<int>() { return "int"; }
+template<> inline const char* traceScalar<long>() { return "long"; }
+
+//Small no. of the thread for the events
+inline int traceThread()
+{
+	static std::atomic<int> next(0);
+	static thread_local int id=next++;
+	return id;
+}
+
+struct TraceEvent
+{
+	const char* op;
+	const char* scalar;
+	Eigen::Index order;
+	double start;			//microseconds since the first record
+	double duration;
+	int thread;
+	uint64_t elements;
+	uint64_t bytes;
+	uint64_t allocations;
+};
+
+//All the records of the program, shared by the threads
+class TraceLog
+{
+public:
+	typedef std::tuple<std::string,std::string,Eigen::Index> Key;
+
+	std::mutex lock;
+	std::map<Key,SymMatTraceRecord> totals;
+	std::vector<TraceEvent> events;
+	std::chrono::steady_clock::time_point origin;
+
+	TraceLog() :origin(std::chrono::steady_clock::now()) {}
+
+	static TraceLog& instance()
+	{
+		static TraceLog log;
+		return log;
+	}
+
+	double now() const { return std::chrono::duration<double,std::micro>(std::chrono::steady_clock::now()-origin).count(); }
+
+	void add(const char* op,const char* scalar,Eigen::Index order,uint64_t calls,uint64_t elements,uint64_t bytes,
+			 uint64_t allocations,uint64_t allocbytes,double seconds)
+	{
+		std::lock_guard<std::mutex> guard(lock);
+		SymMatTraceRecord& r=totals[Key(op,scalar,order)];
+		if(r.op.empty())
+		{
+			r.op=op;
+			r.scalar=scalar;
+			r.order=order;
+		}
+		r.calls+=calls;
+		r.elements+=elements;
+		r.bytes+=bytes;
+		r.allocations+=allocations;
+		r.allocbytes+=allocbytes;
+		r.seconds+=seconds;
+	}
+
+	void event(const TraceEvent& e)
+	{
+		std::lock_guard<std::mutex> guard(lock);
+		if(events.size()<SYMMAT_TRACE_EVENTS)
+		{
+			events.push_back(e);
+		}
+	}
+};
+
+//Records one call of an operation from its construction to its destruction
+class TraceScope
+{
+public:
+	TraceScope(const char* o,const char* s,Eigen::Index n,uint64_t e,uint64_t b)
+		:op(o),scalar(s),order(n),elements(e),bytes(b),allocations(0),allocbytes(0),parent(current())
+	{
+		current()=this;
+		start=TraceLog::instance().now();
+	}
+
+	~TraceScope()
+	{
+		TraceLog& log=TraceLog::instance();
+		const double duration=log.now()-start;
+		current()=parent;
+		if(parent)  //the allocations of the operations called are part of the caller's
+		{
+			parent->allocations+=allocations;
+			parent->allocbytes+=allocbytes;
+		}
+		log.add(op,scalar,order,1,elements,bytes,allocations,allocbytes,duration*1e-6);
+		TraceEvent e={op,scalar,order,start,duration,traceThread(),elements,bytes,allocations};
+		log.event(e);
+	}
+
+	//Innermost operation running on this thread
+	static TraceScope*& current()
+	{
+		static thread_local TraceScope* scope=0;
+		return scope;
+	}
+
+	const char* op;
+	const char* scalar;
+	Eigen::Index order;
+	uint64_t elements;
+	uint64_t bytes;
+	uint64_t allocations;
+	uint64_t allocbytes;
+
+private:
+	TraceScope* parent;
+	double start;
+
+	TraceScope(const TraceScope&);
+	TraceScope& operator=(const TraceScope&);
+};
+
+//Counts of operator() of this thread not yet added to the log
+class TracePending
+{
+public:
+	TracePending() :scalar(0),order(0),count(0),bytes(0) {}
+	~TracePending() { flush(); }
+
+	void access(const char* s,Eigen::Index n,size_t size)
+	{
+		if(s!=scalar || n!=order || count>=4096)
+		{
+			flush();
+			scalar=s;
+			order=n;
+		}
+		count++;
+		bytes+=size;
+	}
+
+	void flush()
+	{
+		if(count)
+		{
+			TraceLog::instance().add("operator()",scalar,order,count,count,bytes,0,0,0);
+			count=bytes=0;
+		}
+	}
+
+	static TracePending& instance()
+	{
+		static thread_local TracePending pending;
+		return pending;
+	}
+
+private:
+	const char* scalar;
+	Eigen::Index order;
+	uint64_t count;
+	uint64_t bytes;
+};
+
+//A block taken by SymMatAllocator, given to the operation running(or recorded on its own)
+template<typename _Scalar>
+inline void traceAllocation(size_t n)
+{
+	TraceScope* scope=TraceScope::current();
+	if(scope)
+	{
+		scope->allocations++;
+		scope->allocbytes+=n*sizeof(_Scalar);
+	}
+	else
+	{
+		//Outside the operations the blocks are the packed vectors(copies), so the order is found from the size
+		TraceLog::instance().add("allocate",traceScalar<_Scalar>(),std::max(packedOrder(Eigen::Index(n)),Eigen::Index(0)),
+								 1,0,0,1,n*sizeof(_Scalar),0);
+	}
+}
+
+} //namespace SymMatInternal
+
+class SymMatTrace
+{
+public:
+	//Totals of every operation, scalar type and order recorded so far
+	static std::vector<SymMatTraceRecord> snapshot()
+	{
+		SymMatInternal::TracePending::instance().flush();
+		SymMatInternal::TraceLog& log=SymMatInternal::TraceLog::instance();
+		std::lock_guard<std::mutex> guard(log.lock);
+		std::vector<SymMatTraceRecord> records;
+		for(std::map<SymMatInternal::TraceLog::Key,SymMatTraceRecord>::const_iterator it=log.totals.begin();it!=log.totals.end();++it)
+		{
+			records.push_back(it->second);
+		}
+		return records;
+	}
+
+	//Forgets all the records and events
+	static void reset()
+	{
+		SymMatInternal::TracePending::instance().flush();
+		SymMatInternal::TraceLog& log=SymMatInternal::TraceLog::instance();
+		std::lock_guard<std::mutex> guard(log.lock);
+		log.totals.clear();
+		log.events.clear();
+	}
+
+	//Writes the events in the Chrome trace format(JSON) and the totals, returns false when the file cannot be written
+	static bool dump(const std::string& path)
+	{
+		const std::vector<SymMatTraceRecord> records=snapshot();
+		SymMatInternal::TraceLog& log=SymMatInternal::TraceLog::instance();
+		std::FILE* file=std::fopen(path.c_str(),"w");
+		if(!file)
+		{
+			return false;
+		}
+		std::fprintf(file,"{\"displayTimeUnit\":\"ns\",\"traceEvents\":[");
+		{
+			std::lock_guard<std::mutex> guard(log.lock);
+			for(size_t k=0;k<log.events.size();k++)
+			{
+				const SymMatInternal::TraceEvent& e=log.events[k];
+				std::fprintf(file,"%s\n{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":1,\"tid\":%d,"
+							 "\"args\":{\"order\":%lld,\"elements\":%llu,\"bytes\":%llu,\"allocations\":%llu}}",
+							 k ? "," : "",e.op,e.scalar,e.start,e.duration,e.thread,(long long)e.order,
+							 (unsigned long long)e.elements,(unsigned long long)e.bytes,(unsigned long long)e.allocations);
+			}
+		}
+		std::fprintf(file,"\n],\"symmat\":[");
+		for(size_t k=0;k<records.size();k++)
+		{
+			const SymMatTraceRecord& r=records[k];
+			std::fprintf(file,"%s\n{\"op\":\"%s\",\"scalar\":\"%s\",\"order\":%lld,\"calls\":%llu,\"elements\":%llu,\"bytes\":%llu,"
+						 "\"allocations\":%llu,\"allocbytes\":%llu,\"seconds\":%.9f}",
+						 k ? "," : "",r.op.c_str(),r.scalar.c_str(),(long long)r.order,(unsigned long long)r.calls,
+						 (unsigned long long)r.elements,(unsigned long long)r.bytes,(unsigned long long)r.allocations,
+						 (unsigned long long)r.allocbytes,r.seconds);
+		}
+		std::fprintf(file,"\n]}\n");
+		return std::fclose(file)==0;
+	}
+};
+
+//Records the operation running until the end of the enclosing block
+#define SYMMAT_TRACE_OP(op,_Scalar,order,elements,bytes) \
+	SymMatInternal::TraceScope symmat_trace_scope(op,SymMatInternal::traceScalar<_Scalar>(),Eigen::Index(order),uint64_t(elements),uint64_t(bytes))
+#define SYMMAT_TRACE_ACCESS(_Scalar,order) \
+	SymMatInternal::TracePending::instance().access(SymMatInternal::traceScalar<_Scalar>(),Eigen::Index(order),sizeof(_Scalar))
+#define SYMMAT_TRACE_ALLOCATION(_Scalar,n) SymMatInternal::traceAllocation<_Scalar>(n)
+
+#else
+
+#define SYMMAT_TRACE_OP(op,_Scalar,order,elements,bytes)
+#define SYMMAT_TRACE_ACCESS(_Scalar,order)
+#define SYMMAT_TRACE_ALLOCATION(_Scalar,n)
+
+#endif //SYMMAT_TRACE
+
+
+/*************************************************************************************************
+						MEMORY OF THE MATRICES
+						----------------------
+The packed vector of every SymMat is a std::vector with SymMatAllocator, which takes its memory from a
+SymMatResource:-
+
+	1)SymMatHeap(the default) - malloc/free, with the blocks aligned to SYMMAT_ALIGN bytes so that the
+	  SIMD loads of the kernels never cross a cache line at the start of a matrix.
+	2)SymMatArena - monotonic: the blocks are cut one after another from large chunks, freeing a block
+	  does nothing and all the memory is given back at once(release() or the destructor).
+	3)SymMatPool - keeps the freed blocks in one list per block size. All the matrices of an order n have
+	  the same size(n(n+1)/2 elements), so a matrix created after another one of the same order was
+	  destroyed reuses its block without going to malloc.
+	4)SymMatHugePages - maps every block of at least SYMMAT_HUGEPAGE bytes on its own, aligned to a huge
+	  page, and asks the kernel to back it with transparent huge pages. A sweep over the packed vector of a
+	  large matrix(order 100000 is 20GB of floats) then needs one TLB entry per 2MB instead of one per 4KB.
+	  Smaller blocks, and all the blocks on systems other than Linux, come from the heap.
+
+The resource is chosen per thread with SymMatScope, so every SymMat created by the thread while the scope
+is alive(including results of the expressions and temporaries) uses it, without changing any code:-
+
+	SymMatPool pool;
+	{
+		SymMatScope scope(&pool);
+		SymMat<float> S2(3);		//from the pool
+	}
+
+A resource is used by one thread only(it is not locked, SymMatHeap and SymMatHugePages keep no state and
+can be shared), and it must live longer than the matrices which use it. The allocator is a single type
+whatever the resource, so the functions taking SymMat<_Scalar> work for all of them.
+**************************************************************************************************/
+
+//Alignment of the blocks(bytes, power of two)
+#ifndef SYMMAT_ALIGN
+#define SYMMAT_ALIGN 64
+#endif
+
+//Interface of the memory resources
+class SymMatResource
+{
+public:
+	virtual ~SymMatResource() {}
+	virtual void* allocate(size_t bytes)=0;
+	virtual void deallocate(void* p,size_t bytes)=0;
+
+	//Resource used by the matrices created now on this thread
+	static SymMatResource*& current();
+};
+
+namespace SymMatInternal
+{
+
+//malloc aligned to SYMMAT_ALIGN, the pointer returned by malloc is kept just before the block
+inline void* alignedMalloc(size_t bytes)
+{
+	void* raw=std::malloc(bytes+SYMMAT_ALIGN+sizeof(void*));
+	if(!raw)
+	{
+		throw std::bad_alloc();
+	}
+	void* p=(void*)((size_t((char*)raw+sizeof(void*))+SYMMAT_ALIGN-1)&~size_t(SYMMAT_ALIGN-1));
+	((void**)p)[-1]=raw;
+	return p;
+}
+
+inline void alignedFree(void* p)
+{
+	if(p)
+	{
+		std::free(((void**)p)[-1]);
+	}
+}
+
+} //namespace SymMatInternal
+
+class SymMatHeap : public SymMatResource
+{
+public:
+	void* allocate(size_t bytes) { return SymMatInternal::alignedMalloc(bytes); }
+	void deallocate(void* p,size_t) { SymMatInternal::alignedFree(p); }
+
+	//The resource used when no other is chosen
+	static SymMatHeap* instance()
+	{
+		static SymMatHeap heap;
+		return &heap;
+	}
+};
+
+inline SymMatResource*& SymMatResource::current()
+{
+	static thread_local SymMatResource* resource=SymMatHeap::instance();
+	return resource;
+}
+
+class SymMatArena : public SymMatResource
+{
+public:
+	//chunk is the size of the blocks taken from the heap(larger requests get their own chunk)
+	explicit SymMatArena(size_t chunk=size_t(1)<<20) :chunksize(chunk),pos(0),end(0) {}
+	~SymMatArena() { release(); }
+
+	void* allocate(size_t bytes)
+	{
+		bytes=(bytes+SYMMAT_ALIGN-1)&~size_t(SYMMAT_ALIGN-1);
+		if(pos+bytes>end)
+		{
+			const size_t size=std::max(bytes,chunksize);
+			chunks.push_back((char*)SymMatInternal::alignedMalloc(size));
+			pos=chunks.back();
+			end=pos+size;
+		}
+		void* p=pos;
+		pos+=bytes;
+		return p;
+	}
+
+	void deallocate(void*,size_t) {}
+
+	//Gives back all the memory(every matrix using the arena must be gone)
+	void release()
+	{
+		for(size_t k=0;k<chunks.size();k++)
+		{
+			SymMatInternal::alignedFree(chunks[k]);
+		}
+		chunks.clear();
+		pos=end=0;
+	}
+
+private:
+	size_t chunksize;
+	char* pos;
+	char* end;
+	std::vector<char*> chunks;
+
+	SymMatArena(const SymMatArena&);
+	SymMatArena& operator=(const SymMatArena&);
+};
+
+class SymMatPool : public SymMatResource
+{
+public:
+	SymMatPool() {}
+	~SymMatPool() { release(); }
+
+	void* allocate(size_t bytes)
+	{
+		Bucket& b=bucket(bytes);
+		if(b.head)
+		{
+			void* p=b.head;
+			b.head=*(void**)p;
+			return p;
+		}
+		return SymMatInternal::alignedMalloc(std::max(bytes,sizeof(void*)));
+	}
+
+	//The block is kept for the next matrix of the same size
+	void deallocate(void* p,size_t bytes)
+	{
+		Bucket& b=bucket(bytes);
+		*(void**)p=b.head;
+		b.head=p;
+	}
+
+	//Gives back the blocks which are not in use
+	void release()
+	{
+		for(size_t k=0;k<buckets.size();k++)
+		{
+			while(buckets[k].head)
+			{
+				void* p=buckets[k].head;
+				buckets[k].head=*(void**)p;
+				SymMatInternal::alignedFree(p);
+			}
+		}
+		buckets.clear();
+	}
+
+private:
+	struct Bucket
+	{
+		size_t bytes;
+		void* head;
+	};
+
+	//There are only a few different orders in use, so the sizes are searched linearly
+	std::vector<Bucket> buckets;
+
+	Bucket& bucket(size_t bytes)
+	{
+		for(size_t k=0;k<buckets.size();k++)
+		{
+			if(buckets[k].bytes==bytes)
+			{
+				return buckets[k];
+			}
+		}
+		Bucket b={bytes,0};
+		buckets.push_back(b);
+		return buckets.back();
+	}
+
+	SymMatPool(const SymMatPool&);
+	SymMatPool& operator=(const SymMatPool&);
+};
+
+//Size of a huge page, the blocks at least this large are mapped on huge pages
+#ifndef SYMMAT_HUGEPAGE
+#define SYMMAT_HUGEPAGE (size_t(2)<<20)
+#endif
+
+class SymMatHugePages : public SymMatResource
+{
+public:
+	void* allocate(size_t bytes)
+	{
+#if defined(SYMMAT_HAVE_HUGEPAGES)
+		if(bytes>=SYMMAT_HUGEPAGE)
+		{
+			//One huge page more is mapped, and the parts before and after the aligned block are unmapped
+			const size_t size=rounded(bytes);
+			char* raw=(char*)mmap(0,size+SYMMAT_HUGEPAGE,PROT_READ|PROT_WRITE,MAP_PRIVATE|MAP_ANONYMOUS,-1,0);
+			if(raw==MAP_FAILED)
+			{
+				throw std::bad_alloc();
+			}
+			char* p=(char*)((size_t(raw)+SYMMAT_HUGEPAGE-1)&~(SYMMAT_HUGEPAGE-1));
+			if(p>raw)
+			{
+				munmap(raw,p-raw);
+			}
+			munmap(p+size,(raw+size+SYMMAT_HUGEPAGE)-(p+size));
+			madvise(p,size,MADV_HUGEPAGE);
+			return p;
+		}
+#endif
+		return SymMatInternal::alignedMalloc(bytes);
+	}
+
+	void deallocate(void* p,size_t bytes)
+	{
+#if defined(SYMMAT_HAVE_HUGEPAGES)
+		if(bytes>=SYMMAT_HUGEPAGE)
+		{
+			munmap(p,rounded(bytes));
+			return;
+		}
+#endif
+		SymMatInternal::alignedFree(p);
+	}
+
+	static SymMatHugePages* instance()
+	{
+		static SymMatHugePages hugepages;
+		return &hugepages;
+	}
+
+private:
+	static size_t rounded(size_t bytes) { return (bytes+SYMMAT_HUGEPAGE-1)&~(SYMMAT_HUGEPAGE-1); }
+};
+
+//Chooses the resource of the matrices created by this thread until the scope ends
+class SymMatScope
+{
+public:
+	explicit SymMatScope(SymMatResource* r) :previous(SymMatResource::current()) { SymMatResource::current()=r; }
+	~SymMatScope() { SymMatResource::current()=previous; }
+
+private:
+	SymMatResource* previous;
+
+	SymMatScope(const SymMatScope&);
+	SymMatScope& operator=(const SymMatScope&);
+};
+
+//Standard allocator on a SymMatResource(the current one of the thread when it is created)
+template<typename _Scalar>
+class SymMatAllocator
+{
+public:
+	typedef _Scalar value_type;
+
+	//A moved or swapped vector keeps its memory, a copied one is allocated by the destination
+	typedef std::true_type propagate_on_container_move_assignment;
+	typedef std::true_type propagate_on_container_swap;
+
+	SymMatAllocator() :resource(SymMatResource::current()) {}
+	SymMatAllocator(SymMatResource* r) :resource(r) {}
+	template<typename _Other>
+	SymMatAllocator(const SymMatAllocator<_Other>& other) :resource(other.resource) {}
+
+	_Scalar* allocate(size_t n)
+	{
+		SYMMAT_TRACE_ALLOCATION(_Scalar,n);
+		return (_Scalar*)resource->allocate(n*sizeof(_Scalar));
+	}
+	void deallocate(_Scalar* p,size_t n) { resource->deallocate(p,n*sizeof(_Scalar)); }
+
+	//A copy of a matrix takes its memory from the resource of the thread making the copy
+	SymMatAllocator select_on_container_copy_construction() const { return SymMatAllocator(); }
+
+	SymMatResource* resource;
+};
+
+template<typename _Scalar,typename _Other>
+bool operator==(const SymMatAllocator<_Scalar>& a,const SymMatAllocator<_Other>& b) { return a.resource==b.resource; }
+
+template<typename _Scalar,typename _Other>
+bool operator!=(const SymMatAllocator<_Scalar>& a,const SymMatAllocator<_Other>& b) { return a.resource!=b.resource; }
+
+
+/*************************************************************************************************
+						CLASS DEFINITION
+						----------------
+Template parameters used are same as in eigen so that it will be easy to merge with the main branch
+This is the matrix whose order is given at run time(SymMat<_Scalar> is SymMat<_Scalar,Eigen::Dynamic>)
+**************************************************************************************************/
+template <typename _Scalar>
+class SymMat<_Scalar,Eigen::Dynamic> : public SymMatExpr< SymMat<_Scalar> >
+{
+public:
+
+	typedef _Scalar Scalar;
+
+	//Order of the matrix
+	int order;
+
+	//Vector which stores the elements of the matrix(see MEMORY OF THE MATRICES)
+	typedef std::vector< _Scalar,SymMatAllocator<_Scalar> > Storage;
+	Storage mat;
+	
+	//Initializer list
+	SymMat(std::initializer_list<_Scalar>);
+
+	//Default constructor
+	SymMat();
+
+	//Parametrized constructor(parameter is order of matrice)
+	SymMat(int);
+
+	//Matrix of the given order whose memory comes from the resource r(e.g. SymMatHugePages::instance())
+	SymMat(int,SymMatResource*);
+
+	//Evaluates a symmetric expression(e.g. a*S1+S2-S3) into a new matrix
+	template<typename _Derived>
+	SymMat(const SymMatExpr<_Derived>&);
+
+	//Copies the upper triangle of a square Eigen matrix(or expression)
+	template<typename _Derived>
+	explicit SymMat(const Eigen::MatrixBase<_Derived>&);
+
+	//Copies the triangle referred to by a selfadjointView<Upper> or selfadjointView<Lower>
+	template<typename _MatrixType,unsigned int _UpLo>
+	explicit SymMat(const Eigen::SelfAdjointView<_MatrixType,_UpLo>&);
+
+	//Takes over a packed vector of the given order without copying it
+	SymMat(int,Storage&&);
+
+	//Evaluates a symmetric expression into this matrix in a single pass
+	template<typename _Derived>
+	SymMat& operator=(const SymMatExpr<_Derived>&);
+
+	//In place arithmetic on the packed vector(no allocation)
+	template<typename _Derived>
+	SymMat& operator+=(const SymMatExpr<_Derived>&);
+	template<typename _Derived>
+	SymMat& operator-=(const SymMatExpr<_Derived>&);
+	SymMat& operator*=(const _Scalar&);
+	SymMat& operator/=(const _Scalar&);
+
+	//Element at position k of the packed vector(used by the expressions)
+	const _Scalar& coeff(Eigen::Index k) const { return mat[k]; }
+
+	//The packed vector as an Eigen vector(no copy, changes write into the matrix)
+	Eigen::Map< Eigen::Matrix<_Scalar,Eigen::Dynamic,1> > packed() { return Eigen::Map< Eigen::Matrix<_Scalar,Eigen::Dynamic,1> >(mat.data(),size()); }
+	Eigen::Map< const Eigen::Matrix<_Scalar,Eigen::Dynamic,1> > packed() const { return Eigen::Map< const Eigen::Matrix<_Scalar,Eigen::Dynamic,1> >(mat.data(),size()); }
+
+	//The whole matrix(both triangles) as a dense Eigen matrix
+	Eigen::Matrix<_Scalar,Eigen::Dynamic,Eigen::Dynamic> dense() const;
+
+	//No. of elements stored in the classical packed format
+	Eigen::Index size() const { return mat.size(); }
+	
+	//Returns the index of the element (i,j) stored in the vector(64 bit, see INDEXING)
+	Eigen::Index index(Eigen::Index,Eigen::Index);
+	
+	//Prints the matrix 
+	void print();
+
+	/***BASIC ARITHMETIC REDUCTION OPERATIONS*****/
+	//Sum of the elements
+	_Scalar sum();
+
+	//Returns the mean of elements
+	_Scalar mean();
+
+	//Sum, product and mean of only the elements stored in the packed format
+	_Scalar packedSum();
+	_Scalar packedProd();
+	_Scalar packedMean();
+
+	//Trace of matrix
+	_Scalar trace();
+
+	//Returns the minimum coefficient of the matrix
+	_Scalar minCoeff();
+
+	//Returns the maximum coefficient of the matrix
+	_Scalar maxCoeff();
+
+	/***ADDITIONAL FUNCTIONS***********/
+	//No.of elements stored in the classical packed format
+	Eigen::Index elemstored();
+
+	//Product of the diagonal elements
+	_Scalar diagprod();
+
+	//Product of the elements of the matrix
+	_Scalar prod();
+
+	//Transpose function
+	//SymMat transpose();
+
+	//Overloading the funtion call operator
+	_Scalar& operator()(Eigen::Index,Eigen::Index);
+
+};
+
+/***************************************************************************************************
+						FUNCTION PROTOTYPES
+						-------------------
+This section contains the prototypes of the functions used:-
+****************************************************************************************************/
+
+//Addition------------------------------------------------------------------------------------------
+template<typename _Lhs,typename _Rhs>
+SymMatBinaryExpr<_Lhs,_Rhs,SymMatSumOp> add(const SymMatExpr<_Lhs>&,const SymMatExpr<_Rhs>&);
+
+template<typename _Scalar,int _Rows, int _Cols>
+Eigen::Matrix<_Scalar,_Rows,_Cols> add(const SymMat<_Scalar>&,const Eigen::Matrix<_Scalar,_Rows,_Cols>&);
+
+template<typename _Scalar,int _Rows, int _Cols>
+Eigen::Matrix<_Scalar,_Rows,_Cols> add(const Eigen::Matrix<_Scalar,_Rows,_Cols>&,const SymMat<_Scalar>&);
+
+template<typename _Scalar,int _Rows, int _Cols>
+Eigen::Matrix<_Scalar,_Rows,_Cols> add(const SymMat<_Scalar>&,Eigen::Matrix<_Scalar,_Rows,_Cols>&&);
+
+template<typename _Scalar,int _Rows, int _Cols>
+Eigen::Matrix<_Scalar,_Rows,_Cols> add(Eigen::Matrix<_Scalar,_Rows,_Cols>&&,const SymMat<_Scalar>&);
+
+template<typename _Scalar,int _Rows, int _Cols>
+void add(const SymMat<_Scalar>&,const Eigen::Matrix<_Scalar,_Rows,_Cols>&,Eigen::Matrix<_Scalar,_Rows,_Cols>&);
+
+template<typename _Scalar,int _Rows, int _Cols>
+void add(const Eigen::Matrix<_Scalar,_Rows,_Cols>&,const SymMat<_Scalar>&,Eigen::Matrix<_Scalar,_Rows,_Cols>&);
+
+
+//Subtraction----------------------------------------------------------------------------------------
+template<typename _Lhs,typename _Rhs>
+SymMatBinaryExpr<_Lhs,_Rhs,SymMatDifferenceOp> sub(const SymMatExpr<_Lhs>&,const SymMatExpr<_Rhs>&);
+
+template<typename _Scalar,int _Rows, int _Cols>
+Eigen::Matrix<_Scalar,_Rows,_Cols> sub(const SymMat<_Scalar>&,const Eigen::Matrix<_Scalar,_Rows,_Cols>&);
+
+template<typename _Scalar,int _Rows, int _Cols>
+Eigen::Matrix<_Scalar,_Rows,_Cols> sub(const Eigen::Matrix<_Scalar,_Rows,_Cols>&,const SymMat<_Scalar>&);
+
+template<typename _Scalar,int _Rows, int _Cols>
+Eigen::Matrix<_Scalar,_Rows,_Cols> sub(const SymMat<_Scalar>&,Eigen::Matrix<_Scalar,_Rows,_Cols>&&);
+
+template<typename _Scalar,int _Rows, int _Cols>
+Eigen::Matrix<_Scalar,_Rows,_Cols> sub(Eigen::Matrix<_Scalar,_Rows,_Cols>&&,const SymMat<_Scalar>&);
+
+template<typename _Scalar,int _Rows, int _Cols>
+void sub(const SymMat<_Scalar>&,const Eigen::Matrix<_Scalar,_Rows,_Cols>&,Eigen::Matrix<_Scalar,_Rows,_Cols>&);
+
+template<typename _Scalar,int _Rows, int _Cols>
+void sub(const Eigen::Matrix<_Scalar,_Rows,_Cols>&,const SymMat<_Scalar>&,Eigen::Matrix<_Scalar,_Rows,_Cols>&);
+
+
+//Matrix-vector product(y = alpha*S*x + beta*y)---------------------------------------------------------
+template<typename _Scalar>
+void spmv(_Scalar,const SymMat<_Scalar>&,const _Scalar*,_Scalar,_Scalar*);
+
+template<typename _Scalar,int _Rows>
+void spmv(_Scalar,const SymMat<_Scalar>&,const Eigen::Matrix<_Scalar,_Rows,1>&,_Scalar,Eigen::Matrix<_Scalar,_Rows,1>&);
+
+
+//Symmetric rank-k update(C = alpha*A*A^T + beta*C)------------------------------------------------------
+template<typename _Scalar,typename _Derived>
+void syrk(_Scalar,const Eigen::MatrixBase<_Derived>&,_Scalar,SymMat<_Scalar>&);
+
+template<typename _Scalar>
+void syrk(_Scalar,const _Scalar*,int,int,_Scalar,SymMat<_Scalar>&);
+
+
+//Congruence transform(R = alpha*A^T*S*A + beta*R)-------------------------------------------------------
+template<typename _Scalar,typename _Derived>
+SymMat<_Scalar> congruence(const SymMat<_Scalar>&,const Eigen::MatrixBase<_Derived>&);
+
+template<typename _Scalar,typename _Derived>
+void congruence(_Scalar,const SymMat<_Scalar>&,const Eigen::MatrixBase<_Derived>&,_Scalar,SymMat<_Scalar>&);
+
+
+//Pairwise distances and kernels of the rows of X(R(i,j) = f(x(i),x(j)))--------------------------------
+enum SymMatDistance { SymMatSquaredEuclidean, SymMatEuclidean, SymMatCosine, SymMatRbf };
+
+template<typename _Derived>
+SymMat<typename _Derived::Scalar> pairwise(const Eigen::MatrixBase<_Derived>&,SymMatDistance,typename _Derived::Scalar gamma=1);
+
+template<typename _Scalar,typename _Derived>
+void pairwise(const Eigen::MatrixBase<_Derived>&,SymMatDistance,SymMat<_Scalar>&,_Scalar gamma=1);
+
+template<typename _Scalar>
+void pairwise(const _Scalar*,int,int,SymMatDistance,SymMat<_Scalar>&,_Scalar gamma=1);
+
+
+//Rank-1 updates(S = S + alpha*x*x^T, S + alpha*(x*y^T + y*x^T))---------------------------------------
+template<typename _Scalar,int _Rows>
+void spr(_Scalar,const Eigen::Matrix<_Scalar,_Rows,1>&,SymMat<_Scalar>&);
+
+template<typename _Scalar>
+void spr(_Scalar,const _Scalar*,SymMat<_Scalar>&);
+
+template<typename _Scalar,int _Rows>
+void spr2(_Scalar,const Eigen::Matrix<_Scalar,_Rows,1>&,const Eigen::Matrix<_Scalar,_Rows,1>&,SymMat<_Scalar>&);
+
+template<typename _Scalar>
+void spr2(_Scalar,const _Scalar*,const _Scalar*,SymMat<_Scalar>&);
+
+
+//Cholesky factorization(S = U^T*U, in place of S)--------------------------------------------------------
+template<typename _Scalar>
+int cholesky(SymMat<_Scalar>&);
+
+template<typename _Scalar,int _Rows,int _Cols>
+void cholsolve(SymMat<_Scalar>&,Eigen::Matrix<_Scalar,_Rows,_Cols>&);
+
+template<typename _Scalar>
+SymMat<_Scalar> cholinverse(SymMat<_Scalar>&);
+
+template<typename _Scalar>
+_Scalar chollogdet(SymMat<_Scalar>&);
+
+template<typename _Scalar,int _Rows>
+void cholupdate(SymMat<_Scalar>&,const Eigen::Matrix<_Scalar,_Rows,1>&);
+
+template<typename _Scalar,int _Rows>
+int choldowndate(SymMat<_Scalar>&,const Eigen::Matrix<_Scalar,_Rows,1>&);
+
+
+//Eigenvalues and eigenvectors---------------------------------------------------------------------------
+template<typename _Scalar>
+int eigenvalues(SymMat<_Scalar>&,Eigen::Matrix<_Scalar,Eigen::Dynamic,1>&,bool inplace=false);
+
+template<typename _Scalar>
+int eigenvectors(SymMat<_Scalar>&,Eigen::Matrix<_Scalar,Eigen::Dynamic,1>&,Eigen::Matrix<_Scalar,Eigen::Dynamic,Eigen::Dynamic>&,bool inplace=false);
+
+
+//Multiplication--------------------------------------------------------------------------------------
+template<typename _Scalar,int _Rows, int _Cols>
+Eigen::Matrix<_Scalar,_Rows,_Cols> mult(const SymMat<_Scalar>&,const SymMat<_Scalar>&);
+
+template<typename _Scalar,int _Rows, int _Cols>
+Eigen::Matrix<_Scalar,_Rows,_Cols> mult(const SymMat<_Scalar>&,const Eigen::Matrix<_Scalar,_Rows,_Cols>&);
+
+template<typename _Scalar,int _Rows, int _Cols>
+Eigen::Matrix<_Scalar,_Rows,_Cols> mult(const Eigen::Matrix<_Scalar,_Rows,_Cols>&,const SymMat<_Scalar>&);
+
+template<typename _Scalar,int _Rows, int _Cols>
+void mult(const SymMat<_Scalar>&,const SymMat<_Scalar>&,Eigen::Matrix<_Scalar,_Rows,_Cols>&);
+
+template<typename _Scalar,int _Rows, int _Cols>
+void mult(const SymMat<_Scalar>&,const Eigen::Matrix<_Scalar,_Rows,_Cols>&,Eigen::Matrix<_Scalar,_Rows,_Cols>&);
+
+template<typename _Scalar,int _Rows, int _Cols>
+void mult(const Eigen::Matrix<_Scalar,_Rows,_Cols>&,const SymMat<_Scalar>&,Eigen::Matrix<_Scalar,_Rows,_Cols>&);
+
+
+
+/*****************************************************************************************************
+						CONSTRUCTOR
+						-----------
+INDEXING:- the order is an int, but the packed vector of order n has n(n+1)/2 elements, which is more than
+an int can hold from order 65536(and n*(n+1) overflows already from order 46341). So the no. of elements,
+the positions in the packed vector and the loop counters of the kernels are all Eigen::Index(64 bit).
+The no. of elements is checked before the vector is allocated, a matrix which cannot be stored terminates
+the program like a wrong initializer list.
+******************************************************************************************************/
+
+//Initialize with a default 3x3 matrix initialised with '0'
+template<typename _Scalar>
+SymMat<_Scalar>::SymMat()
+{
+	SYMMAT_TRACE_OP("construct",_Scalar,3,6,6*sizeof(_Scalar));
+	Eigen::Index elements;
+	order=3;
+	elements=6;
+	mat.resize(elements);
+	std::fill(mat.begin(),mat.end(),0); //filling all elements of the vector with '0'
+}
+
+//Custom matrice of order as inputted by user intialised with '0'
+template<typename _Scalar>
+SymMat<_Scalar>::SymMat(int o)
+{
+	SYMMAT_TRACE_OP("construct",_Scalar,o,(Eigen::Index(o)*(o+1))/2,sizeof(_Scalar)*((Eigen::Index(o)*(o+1))/2));
+	Eigen::Index elements;
+	order=o;
+	elements=SymMatInternal::checkedElements<_Scalar>(order);
+	mat.resize(elements);
+	std::fill(mat.begin(),mat.end(),0); //filling all elements of the vector with '0'
+}
+
+//Custom matrice whose memory comes from the resource r
+template<typename _Scalar>
+SymMat<_Scalar>::SymMat(int o,SymMatResource* r) :mat(SymMatAllocator<_Scalar>(r))
+{
+	SYMMAT_TRACE_OP("construct",_Scalar,o,(Eigen::Index(o)*(o+1))/2,sizeof(_Scalar)*((Eigen::Index(o)*(o+1))/2));
+	order=o;
+	mat.resize(SymMatInternal::checkedElements<_Scalar>(order));
+	std::fill(mat.begin(),mat.end(),0); //filling all elements of the vector with '0'
+}
+
+//Using initializer_list to initialize the matrice
+template<typename _Scalar>
+SymMat<_Scalar>::SymMat(std::initializer_list<_Scalar> list) :mat(list) 
+{
+	/*First it is checked whether the number of elements entered are equal to the elements in
+	  the upper triangle of a square matrix.	
+	  Since the the no. of elements follow the following series:- 3(for 2x2),6(for 3x3),10(for 4x4),... 
+	  the following formula is used to calculate the order of the matrix and whether such an order exist:-
+	  -----------------------------------
+	  no.of elements=(order*(order+1))/2 
+	  (Sum of arithmetic series:- 1,2,3,4...)
+	  -----------------------------------
+	  The order is found in integers(packedOrder), not only with the square root.
+	  */
+	const Eigen::Index n=SymMatInternal::packedOrder(Eigen::Index(mat.size()));
+	try
+	{
+		if(n<0 || n>std::numeric_limits<int>::max())
+		{
+			throw 'f';	
+		}
+		order=int(n);
+	}
+	catch(char& check)
+	{
+		std::cout<<"Wrong number of elements for a upper triangle of square matrix!\nTerminating the program..."<<std::endl;
+		std::exit(0);
+	}
+
+}
+
+//Takes over the memory of a packed vector(moved, not copied), which must have the elements of the order
+template<typename _Scalar>
+SymMat<_Scalar>::SymMat(int o,Storage&& packed) :order(o),mat(std::move(packed))
+{
+	SYMMAT_TRACE_OP("adopt",_Scalar,o,Eigen::Index(mat.size()),0);
+	if(Eigen::Index(mat.size())!=SymMatInternal::packedElements<_Scalar>(o))
+	{
+		std::cout<<"Wrong number of elements for a upper triangle of square matrix!\nTerminating the program..."<<std::endl;
+		std::exit(0);
+	}
+}
+
+/*******************************************************************************************************
+						CONVERTING FROM AND TO EIGEN MATRICES
+The triangle is copied with the blocked loops of CONVERSIONS FROM AND TO EIGEN MATRICES, instead of
+listing the elements in an initializer list or copying them one by one through operator().
+********************************************************************************************************/
+template<typename _Scalar>
+template<typename _Derived>
+SymMat<_Scalar>::SymMat(const Eigen::MatrixBase<_Derived>& other)
+{
+	assert(other.rows()==other.cols());       //Condition for the matrix to be square
+	SYMMAT_TRACE_OP("construct(M)",_Scalar,other.rows(),other.size(),sizeof(_Scalar)*other.size());
+	order=int(other.rows());
+	mat.resize(SymMatInternal::checkedElements<_Scalar>(order));
+	SymMatInternal::packUpper(other,mat.data());
+}
+
+//The lower triangle, read by columns, is the upper triangle of the transposed matrix read by rows
+template<typename _Scalar>
+template<typename _MatrixType,unsigned int _UpLo>
+SymMat<_Scalar>::SymMat(const Eigen::SelfAdjointView<_MatrixType,_UpLo>& other)
+{
+	assert(other.rows()==other.cols());       //Condition for the matrix to be square
+	SYMMAT_TRACE_OP("construct(M)",_Scalar,other.rows(),other.rows()*other.rows(),sizeof(_Scalar)*other.rows()*other.rows());
+	order=int(other.rows());
+	mat.resize(SymMatInternal::checkedElements<_Scalar>(order));
+	if(_UpLo&Eigen::Upper)
+	{
+		SymMatInternal::packUpper(other.nestedExpression(),mat.data());
+	}
+	else
+	{
+		SymMatInternal::packUpper(other.nestedExpression().transpose(),mat.data());
+	}
+}
+
+template<typename _Scalar>
+Eigen::Matrix<_Scalar,Eigen::Dynamic,Eigen::Dynamic> SymMat<_Scalar>::dense() const
+{
+	SYMMAT_TRACE_OP("dense",_Scalar,order,Eigen::Index(mat.size()),sizeof(_Scalar)*(mat.size()+Eigen::Index(order)*order));
+	Eigen::Matrix<_Scalar,Eigen::Dynamic,Eigen::Dynamic> m2(order,order);
+	SymMatInternal::unpackDense(Eigen::Index(order),mat.data(),m2.data());
+	return m2;
+}
+
+/*******************************************************************************************************
+						EVALUATING AN EXPRESSION
+The whole expression is computed in one loop over the packed vector. The loop only contains additions,
+subtractions and multiplications of elements at the same position, so the compiler can vectorize it.
+********************************************************************************************************/
+template<typename _Scalar>
+template<typename _Derived>
+SymMat<_Scalar>::SymMat(const SymMatExpr<_Derived>& other)
+{
+	order=0;
+	*this=other;
+}
+
+template<typename _Scalar>
+template<typename _Derived>
+SymMat<_Scalar>& SymMat<_Scalar>::operator=(const SymMatExpr<_Derived>& other)
+{
+	const _Derived& expr=other.derived();
+	SYMMAT_TRACE_OP("assign",_Scalar,expr.order,expr.size(),sizeof(_Scalar)*expr.size());
+
+	//Storage is only reallocated when the order changes
+	if(order!=expr.order || Eigen::Index(mat.size())!=expr.size())
+	{
+		order=expr.order;
+		mat.resize(expr.size());
+	}
+
+	_Scalar* dst=mat.data();
+	const Eigen::Index elements=expr.size();
+	for(Eigen::Index k=0;k<elements;k++)
+	{
+		dst[k]=expr.coeff(k);
+	}
+	return *this;
+}
+
+template<typename _Scalar>
+template<typename _Derived>
+SymMat<_Scalar>& SymMat<_Scalar>::operator+=(const SymMatExpr<_Derived>& other)
+{
+	SYMMAT_TRACE_OP("+=",_Scalar,order,mat.size(),2*sizeof(_Scalar)*mat.size());
+	assert(size()==other.derived().size());       //Condition for matrices to be conformable for addition
+	SymMatInternal::compoundAssign(mat.data(),other.derived(),SymMatSumOp());
+	return *this;
+}
+
+template<typename _Scalar>
+template<typename _Derived>
+SymMat<_Scalar>& SymMat<_Scalar>::operator-=(const SymMatExpr<_Derived>& other)
+{
+	SYMMAT_TRACE_OP("-=",_Scalar,order,mat.size(),2*sizeof(_Scalar)*mat.size());
+	assert(size()==other.derived().size());       //Condition for matrices to be conformable for subtraction
+	SymMatInternal::compoundAssign(mat.data(),other.derived(),SymMatDifferenceOp());
+	return *this;
+}
+
+template<typename _Scalar>
+SymMat<_Scalar>& SymMat<_Scalar>::operator*=(const _Scalar& a)
+{
+	SYMMAT_TRACE_OP("*=",_Scalar,order,mat.size(),sizeof(_Scalar)*mat.size());
+	packed()*=a;
+	return *this;
+}
+
+template<typename _Scalar>
+SymMat<_Scalar>& SymMat<_Scalar>::operator/=(const _Scalar& a)
+{
+	SYMMAT_TRACE_OP("/=",_Scalar,order,mat.size(),sizeof(_Scalar)*mat.size());
+	packed()/=a;
+	return *this;
+}
+
+/*******************************************************************************************************
+						OVERLOADING FUNCTION CALL OPERATOR
+********************************************************************************************************/
+template<typename _Scalar>
+_Scalar& SymMat<_Scalar>::operator()(Eigen::Index i,Eigen::Index j)
+{
+	SYMMAT_TRACE_ACCESS(_Scalar,order);
+	if(i>=j)
+	{
+		return mat[index(i,j)];
+	}
+	else
+	{
+		//Since the matrix is symmetric, it means that A(i,j)==A(j,i)
+		return mat[index(j,i)];
+	}
+
+}
+
+/********************************************************************************************************
+				CALCULATES THE INDEX OF ELEMENT AT (i,j) IN VECTOR
+*********************************************************************************************************/
+template<typename _Scalar>
+Eigen::Index SymMat<_Scalar>::index(Eigen::Index i,Eigen::Index j)
+{
+	if(i>j)  //swapping i and j since only the upper triangle is stored
+	{
+		std::swap(i,j);
+	}
+
+	/*Row i starts after the rows 0..i-1, which hold order+(order-1)+...+(order-i+1) elements,
+	  and (i,j) is j-i places after the diagonal element of row i. All of it is in Eigen::Index,
+	  so it does not overflow for the large orders.*/
+	return SymMatInternal::diagIndex(order,i)+(j-i);
+}
+
+
+/**********************************************************************************************************
+						PRINT MATRIX
+***********************************************************************************************************/
+
+//Print function for printing the matrix belonging to SymMat class on screen
+template<typename _Scalar>
+void SymMat<_Scalar>::print()
+{
+  int i,j;
+  for(i=0;i<order;i++)
+  {
+  	for (j=0;j<order;j++)
+  	{  
+  		std::cout<<std::setw(4)<<mat[index(i,j)]<<" ";  //setw() here sets 4 digits space for each element
+	} 
+  	std::cout<<"\n";
+  }
+}
+
+/**********************************************************************************************************
+						TRACE OF MATRIX
+***********************************************************************************************************/
+
+//Trace function to return trace of matrix
+template<typename _Scalar>
+_Scalar SymMat<_Scalar>::trace()
+{
+	SYMMAT_TRACE_OP("trace",_Scalar,order,order,sizeof(_Scalar)*order);
+
+  //This variable stores the trace of the matrix
+  _Scalar store_trace=0;  
+
+  //The diagonal element of row i+1 is (order-i) places after the diagonal element of row i
+  Eigen::Index diag=0;
+  for(int i=0;i<order;i++)
+  {
+  	store_trace += mat[diag];
+  	diag += order-i;
+  }
+  return store_trace;
+}
+
+/**********************************************************************************************************
+						PRODUCT OF DIAGONAL ELEMENTS OF THE MATRIX
+***********************************************************************************************************/
+
+//Function to return the product elements of the matrix
+template<typename _Scalar>
+_Scalar SymMat<_Scalar>::diagprod()
+{
+	SYMMAT_TRACE_OP("diagprod",_Scalar,order,order,sizeof(_Scalar)*order);
+
+  //This variable stores the trace of the matrix
+  _Scalar store_diag_prod=1;  
+
+  Eigen::Index diag=0;
+  for(int i=0;i<order;i++)
+  {
+  	store_diag_prod *= mat[diag];
+  	diag += order-i;
+  }
+  return store_diag_prod;
+}
+
+
+
+
+/**********************************************************************************************************
+						SUM OF THE ELEMENTS OF MATRIX
+
+Efficiency improvement:-
+
+In a normal matrix, we have to traverse through all the elements to calculate the sum,
+However here, the elements in upper triangle except the diagonal elements are same in the lower half, 
+So we have to only calculate the sum of upper triangel except the diagonal elements and make it twice 
+and then add it to the sum of diagonal elements.
+
+The packed vector is summed by the SIMD kernel, so the result is:  2*(sum of packed vector) - trace
+packedSum() returns only the sum of the stored elements(each off-diagonal element counted once).
+
+***********************************************************************************************************/
+
+//Sum function to return the sum of all the elements of the matrix
+template<typename _Scalar>
+_Scalar SymMat<_Scalar>::sum()
+{
+	SYMMAT_TRACE_OP("sum",_Scalar,order,mat.size(),sizeof(_Scalar)*mat.size());
+
+  //This variable stores the sum of the elements of matrix
+  _Scalar store_sum,store_trace;
+
+  store_trace=trace();
+  store_sum=packedSum();
+
+  store_sum-=store_trace;
+  store_sum*=2;
+  store_sum+=store_trace;
+
+  return store_sum;
+}
+
+//Sum of the elements stored in the packed format
+template<typename _Scalar>
+_Scalar SymMat<_Scalar>::packedSum()
+{
+	SYMMAT_TRACE_OP("packedSum",_Scalar,order,mat.size(),sizeof(_Scalar)*mat.size());
+  return SymMatInternal::packedSum(mat.data(),Eigen::Index(mat.size()));
+}
+
+/**********************************************************************************************************
+						PRODUCT OF THE ELEMENTS OF MATRIX
+
+Efficiency improvement:-
+
+In a normal matrix, we have to traverse through all the elements to calculate the product,
+However here, the elements in upper triangle except the diagonal elements are same in the lower half, 
+So we have to only calculate the product of upper triangel except the diagonal elements and make it squared 
+and then multiply it by the product of diagonal elements.
+
+The off-diagonal elements of each row are contiguous in the packed vector(they follow the diagonal element),
+so their product is taken row by row with the SIMD kernel, instead of dividing the product of the whole
+vector by the diagonal product(which fails when a diagonal element is zero).
+
+***********************************************************************************************************/
+
+//Product function to return the product of all the elements of the matrix
+template<typename _Scalar>
+_Scalar SymMat<_Scalar>::prod()
+{
+	SYMMAT_TRACE_OP("prod",_Scalar,order,mat.size(),sizeof(_Scalar)*mat.size());
+
+  //This variable stores the product of the off-diagonal elements of the upper triangle
+  _Scalar store_prod=1,store_diag_prod;
+
+  store_diag_prod=diagprod();
+
+  Eigen::Index diag=0;
+  for(int i=0;i<order-1;i++)
+  {
+  	store_prod*=SymMatInternal::packedProd(mat.data()+diag+1,Eigen::Index(order-i-1));
+  	diag += order-i;
+  }
+  store_prod*=store_prod;
+  store_prod*=store_diag_prod;
+
+  return store_prod;
+}
+
+//Product of the elements stored in the packed format
+template<typename _Scalar>
+_Scalar SymMat<_Scalar>::packedProd()
+{
+	SYMMAT_TRACE_OP("packedProd",_Scalar,order,mat.size(),sizeof(_Scalar)*mat.size());
+  return SymMatInternal::packedProd(mat.data(),Eigen::Index(mat.size()));
+}
+ 
+ 
+
+
+/**********************************************************************************************************
+						MEAN OF THE ELEMENTS OF MATRIX
+
+Efficiency improvement:-
+
+In a normal matrix, we have to traverse through all the elements to calculate the sum, and then divide by 
+the total number of elements to get the mean.
+
+However, in this class the sum is calculated efficiently using the sum() function and then it is divided by 
+the total number of elements.
+
+Hence overall it is faster to calculate the mean of the matrix.
+
+***********************************************************************************************************/
+
+//Mean function to return the mean of elements of the matrix
+template<typename _Scalar>
+_Scalar SymMat<_Scalar>::mean()
+{
+	SYMMAT_TRACE_OP("mean",_Scalar,order,mat.size(),sizeof(_Scalar)*mat.size());
+
+  //This variable stores the sum of the elements of matrix
+  _Scalar store_sum,store_mean;  
+
+  store_sum=sum();
+  store_mean=store_sum/(_Scalar(order)*_Scalar(order));
+
+  return store_mean;
+}
+
+//Mean of the elements stored in the packed format
+template<typename _Scalar>
+_Scalar SymMat<_Scalar>::packedMean()
+{
+	SYMMAT_TRACE_OP("packedMean",_Scalar,order,mat.size(),sizeof(_Scalar)*mat.size());
+  return packedSum()/_Scalar(mat.size());
+}
+
+
+/**********************************************************************************************************
+						MAX COEFFICIENT AMONGST THE ELEMENTS OF MATRIX
+
+Efficiency improvement:-
+
+In a normal matrix, we have to traverse through all the elements to check all the elements.
+
+In this class, we have to traverse through only the elements in the upper triangle. 
+
+This improves the efficiency since the no. of iterations to check the maximum element value are less.
+The maximum of the whole matrix and of the packed vector is the same, so there is no packed variant.
+
+***********************************************************************************************************/
+
+//Function to return the maximum coefficient in the matrix
+template<typename _Scalar>
+_Scalar SymMat<_Scalar>::maxCoeff()
+{
+	SYMMAT_TRACE_OP("maxCoeff",_Scalar,order,mat.size(),sizeof(_Scalar)*mat.size());
+  return SymMatInternal::packedMax(mat.data(),Eigen::Index(mat.size()));
+}
+
+
+/**********************************************************************************************************
+						MINIMUM COEFFICIENT AMONGST THE ELEMENTS OF MATRIX
+
+Efficiency improvement:-
+
+In a normal matrix, we have to traverse through all the elements to check all the elements.
+
+In this class, we have to traverse through only the elements in the upper triangle. 
+
+This improves the efficiency since the no. of iterations to check the minimum element value are less.
+
+***********************************************************************************************************/
+
+//Function to return the minimum coefficient in the matrix
+template<typename _Scalar>
+_Scalar SymMat<_Scalar>::minCoeff()
+{
+	SYMMAT_TRACE_OP("minCoeff",_Scalar,order,mat.size(),sizeof(_Scalar)*mat.size());
+  return SymMatInternal::packedMin(mat.data(),Eigen::Index(mat.size()));
+}
+/*******************************************************************************************************
+						NUMBER OF ELEMENTS STORED IN THE CLASSICAL PACKED FORMAT
+********************************************************************************************************/
+//Function to return the number of matrix elements stored in the classical packed format 
+template<typename _Scalar>
+Eigen::Index SymMat<_Scalar>::elemstored()
+{
+  return mat.size();
+}
+
+
+
+/***********************************************************************************************************
+						ADDITION
+					---------------	
+Efficiency improvement:-
+In addition between symmetric matrices, we only have to add the elements of upper triangle to get
+the elements of the resulting symmetric matrix.
+The addition of two symmetric matrices (or expressions) returns an expression, which is computed only when
+it is assigned to a SymMat, together with the rest of the expression it is part of.
+With an Eigen::Matrix, the symmetric matrix is unpacked into the result(see CONVERSIONS FROM AND TO EIGEN
+MATRICES) and the Eigen matrix is added to it in one vectorized pass.
+
+
+There is function overloading for the following:
+1)Both belongs to SymMat
+2)First belongs to SymMat and other to Eigen::Matrix
+3)First belongs to Eigen::Matrix and other to SymMat
+************************************************************************************************************/
+
+
+//Addition function for two matrices(or expressions) belonging to SymMat class
+template<typename _Lhs,typename _Rhs>
+SymMatBinaryExpr<_Lhs,_Rhs,SymMatSumOp> add(const SymMatExpr<_Lhs>& m1,const SymMatExpr<_Rhs>& m2)
+{
+	return m1+m2;
+}
+
+
+//Addition function between one matrix belonging to SymMat class(First argument) and another(Second argument) to Eigen::Matrix
+template<typename _Scalar,int _Rows, int _Cols>
+Eigen::Matrix<_Scalar,_Rows,_Cols> add(const SymMat<_Scalar>& m1,const Eigen::Matrix<_Scalar,_Rows,_Cols>& m2)
+{
+	Eigen::Matrix<_Scalar,_Rows,_Cols> m3;
+	add(m1,m2,m3);
+	return m3;
+}
+
+
+//Addition function between one matrix belonging to Eigen::matrix(First argument) and SymMat class(Second argument) to Eigen::Matrix
+template<typename _Scalar,int _Rows, int _Cols>
+Eigen::Matrix<_Scalar,_Rows,_Cols> add(const Eigen::Matrix<_Scalar,_Rows,_Cols>& m2,const SymMat<_Scalar>& m1)
+{
+	Eigen::Matrix<_Scalar,_Rows,_Cols> m3;
+	add(m2,m1,m3);
+	return m3;
+}
+
+
+//Addition into an expiring Eigen::Matrix, whose storage is reused for the result
+template<typename _Scalar,int _Rows, int _Cols>
+Eigen::Matrix<_Scalar,_Rows,_Cols> add(const SymMat<_Scalar>& m1,Eigen::Matrix<_Scalar,_Rows,_Cols>&& m2)
+{
+	add(m1,m2,m2);
+	return std::move(m2);
+}
+
+template<typename _Scalar,int _Rows, int _Cols>
+Eigen::Matrix<_Scalar,_Rows,_Cols> add(Eigen::Matrix<_Scalar,_Rows,_Cols>&& m2,const SymMat<_Scalar>& m1)
+{
+	add(m2,m1,m2);
+	return std::move(m2);
+}
+
+
+//Addition into the destination m3, which is resized only when its size is not n x n(m3 may be m2)
+template<typename _Scalar,int _Rows, int _Cols>
+void add(const SymMat<_Scalar>& m1,const Eigen::Matrix<_Scalar,_Rows,_Cols>& m2,Eigen::Matrix<_Scalar,_Rows,_Cols>& m3)
+{
+	SYMMAT_TRACE_OP("add(S,M)",_Scalar,m1.order,m1.mat.size(),sizeof(_Scalar)*(m1.mat.size()+2*m2.size()));
+	assert(m1.order == m2.rows() && m1.order == m2.cols());       //Condition for matrices to be conformable for addition
+	if(m3.data()==m2.data())
+	{
+		SymMatInternal::addPacked(Eigen::Index(m1.order),_Scalar(1),m1.mat.data(),_Scalar(1),m3.data());
+		return;
+	}
+	m3.resize(m2.rows(),m2.cols());
+	SymMatInternal::unpackDense(Eigen::Index(m1.order),m1.mat.data(),m3.data());
+	m3+=m2;
+}
+
+template<typename _Scalar,int _Rows, int _Cols>
+void add(const Eigen::Matrix<_Scalar,_Rows,_Cols>& m2,const SymMat<_Scalar>& m1,Eigen::Matrix<_Scalar,_Rows,_Cols>& m3)
+{
+	SYMMAT_TRACE_OP("add(M,S)",_Scalar,m1.order,m1.mat.size(),sizeof(_Scalar)*(m1.mat.size()+2*m2.size()));
+	assert(m1.order==m2.rows() && m1.order == m2.cols());       //Condition for matrices to be conformable for addition
+	if(m3.data()==m2.data())
+	{
+		SymMatInternal::addPacked(Eigen::Index(m1.order),_Scalar(1),m1.mat.data(),_Scalar(1),m3.data());
+		return;
+	}
+	m3.resize(m2.rows(),m2.cols());
+	SymMatInternal::unpackDense(Eigen::Index(m1.order),m1.mat.data(),m3.data());
+	m3+=m2;
+}
+
+
+
+/********************************************************************************************************
+						SUBTRACTION
+					------------------	
+There is function overloading for the following:
+1)Both belongs to SymMat
+2)First belongs to SymMat and other to Eigen::Matrix
+3)First belongs to Eigen::Matrix and other to SymMat
+**********************************************************************************************************/
+
+//Subtraction function for two matrices(or expressions) belonging to SymMat class
+template<typename _Lhs,typename _Rhs>
+SymMatBinaryExpr<_Lhs,_Rhs,SymMatDifferenceOp> sub(const SymMatExpr<_Lhs>& m1,const SymMatExpr<_Rhs>& m2)
+{
+	return m1-m2;
+}
+
+
+//Subtraction function between one matrix belonging to SymMat class(First argument) and another(Second argument) to Eigen::Matrix
+template<typename _Scalar,int _Rows, int _Cols>
+Eigen::Matrix<_Scalar,_Rows,_Cols> sub(const SymMat<_Scalar>& m1,const Eigen::Matrix<_Scalar,_Rows,_Cols>& m2)
+{
+	Eigen::Matrix<_Scalar,_Rows,_Cols> m3;
+	sub(m1,m2,m3);
+	return m3;
+}
+
+
+//Subtraction function between one matrix belonging to Eigen::matrix(First argument) and SymMat class(Second argument) to Eigen::Matrix
+template<typename _Scalar,int _Rows, int _Cols>
+Eigen::Matrix<_Scalar,_Rows,_Cols> sub(const Eigen::Matrix<_Scalar,_Rows,_Cols>& m2,const SymMat<_Scalar>& m1)
+{
+	Eigen::Matrix<_Scalar,_Rows,_Cols> m3;
+	sub(m2,m1,m3);
+	return m3;
+}
+
+
+//Subtraction into an expiring Eigen::Matrix, whose storage is reused for the result
+template<typename _Scalar,int _Rows, int _Cols>
+Eigen::Matrix<_Scalar,_Rows,_Cols> sub(const SymMat<_Scalar>& m1,Eigen::Matrix<_Scalar,_Rows,_Cols>&& m2)
+{
+	sub(m1,m2,m2);
+	return std::move(m2);
+}
+
+template<typename _Scalar,int _Rows, int _Cols>
+Eigen::Matrix<_Scalar,_Rows,_Cols> sub(Eigen::Matrix<_Scalar,_Rows,_Cols>&& m2,const SymMat<_Scalar>& m1)
+{
+	sub(m2,m1,m2);
+	return std::move(m2);
+}
+
+
+//Subtraction into the destination m3, which is resized only when its size is not n x n(m3 may be m2)
+template<typename _Scalar,int _Rows, int _Cols>
+void sub(const SymMat<_Scalar>& m1,const Eigen::Matrix<_Scalar,_Rows,_Cols>& m2,Eigen::Matrix<_Scalar,_Rows,_Cols>& m3)
+{
+	SYMMAT_TRACE_OP("sub(S,M)",_Scalar,m1.order,m1.mat.size(),sizeof(_Scalar)*(m1.mat.size()+2*m2.size()));
+	assert(m1.order == m2.rows() && m1.order == m2.cols());       //Condition for matrices to be conformable for subtraction
+	if(m3.data()==m2.data())
+	{
+		SymMatInternal::addPacked(Eigen::Index(m1.order),_Scalar(1),m1.mat.data(),_Scalar(-1),m3.data());
+		return;
+	}
+	m3.resize(m2.rows(),m2.cols());
+	SymMatInternal::unpackDense(Eigen::Index(m1.order),m1.mat.data(),m3.data());
+	m3-=m2;
+}
+
+template<typename _Scalar,int _Rows, int _Cols>
+void sub(const Eigen::Matrix<_Scalar,_Rows,_Cols>& m2,const SymMat<_Scalar>& m1,Eigen::Matrix<_Scalar,_Rows,_Cols>& m3)
+{
+	SYMMAT_TRACE_OP("sub(M,S)",_Scalar,m1.order,m1.mat.size(),sizeof(_Scalar)*(m1.mat.size()+2*m2.size()));
+	assert(m1.order==m2.rows() && m1.order == m2.cols());       //Condition for matrices to be conformable for subtraction
+	if(m3.data()==m2.data())
+	{
+		SymMatInternal::addPacked(Eigen::Index(m1.order),_Scalar(-1),m1.mat.data(),_Scalar(1),m3.data());
+		return;
+	}
+	m3.resize(m2.rows(),m2.cols());
+	SymMatInternal::unpackDense(Eigen::Index(m1.order),m1.mat.data(),m3.data());
+	m3=m2-m3;
+}
+
+/**********************************************************************************************************
+						MATRIX-VECTOR PRODUCT
+					-----------------------------
+y = alpha*S*x + beta*y
+
+Efficiency improvement:-
+Every element stored in the upper triangle is used for both S(i,j)*x(j) and S(j,i)*x(i) while it is
+read, so the product reads only the packed vector(half of the matrix) from memory.
+(see SYMMETRIC MATRIX-VECTOR PRODUCT KERNELS for the details)
+************************************************************************************************************/
+
+//Matrix-vector product on raw arrays of length m1.order
+template<typename _Scalar>
+void spmv(_Scalar alpha,const SymMat<_Scalar>& m1,const _Scalar* x,_Scalar beta,_Scalar* y)
+{
+	SYMMAT_TRACE_OP("spmv",_Scalar,m1.order,m1.mat.size(),sizeof(_Scalar)*(m1.mat.size()+2*m1.order));
+	SymMatInternal::spmv(Eigen::Index(m1.order),alpha,m1.mat.data(),x,beta,y);
+}
+
+//Matrix-vector product on Eigen vectors
+template<typename _Scalar,int _Rows>
+void spmv(_Scalar alpha,const SymMat<_Scalar>& m1,const Eigen::Matrix<_Scalar,_Rows,1>& x,_Scalar beta,Eigen::Matrix<_Scalar,_Rows,1>& y)
+{
+	SYMMAT_TRACE_OP("spmv",_Scalar,m1.order,m1.mat.size(),sizeof(_Scalar)*(m1.mat.size()+2*m1.order));
+	assert(m1.order==x.rows());       //Condition for the matrix and the vector to be conformable
+	y.resize(m1.order);
+	SymMatInternal::spmv(Eigen::Index(m1.order),alpha,m1.mat.data(),x.data(),beta,y.data());
+}
+
+/**********************************************************************************************************
+						SYMMETRIC RANK-K UPDATE
+					-------------------------------
+C = alpha*A*A^T + beta*C		(A has C.order rows and any number of columns)
+
+Efficiency improvement:-
+Only the upper triangle of A*A^T is computed and it is written directly into the packed vector of C,
+so it takes half of the flops of the full product and no dense n x n matrix is created.
+
+The rows of A are cut into blocks of SYMMAT_SYRK_BLOCK rows. For every pair of blocks(I<=J) the tile
+A(I)*A(J)^T is computed by Eigen's matrix product(which is blocked and vectorized) into a small buffer,
+and its upper part is copied into the rows of the packed vector. The tiles are shared between the
+threads when OpenMP is used.
+************************************************************************************************************/
+
+//Rows of A in each tile
+#ifndef SYMMAT_SYRK_BLOCK
+#define SYMMAT_SYRK_BLOCK 128
+#endif
+
+namespace SymMatInternal
+{
+
+//C(tile) = beta*C(tile) + alpha*T for the br x bc tile at (r,c) of a packed matrix of order n, where T is row
+//major with ld elements per row. Only j>=i is stored, which matters for the tiles on the diagonal(r==c)
+template<typename _Scalar>
+void storeTile(Eigen::Index n,_Scalar alpha,_Scalar beta,_Scalar* cp,Eigen::Index r,Eigen::Index br,Eigen::Index c,Eigen::Index bc,const _Scalar* T,Eigen::Index ld)
+{
+	for(Eigen::Index i=0;i<br;i++)
+	{
+		const Eigen::Index first= r==c ? i : 0;
+		_Scalar* row=cp+diagIndex(n,r+i)+(c+first-(r+i));
+		const _Scalar* t=T+i*ld+first;
+		const Eigen::Index len=bc-first;
+		if(beta==_Scalar(0))
+		{
+			for(Eigen::Index j=0;j<len;j++)
+			{
+				row[j]=alpha*t[j];
+			}
+		}
+		else
+		{
+			for(Eigen::Index j=0;j<len;j++)
+			{
+				row[j]=beta*row[j]+alpha*t[j];
+			}
+		}
+	}
+}
+
+//Goes over the tiles of the upper triangle of a packed matrix of order n in parallel. For tile (r,c) of
+//br x bc elements, tile(r,br,c,bc,T) computes T, and C(tile) = beta*C(tile) + alpha*T is written
+template<typename _Scalar,typename _TileFunction>
+void packedTiles(Eigen::Index n,_Scalar alpha,_Scalar beta,_Scalar* cp,_TileFunction tile)
+{
+	typedef Eigen::Map< Eigen::Matrix<_Scalar,Eigen::Dynamic,Eigen::Dynamic,Eigen::RowMajor> > Tile;
+
+	const Eigen::Index bs=SYMMAT_SYRK_BLOCK;
+	const Eigen::Index tiles=(n+bs-1)/bs;
+
+	//Pairs of blocks(I<=J) in the upper triangle
+	const Eigen::Index npairs=tiles*(tiles+1)/2;
+	Eigen::Index* pairs=scratch<Eigen::Index,ScratchPairs>(size_t(npairs));
+	for(Eigen::Index I=0,p=0;I<tiles;I++)
+	{
+		for(Eigen::Index J=I;J<tiles;J++)
+		{
+			pairs[p++]=I*tiles+J;
+		}
+	}
+
+	//A single tile is not worth the threads
+#ifdef _OPENMP
+	#pragma omp parallel if(npairs>1)
+#endif
+	{
+		Tile T(scratch<_Scalar,ScratchTile>(size_t(bs*bs)),bs,bs);
+
+#ifdef _OPENMP
+		#pragma omp for schedule(dynamic)
+#endif
+		for(Eigen::Index p=0;p<npairs;p++)
+		{
+			const Eigen::Index I=pairs[p]/tiles,J=pairs[p]%tiles;
+			const Eigen::Index r=I*bs,c=J*bs;
+			const Eigen::Index br=std::min(bs,n-r),bc=std::min(bs,n-c);
+
+			tile(r,br,c,bc,T);
+			storeTile(n,alpha,beta,cp,r,br,c,bc,T.data(),bs);
+		}
+	}
+}
+
+//C = alpha*A*A^T + beta*C on the packed vector cp of order A.rows()
+template<typename _Scalar,typename _MatrixType>
+void syrkTiles(_Scalar alpha,const _MatrixType& A,_Scalar beta,_Scalar* cp)
+{
+	typedef Eigen::Map< Eigen::Matrix<_Scalar,Eigen::Dynamic,Eigen::Dynamic,Eigen::RowMajor> > Tile;
+	packedTiles(A.rows(),alpha,beta,cp,
+		[&A](Eigen::Index r,Eigen::Index br,Eigen::Index c,Eigen::Index bc,Tile& T)
+		{
+			T.topLeftCorner(br,bc).noalias()=A.middleRows(r,br)*A.middleRows(c,bc).transpose();
+		});
+}
+
+//C = alpha*(A*B^T + B*A^T) + beta*C on the packed vector cp of order A.rows()
+template<typename _Scalar,typename _MatrixA,typename _MatrixB>
+void syr2kTiles(_Scalar alpha,const _MatrixA& A,const _MatrixB& B,_Scalar beta,_Scalar* cp)
+{
+	typedef Eigen::Map< Eigen::Matrix<_Scalar,Eigen::Dynamic,Eigen::Dynamic,Eigen::RowMajor> > Tile;
+	packedTiles(A.rows(),alpha,beta,cp,
+		[&A,&B](Eigen::Index r,Eigen::Index br,Eigen::Index c,Eigen::Index bc,Tile& T)
+		{
+			T.topLeftCorner(br,bc).noalias()=A.middleRows(r,br)*B.middleRows(c,bc).transpose();
+			T.topLeftCorner(br,bc).noalias()+=B.middleRows(r,br)*A.middleRows(c,bc).transpose();
+		});
+}
+
+} //namespace SymMatInternal
+
+//Rank-k update from an Eigen matrix(or expression)
+template<typename _Scalar,typename _Derived>
+void syrk(_Scalar alpha,const Eigen::MatrixBase<_Derived>& A,_Scalar beta,SymMat<_Scalar>& m1)
+{
+	SYMMAT_TRACE_OP("syrk",_Scalar,m1.order,m1.mat.size(),sizeof(_Scalar)*(m1.mat.size()+A.size()));
+	//An empty or differently sized C can only be overwritten
+	if(m1.order!=A.rows())
+	{
+		assert(beta==_Scalar(0));
+		m1=SymMat<_Scalar>(A.rows());
+	}
+	//Expressions are evaluated once, plain matrices are used directly
+	typename Eigen::internal::nested_eval<_Derived,2>::type a(A.derived());
+	SymMatInternal::syrkTiles(alpha,a,beta,m1.mat.data());
+}
+
+//Rank-k update from a row major array of rows x cols elements
+template<typename _Scalar>
+void syrk(_Scalar alpha,const _Scalar* A,int rows,int cols,_Scalar beta,SymMat<_Scalar>& m1)
+{
+	typedef Eigen::Map< const Eigen::Matrix<_Scalar,Eigen::Dynamic,Eigen::Dynamic,Eigen::RowMajor> > RowMajorMap;
+	syrk(alpha,RowMajorMap(A,rows,cols),beta,m1);
+}
+
+/**********************************************************************************************************
+						CHOLESKY FACTORIZATION
+					------------------------------
+For a symmetric positive definite matrix S = U^T*U, where U is upper triangular.
+U is stored in place of S in the packed vector(the same as LAPACK's pptrf with UPLO='L'), so the
+factorization needs no dense copy of the matrix. The rows of U are contiguous in the packed vector.
+
+cholesky(S)		factorizes S in place, returns 0 on success or k if the leading minor of order k
+				is not positive definite(like the info of LAPACK)
+cholsolve(U,B)		solves S*X=B in place of B(any number of right hand sides)
+cholinverse(U)		returns the inverse of S as a SymMat
+chollogdet(U)		log of the determinant of S(diagprod() overflows for large matrices)
+
+Efficiency improvement:-
+The factorization is blocked: a block of SYMMAT_CHOL_BLOCK rows is factorized, the rows right of it are
+solved with a triangular solve, and the rest of the matrix is updated by the rank-k update kernel(syrk),
+which does almost all the flops with Eigen's matrix product and shares the tiles between the threads.
+The rest of the matrix is itself a packed matrix of smaller order, so syrk writes directly into it.
+************************************************************************************************************/
+
+//Rows in each block of the factorization and of the solves
+#ifndef SYMMAT_CHOL_BLOCK
+#define SYMMAT_CHOL_BLOCK 128
+#endif
+
+namespace SymMatInternal
+{
+
+//Copies the upper part of rows r..r+rows-1, columns c..n-1(c<=r) of the packed matrix into/from
+//the row major array W of n-c columns. The elements of W below the diagonal are not used.
+template<typename _Scalar>
+void copyRows(Eigen::Index n,_Scalar* ap,Eigen::Index r,Eigen::Index rows,Eigen::Index c,_Scalar* W,bool topacked)
+{
+	const Eigen::Index cols=n-c;
+	for(Eigen::Index i=0;i<rows;i++)
+	{
+		_Scalar* row=ap+diagIndex(n,r+i);
+		_Scalar* w=W+i*cols+(r+i-c);
+		if(topacked)
+		{
+			std::copy(w,W+(i+1)*cols,row);
+		}
+		else
+		{
+			std::copy(row,row+(n-r-i),w);
+		}
+	}
+}
+
+//Unblocked factorization of the upper triangle of the dense row major block D(b x b)
+template<typename _Scalar>
+int cholBlock(_Scalar* D,Eigen::Index b)
+{
+	for(Eigen::Index k=0;k<b;k++)
+	{
+		_Scalar* rowk=D+k*b;
+		if(!(rowk[k]>_Scalar(0)))
+		{
+			return int(k+1);
+		}
+		rowk[k]=std::sqrt(rowk[k]);
+		const _Scalar inv=_Scalar(1)/rowk[k];
+		for(Eigen::Index j=k+1;j<b;j++)
+		{
+			rowk[j]*=inv;
+		}
+		for(Eigen::Index i=k+1;i<b;i++)
+		{
+			_Scalar* rowi=D+i*b;
+			const _Scalar u=rowk[i];
+			for(Eigen::Index j=i;j<b;j++)
+			{
+				rowi[j]-=u*rowk[j];
+			}
+		}
+	}
+	return 0;
+}
+
+template<typename _Scalar>
+int cholesky(Eigen::Index n,_Scalar* ap)
+{
+	typedef Eigen::Matrix<_Scalar,Eigen::Dynamic,Eigen::Dynamic,Eigen::RowMajor> RowMajorMatrix;
+	typedef Eigen::Map<RowMajorMatrix> RowMajorMap;
+	typedef Eigen::Map< Eigen::Matrix<_Scalar,Eigen::Dynamic,Eigen::Dynamic> > ColMajorMap;
+
+	const Eigen::Index nb=SYMMAT_CHOL_BLOCK;
+	std::vector<_Scalar> panel;
+
+	for(Eigen::Index k=0;k<n;k+=nb)
+	{
+		const Eigen::Index b=std::min(nb,n-k),m=k+b,r=n-m;
+
+		//Rows k..m-1 from the diagonal to the end
+		panel.resize(b*(n-k));
+		copyRows(n,ap,k,b,k,panel.data(),false);
+		RowMajorMap P(panel.data(),b,n-k);
+
+		//Diagonal block
+		RowMajorMatrix D=P.leftCols(b);
+		const int info=cholBlock(D.data(),b);
+		if(info)
+		{
+			return int(k)+info;
+		}
+		P.leftCols(b)=D;
+
+		//Rows right of the diagonal block: U12 = U11^-T * A12
+		if(r>0)
+		{
+			D.template triangularView<Eigen::Upper>().transpose().solveInPlace(P.rightCols(r));
+		}
+		copyRows(n,ap,k,b,k,panel.data(),true);
+
+		//Rest of the matrix: A22 -= U12^T*U12
+		if(r>0)
+		{
+			RowMajorMatrix W=P.rightCols(r);
+			syrkTiles(_Scalar(-1),ColMajorMap(W.data(),r,b),_Scalar(1),ap+diagIndex(n,m));
+		}
+	}
+	return 0;
+}
+
+//Solves U^T*U*X=B in place, B has n rows and any number of columns
+template<typename _Scalar,typename _MatrixB>
+void cholSolve(Eigen::Index n,const _Scalar* ap,_MatrixB& B)
+{
+	typedef Eigen::Matrix<_Scalar,Eigen::Dynamic,Eigen::Dynamic,Eigen::RowMajor> RowMajorMatrix;
+	const Eigen::Index nb=SYMMAT_CHOL_BLOCK,blocks=(n+nb-1)/nb;
+	RowMajorMatrix P;
+
+	//Forward: U^T*Y=B
+	for(Eigen::Index p=0;p<blocks;p++)
+	{
+		const Eigen::Index k=p*nb,b=std::min(nb,n-k),r=n-k-b;
+		P.resize(b,n-k);
+		copyRows(n,const_cast<_Scalar*>(ap),k,b,k,P.data(),false);
+		P.leftCols(b).template triangularView<Eigen::Upper>().transpose().solveInPlace(B.middleRows(k,b));
+		if(r>0)
+		{
+			B.bottomRows(r).noalias()-=P.rightCols(r).transpose()*B.middleRows(k,b);
+		}
+	}
+
+	//Backward: U*X=Y
+	for(Eigen::Index p=blocks-1;p>=0;p--)
+	{
+		const Eigen::Index k=p*nb,b=std::min(nb,n-k),r=n-k-b;
+		P.resize(b,n-k);
+		copyRows(n,const_cast<_Scalar*>(ap),k,b,k,P.data(),false);
+		if(r>0)
+		{
+			B.middleRows(k,b).noalias()-=P.rightCols(r)*B.bottomRows(r);
+		}
+		P.leftCols(b).template triangularView<Eigen::Upper>().solveInPlace(B.middleRows(k,b));
+	}
+}
+
+//Writes the inverse of U^T*U into the packed vector inv. The columns of the inverse are found in
+//blocks by solving with blocks of the identity matrix, the blocks are shared between the threads
+template<typename _Scalar>
+void cholInverse(Eigen::Index n,const _Scalar* ap,_Scalar* inv)
+{
+	typedef Eigen::Matrix<_Scalar,Eigen::Dynamic,Eigen::Dynamic> Matrix;
+	const Eigen::Index nb=SYMMAT_CHOL_BLOCK,blocks=(n+nb-1)/nb;
+
+#ifdef _OPENMP
+	#pragma omp parallel
+#endif
+	{
+		Matrix Y;
+
+#ifdef _OPENMP
+		#pragma omp for schedule(dynamic)
+#endif
+		for(Eigen::Index p=0;p<blocks;p++)
+		{
+			const Eigen::Index c=p*nb,b=std::min(nb,n-c);
+			Y.setZero(n,b);
+			Y.block(c,0,b,b).setIdentity();
+			cholSolve(n,ap,Y);
+
+			//Only the rows above the diagonal are stored
+			for(Eigen::Index i=0;i<c+b;i++)
+			{
+				const Eigen::Index first=std::max(Eigen::Index(0),i-c);
+				_Scalar* row=inv+diagIndex(n,i)+(c+first-i);
+				for(Eigen::Index j=first;j<b;j++)
+				{
+					row[j-first]=Y(i,j);
+				}
+			}
+		}
+	}
+}
+
+} //namespace SymMatInternal
+
+
+//Factorizes m1 in place, returns 0 or the order of the first leading minor which is not positive definite
+template<typename _Scalar>
+int cholesky(SymMat<_Scalar>& m1)
+{
+	SYMMAT_TRACE_OP("cholesky",_Scalar,m1.order,m1.mat.size(),sizeof(_Scalar)*m1.mat.size());
+	return SymMatInternal::cholesky(Eigen::Index(m1.order),m1.mat.data());
+}
+
+//Solves S*X=B in place of B, where u holds the factor of S
+template<typename _Scalar,int _Rows,int _Cols>
+void cholsolve(SymMat<_Scalar>& u,Eigen::Matrix<_Scalar,_Rows,_Cols>& B)
+{
+	SYMMAT_TRACE_OP("cholsolve",_Scalar,u.order,u.mat.size(),sizeof(_Scalar)*(u.mat.size()+2*B.size()));
+	assert(u.order==B.rows());       //Condition for the matrices to be conformable
+	SymMatInternal::cholSolve(Eigen::Index(u.order),u.mat.data(),B);
+}
+
+//Inverse of S, where u holds the factor of S
+template<typename _Scalar>
+SymMat<_Scalar> cholinverse(SymMat<_Scalar>& u)
 {
-public:
+	SYMMAT_TRACE_OP("cholinverse",_Scalar,u.order,2*u.mat.size(),2*sizeof(_Scalar)*u.mat.size());
+	SymMat<_Scalar> m3(u.order);
+	SymMatInternal::cholInverse(Eigen::Index(u.order),u.mat.data(),m3.mat.data());
+	return m3;
+}
 
-	//Order of the matrix
-	int order;
+//Log of the determinant of S, where u holds the factor of S
+template<typename _Scalar>
+_Scalar chollogdet(SymMat<_Scalar>& u)
+{
+	SYMMAT_TRACE_OP("chollogdet",_Scalar,u.order,u.order,sizeof(_Scalar)*u.order);
+	_Scalar store_logdet=0;
+	Eigen::Index diag=0;
+	for(int i=0;i<u.order;i++)
+	{
+		store_logdet+=std::log(u.mat[diag]);
+		diag+=u.order-i;
+	}
+	return 2*store_logdet;
+}
 
-	//Vector which stores the elements of the matrix
-	std::vector<_Scalar> mat;
-	
-	//Initializer list
-	SymMat(std::initializer_list<_Scalar>);
 
-	//Default constructor
-	SymMat();
+/**********************************************************************************************************
+						RANK-1 UPDATES
+					----------------------
+spr(alpha,x,S)			S = S + alpha*x*x^T
+spr2(alpha,x,y,S)		S = S + alpha*(x*y^T + y*x^T)
+cholupdate(U,x)			U^T*U = U^T*U + x*x^T, on the factor written by cholesky(in place)
+choldowndate(U,x)		U^T*U = U^T*U - x*x^T, returns 0 or k when the leading minor of order k of the
+					result is not positive definite(U is then not changed)
 
-	//Parametrized constructor(parameter is order of matrice)
-	SymMat(int);
-	
-	//Returns the index of the element (i,j) stored in the vector
-	int index(int,int);
-	
-	//Prints the matrix 
-	void print();
+(the rank-k update alpha*A*A^T + beta*S is syrk)
 
-	/***BASIC ARITHMETIC REDUCTION OPERATIONS*****/
-	//Sum of the elements
-	_Scalar sum();
+Efficiency improvement:-
+Row i of the packed vector is S(i,i..n-1), so S(i,j) += alpha*x(i)*x(j) is an axpy of x(i..n-1) into the
+row: the packed vector is read and written once, in storage order, with the vector kernels. The rows are
+shared between the threads like in spmv for large orders.
+
+The factor is updated in O(n^2) instead of factorizing again in O(n^3), with the Givens rotations of
+LINPACK's dchud/dchdd applied row by row: row i of U and the vector x(i..n-1) are rotated together, which is
+a single pass over the packed row. The downdate first solves U^T*a = x(an axpy per row) and fails when
+|a| >= 1, so that a matrix which is no longer positive definite is found before U is changed.
+************************************************************************************************************/
 
-	//Returns the mean of elements
-	_Scalar mean();
+namespace SymMatInternal
+{
 
-	//Trace of matrix
-	_Scalar trace();
+//y(0..n-1) += a*x(0..n-1)
+template<typename _Scalar>
+void axpyScalar(_Scalar* y,const _Scalar* x,Eigen::Index n,_Scalar a)
+{
+	for(Eigen::Index k=0;k<n;k++)
+	{
+		y[k]+=a*x[k];
+	}
+}
 
-	//Returns the minimum coefficient of the matrix
-	_Scalar minCoeff();
+//y(0..n-1) += a*x(0..n-1) + b*z(0..n-1)
+template<typename _Scalar>
+void axpy2Scalar(_Scalar* y,const _Scalar* x,const _Scalar* z,Eigen::Index n,_Scalar a,_Scalar b)
+{
+	for(Eigen::Index k=0;k<n;k++)
+	{
+		y[k]+=a*x[k]+b*z[k];
+	}
+}
 
-	//Returns the maximum coefficient of the matrix
-	_Scalar maxCoeff();
+//Givens rotation of two vectors: (u,v) = (c*u + s*v, c*v - s*u)
+template<typename _Scalar>
+void rotScalar(_Scalar* u,_Scalar* v,Eigen::Index n,_Scalar c,_Scalar s)
+{
+	for(Eigen::Index k=0;k<n;k++)
+	{
+		const _Scalar uk=u[k];
+		u[k]=c*uk+s*v[k];
+		v[k]=c*v[k]-s*uk;
+	}
+}
 
-	/***ADDITIONAL FUNCTIONS***********/
-	//No.of elements stored in the classical packed format
-	int elemstored();
+#define SYMMAT_VECTOR_UPDATES(SUFFIX,ATTR,T,VEC,W,LOADU,STOREU,SET1,FMA,MUL)			\
+ATTR inline void axpy##SUFFIX(T* y,const T* x,Eigen::Index n,T a)						\
+{																					\
+	VEC va=SET1(a);																	\
+	Eigen::Index k=0;																\
+	for(;k+(W)<=n;k+=(W))															\
+	{																				\
+		STOREU(y+k,FMA(LOADU(x+k),va,LOADU(y+k)));									\
+	}																				\
+	axpyScalar(y+k,x+k,n-k,a);														\
+}																					\
+ATTR inline void axpy2##SUFFIX(T* y,const T* x,const T* z,Eigen::Index n,T a,T b)		\
+{																					\
+	VEC va=SET1(a),vb=SET1(b);														\
+	Eigen::Index k=0;																\
+	for(;k+(W)<=n;k+=(W))															\
+	{																				\
+		STOREU(y+k,FMA(LOADU(z+k),vb,FMA(LOADU(x+k),va,LOADU(y+k))));				\
+	}																				\
+	axpy2Scalar(y+k,x+k,z+k,n-k,a,b);												\
+}																					\
+ATTR inline void rot##SUFFIX(T* u,T* v,Eigen::Index n,T c,T s)						\
+{																					\
+	VEC vc=SET1(c),vs=SET1(s),vms=SET1(-s);											\
+	Eigen::Index k=0;																\
+	for(;k+(W)<=n;k+=(W))															\
+	{																				\
+		VEC uk=LOADU(u+k),vk=LOADU(v+k);											\
+		STOREU(u+k,FMA(vk,vs,MUL(uk,vc)));											\
+		STOREU(v+k,FMA(uk,vms,MUL(vk,vc)));											\
+	}																				\
+	rotScalar(u+k,v+k,n-k,c,s);														\
+}
 
-	//Product of the diagonal elements
-	_Scalar diagprod();
+#if defined(SYMMAT_X86_DISPATCH)
+SYMMAT_VECTOR_UPDATES(Avx2,SYMMAT_AVX2,float,__m256,8,_mm256_loadu_ps,_mm256_storeu_ps,_mm256_set1_ps,_mm256_fmadd_ps,_mm256_mul_ps)
+SYMMAT_VECTOR_UPDATES(Avx2,SYMMAT_AVX2,double,__m256d,4,_mm256_loadu_pd,_mm256_storeu_pd,_mm256_set1_pd,_mm256_fmadd_pd,_mm256_mul_pd)
+SYMMAT_VECTOR_UPDATES(Avx512,SYMMAT_AVX512,float,__m512,16,_mm512_loadu_ps,_mm512_storeu_ps,_mm512_set1_ps,_mm512_fmadd_ps,_mm512_mul_ps)
+SYMMAT_VECTOR_UPDATES(Avx512,SYMMAT_AVX512,double,__m512d,8,_mm512_loadu_pd,_mm512_storeu_pd,_mm512_set1_pd,_mm512_fmadd_pd,_mm512_mul_pd)
+
+#define SYMMAT_UPDATE_DISPATCH(T)																	\
+template<> inline void axpy<T>(T* y,const T* x,Eigen::Index n,T a)									\
+{																									\
+	switch(simdLevel())																				\
+	{																								\
+		case SimdAvx512: axpyAvx512(y,x,n,a); break;												\
+		case SimdAvx2:   axpyAvx2(y,x,n,a); break;													\
+		default:         axpyScalar(y,x,n,a);														\
+	}																								\
+}																									\
+template<> inline void axpy2<T>(T* y,const T* x,const T* z,Eigen::Index n,T a,T b)					\
+{																									\
+	switch(simdLevel())																				\
+	{																								\
+		case SimdAvx512: axpy2Avx512(y,x,z,n,a,b); break;											\
+		case SimdAvx2:   axpy2Avx2(y,x,z,n,a,b); break;												\
+		default:         axpy2Scalar(y,x,z,n,a,b);													\
+	}																								\
+}																									\
+template<> inline void rot<T>(T* u,T* v,Eigen::Index n,T c,T s)									\
+{																									\
+	switch(simdLevel())																				\
+	{																								\
+		case SimdAvx512: rotAvx512(u,v,n,c,s); break;												\
+		case SimdAvx2:   rotAvx2(u,v,n,c,s); break;													\
+		default:         rotScalar(u,v,n,c,s);														\
+	}																								\
+}
+#elif defined(SYMMAT_HAVE_NEON)
+#define SYMMAT_NEON_FMA32(a,b,c) vmlaq_f32(c,a,b)
+SYMMAT_VECTOR_UPDATES(Neon,,float,float32x4_t,4,vld1q_f32,vst1q_f32,vdupq_n_f32,SYMMAT_NEON_FMA32,vmulq_f32)
+#undef SYMMAT_NEON_FMA32
+#endif
+#undef SYMMAT_VECTOR_UPDATES
+
+//Generic types use the portable kernels, float and double are dispatched like the reductions
+template<typename _Scalar>
+void axpy(_Scalar* y,const _Scalar* x,Eigen::Index n,_Scalar a) { axpyScalar(y,x,n,a); }
 
-	//Product of the elements of the matrix
-	_Scalar prod();
+template<typename _Scalar>
+void axpy2(_Scalar* y,const _Scalar* x,const _Scalar* z,Eigen::Index n,_Scalar a,_Scalar b) { axpy2Scalar(y,x,z,n,a,b); }
 
-	//Transpose function
-	//SymMat transpose();
+template<typename _Scalar>
+void rot(_Scalar* u,_Scalar* v,Eigen::Index n,_Scalar c,_Scalar s) { rotScalar(u,v,n,c,s); }
+
+#if defined(SYMMAT_X86_DISPATCH)
+SYMMAT_UPDATE_DISPATCH(float)
+SYMMAT_UPDATE_DISPATCH(double)
+#undef SYMMAT_UPDATE_DISPATCH
+#elif defined(SYMMAT_HAVE_NEON)
+template<> inline void axpy<float>(float* y,const float* x,Eigen::Index n,float a) { axpyNeon(y,x,n,a); }
+template<> inline void axpy2<float>(float* y,const float* x,const float* z,Eigen::Index n,float a,float b) { axpy2Neon(y,x,z,n,a,b); }
+template<> inline void rot<float>(float* u,float* v,Eigen::Index n,float c,float s) { rotNeon(u,v,n,c,s); }
+#endif
+
+//S = S + alpha*x*x^T(y==0) or S + alpha*(x*y^T + y*x^T) on rows first..last-1 of the packed matrix of order n
+template<typename _Scalar>
+void sprRows(Eigen::Index n,Eigen::Index first,Eigen::Index last,_Scalar alpha,const _Scalar* x,const _Scalar* y,_Scalar* ap)
+{
+	for(Eigen::Index i=first;i<last;i++)
+	{
+		_Scalar* row=ap+diagIndex(n,i);
+		if(y)
+		{
+			axpy2(row,x+i,y+i,n-i,alpha*y[i],alpha*x[i]);
+		}
+		else
+		{
+			axpy(row,x+i,n-i,alpha*x[i]);
+		}
+	}
+}
 
-	//Overloading the funtion call operator
-	_Scalar& operator()(int,int);
+//The rows are shared between the threads with the same no. of elements each
+template<typename _Scalar>
+void spr(Eigen::Index n,_Scalar alpha,const _Scalar* x,const _Scalar* y,_Scalar* ap)
+{
+#ifdef _OPENMP
+	int threads=omp_get_max_threads();
+	if(n>=SYMMAT_PARALLEL_THRESHOLD && threads>1 && !omp_in_parallel())
+	{
+		//Like spmv, the other threads use the bounds of this thread through the pointer
+		static thread_local std::vector<Eigen::Index> bounds;
+		splitRows(n,threads,bounds);
+		const Eigen::Index* bound=bounds.data();
 
-};
+		#pragma omp parallel num_threads(threads)
+		{
+			//Every range is taken by some thread, also when the team is smaller than asked for
+			for(int t=omp_get_thread_num();t<threads;t+=omp_get_num_threads())
+			{
+				sprRows(n,bound[t],bound[t+1],alpha,x,y,ap);
+			}
+		}
+		return;
+	}
+#endif
+	sprRows(n,Eigen::Index(0),n,alpha,x,y,ap);
+}
 
-/***************************************************************************************************
-						FUNCTION PROTOTYPES
-						-------------------
-This section contains the prototypes of the functions used:-
-****************************************************************************************************/
+//U^T*U + x*x^T on the factor U, x is overwritten
+template<typename _Scalar>
+void cholUpdate(Eigen::Index n,_Scalar* ap,_Scalar* x)
+{
+	for(Eigen::Index i=0;i<n;i++)
+	{
+		//The rotation of (U(i,i),x(i)) which makes x(i) zero
+		_Scalar* row=ap+diagIndex(n,i);
+		const _Scalar r=std::hypot(row[0],x[i]);
+		if(r==_Scalar(0))
+		{
+			continue;
+		}
+		rot(row,x+i,n-i,row[0]/r,x[i]/r);
+	}
+}
 
-//Addition------------------------------------------------------------------------------------------
+//U^T*U - x*x^T on the factor U, returns 0 or the order of the first leading minor which is not positive
+//definite(U is then unchanged). x is overwritten
 template<typename _Scalar>
-SymMat<_Scalar> add(SymMat<_Scalar>&,SymMat<_Scalar>&);
+int cholDowndate(Eigen::Index n,_Scalar* ap,_Scalar* x)
+{
+	//U^T*a = x, row by row: a(i) is found and its part of the rest of x is removed
+	_Scalar norm=0;
+	for(Eigen::Index i=0;i<n;i++)
+	{
+		const _Scalar* row=ap+diagIndex(n,i);
+		x[i]/=row[0];
+		norm+=x[i]*x[i];
+		if(!(norm<_Scalar(1)))
+		{
+			return int(i)+1;
+		}
+		axpy(x+i+1,row+1,n-i-1,-x[i]);
+	}
 
-template<typename _Scalar,int _Rows, int _Cols>
-Eigen::Matrix<_Scalar,_Rows,_Cols> add(SymMat<_Scalar>&,Eigen::Matrix<_Scalar,_Rows,_Cols>&);
+	//Rotations from the last row to the first, which make a zero with alpha = sqrt(1-|a|^2)
+	_Scalar alpha=std::sqrt(_Scalar(1)-norm);
+	_Scalar* c=scratch<_Scalar,ScratchRow>(size_t(n));
+	for(Eigen::Index i=n-1;i>=0;i--)
+	{
+		const _Scalar r=std::hypot(alpha,x[i]);
+		c[i]=alpha/r;
+		x[i]/=r;
+		alpha=r;
+	}
 
-template<typename _Scalar,int _Rows, int _Cols>
-Eigen::Matrix<_Scalar,_Rows,_Cols> add(Eigen::Matrix<_Scalar,_Rows,_Cols>&,SymMat<_Scalar>&);
+	//Applied to the rows of U, with the row v which starts as zero
+	_Scalar* v=scratch<_Scalar,ScratchPartial>(size_t(n));
+	std::fill(v,v+n,_Scalar(0));
+	for(Eigen::Index i=n-1;i>=0;i--)
+	{
+		rot(ap+diagIndex(n,i),v+i,n-i,c[i],-x[i]);
+	}
+	return 0;
+}
 
+} //namespace SymMatInternal
 
-//Subtraction----------------------------------------------------------------------------------------
+//S = S + alpha*x*x^T on Eigen vectors
+template<typename _Scalar,int _Rows>
+void spr(_Scalar alpha,const Eigen::Matrix<_Scalar,_Rows,1>& x,SymMat<_Scalar>& m1)
+{
+	SYMMAT_TRACE_OP("spr",_Scalar,m1.order,m1.mat.size(),sizeof(_Scalar)*(2*m1.mat.size()+m1.order));
+	assert(m1.order==x.rows());       //Condition for the matrix and the vector to be conformable
+	SymMatInternal::spr(Eigen::Index(m1.order),alpha,x.data(),static_cast<const _Scalar*>(0),m1.mat.data());
+}
+
+//S = S + alpha*x*x^T on a raw array of length m1.order
 template<typename _Scalar>
-SymMat<_Scalar> sub(SymMat<_Scalar>&,SymMat<_Scalar>&);
+void spr(_Scalar alpha,const _Scalar* x,SymMat<_Scalar>& m1)
+{
+	SYMMAT_TRACE_OP("spr",_Scalar,m1.order,m1.mat.size(),sizeof(_Scalar)*(2*m1.mat.size()+m1.order));
+	SymMatInternal::spr(Eigen::Index(m1.order),alpha,x,static_cast<const _Scalar*>(0),m1.mat.data());
+}
 
-template<typename _Scalar,int _Rows, int _Cols>
-Eigen::Matrix<_Scalar,_Rows,_Cols> sub(SymMat<_Scalar>&,Eigen::Matrix<_Scalar,_Rows,_Cols>&);
+//S = S + alpha*(x*y^T + y*x^T) on Eigen vectors
+template<typename _Scalar,int _Rows>
+void spr2(_Scalar alpha,const Eigen::Matrix<_Scalar,_Rows,1>& x,const Eigen::Matrix<_Scalar,_Rows,1>& y,SymMat<_Scalar>& m1)
+{
+	SYMMAT_TRACE_OP("spr2",_Scalar,m1.order,m1.mat.size(),sizeof(_Scalar)*(2*m1.mat.size()+2*m1.order));
+	assert(m1.order==x.rows() && m1.order==y.rows());       //Condition for the matrix and the vectors to be conformable
+	SymMatInternal::spr(Eigen::Index(m1.order),alpha,x.data(),y.data(),m1.mat.data());
+}
 
-template<typename _Scalar,int _Rows, int _Cols>
-Eigen::Matrix<_Scalar,_Rows,_Cols> sub(Eigen::Matrix<_Scalar,_Rows,_Cols>&,SymMat<_Scalar>&);
+//S = S + alpha*(x*y^T + y*x^T) on raw arrays of length m1.order
+template<typename _Scalar>
+void spr2(_Scalar alpha,const _Scalar* x,const _Scalar* y,SymMat<_Scalar>& m1)
+{
+	SYMMAT_TRACE_OP("spr2",_Scalar,m1.order,m1.mat.size(),sizeof(_Scalar)*(2*m1.mat.size()+2*m1.order));
+	SymMatInternal::spr(Eigen::Index(m1.order),alpha,x,y,m1.mat.data());
+}
 
+//Updates the factor u of S to the factor of S + x*x^T
+template<typename _Scalar,int _Rows>
+void cholupdate(SymMat<_Scalar>& u,const Eigen::Matrix<_Scalar,_Rows,1>& x)
+{
+	SYMMAT_TRACE_OP("cholupdate",_Scalar,u.order,u.mat.size(),2*sizeof(_Scalar)*u.mat.size());
+	assert(u.order==x.rows());       //Condition for the matrix and the vector to be conformable
+	_Scalar* w=SymMatInternal::scratch<_Scalar,SymMatInternal::ScratchDenseRow>(size_t(u.order));
+	std::copy(x.data(),x.data()+u.order,w);
+	SymMatInternal::cholUpdate(Eigen::Index(u.order),u.mat.data(),w);
+}
 
-//Multiplication--------------------------------------------------------------------------------------
-template<typename _Scalar,int _Rows, int _Cols>
-Eigen::Matrix<_Scalar,_Rows,_Cols> mult(SymMat<_Scalar>&,SymMat<_Scalar>&);
+//Updates the factor u of S to the factor of S - x*x^T, returns 0 or the order of the first leading minor of
+//S - x*x^T which is not positive definite(like cholesky), in which case u is not changed
+template<typename _Scalar,int _Rows>
+int choldowndate(SymMat<_Scalar>& u,const Eigen::Matrix<_Scalar,_Rows,1>& x)
+{
+	SYMMAT_TRACE_OP("choldowndate",_Scalar,u.order,u.mat.size(),3*sizeof(_Scalar)*u.mat.size());
+	assert(u.order==x.rows());       //Condition for the matrix and the vector to be conformable
+	_Scalar* w=SymMatInternal::scratch<_Scalar,SymMatInternal::ScratchDenseRow>(size_t(u.order));
+	std::copy(x.data(),x.data()+u.order,w);
+	return SymMatInternal::cholDowndate(Eigen::Index(u.order),u.mat.data(),w);
+}
 
-template<typename _Scalar,int _Rows, int _Cols>
-Eigen::Matrix<_Scalar,_Rows,_Cols> mult(SymMat<_Scalar>&,Eigen::Matrix<_Scalar,_Rows,_Cols>&);
+/**********************************************************************************************************
+						EIGENVALUES AND EIGENVECTORS
+					------------------------------------
+eigenvalues(S,values)				only the eigenvalues(in increasing order)
+eigenvectors(S,values,vectors)		eigenvalues and the eigenvectors as the columns of vectors
+
+Both return 0, or k if the k-th eigenvalue did not converge. They work on a copy of the packed vector,
+unless inplace is true, in which case S is overwritten(saves the memory of the copy).
+
+How it works:-
+1)S is reduced to a tridiagonal matrix T = Q^T*S*Q with Householder reflections, directly on the packed
+  vector. The reflections are done in blocks of SYMMAT_EIG_BLOCK columns(like LAPACK's sytrd): inside
+  a block only the columns of the block are updated, and the rest of the matrix is updated once per
+  block with the rank-2k kernel(A22 -= V*W^T + W*V^T), which does most of the flops as matrix products.
+  The matrix-vector product needed for every reflection is the packed spmv, so both are multithreaded.
+2)The eigenvalues of T are found by the implicit QL method with Wilkinson shifts. Without eigenvectors
+  this is only O(n^2).
+3)For the eigenvectors, the rotations of every QL sweep are applied to the rows of the eigenvector
+  matrix in parallel, and at the end the reflections are applied in blocks(compact WY form,
+  I - V*T*V^T) with matrix products.
+************************************************************************************************************/
 
-template<typename _Scalar,int _Rows, int _Cols>
-Eigen::Matrix<_Scalar,_Rows,_Cols> mult(Eigen::Matrix<_Scalar,_Rows,_Cols>&,SymMat<_Scalar>&);
+//Columns in each block of the reduction and of the back transformation
+#ifndef SYMMAT_EIG_BLOCK
+#define SYMMAT_EIG_BLOCK 32
+#endif
 
+namespace SymMatInternal
+{
 
+/*
+Reduces the packed matrix of order n to tridiagonal form: d is the diagonal, e the off-diagonal.
+Reflection i(H = I - tau(i)*v*v^T, v(0)=1) acts on rows i+1..n-1 and v is kept in row i of the packed
+vector from column i+1.
+*/
+template<typename _Scalar>
+void tridiagonalize(Eigen::Index n,_Scalar* ap,_Scalar* d,_Scalar* e,_Scalar* tau)
+{
+	typedef Eigen::Matrix<_Scalar,Eigen::Dynamic,Eigen::Dynamic> Matrix;
+	typedef Eigen::Matrix<_Scalar,Eigen::Dynamic,1> Vector;
+	const Eigen::Index nb=SYMMAT_EIG_BLOCK;
+	Matrix V,W;
+	Vector t;
 
-/*****************************************************************************************************
-						CONSTRUCTOR
-******************************************************************************************************/
+	for(Eigen::Index k=0;k<n;k+=nb)
+	{
+		const Eigen::Index nn=n-k,b=std::min(nb,nn);
 
-//Initialize with a default 3x3 matrix initialised with '0'
+		//Columns k..k+b-1 below the diagonal(rows k..k+b-1 of the packed vector)
+		V.setZero(nn,b);
+		W.setZero(nn,b);
+		for(Eigen::Index j=0;j<b;j++)
+		{
+			const _Scalar* row=ap+diagIndex(n,k+j);
+			std::copy(row,row+(nn-j),&V(j,j));
+		}
+
+		for(Eigen::Index i=0;i<b;i++)
+		{
+			const Eigen::Index m=nn-i-1;
+
+			//Updates column i with the reflections done before in this block
+			if(i>0)
+			{
+				V.col(i).tail(nn-i).noalias()-=V.block(i,0,nn-i,i)*W.row(i).head(i).transpose();
+				V.col(i).tail(nn-i).noalias()-=W.block(i,0,nn-i,i)*V.row(i).head(i).transpose();
+			}
+			d[k+i]=V(i,i);
+			if(m==0)
+			{
+				tau[k+i]=0;
+				break;
+			}
+
+			//Reflection which makes the column zero below the off-diagonal element
+			const _Scalar alpha=V(i+1,i);
+			const _Scalar xnorm= m>1 ? V.col(i).tail(m-1).norm() : _Scalar(0);
+			if(xnorm==_Scalar(0))
+			{
+				tau[k+i]=0;
+				e[k+i]=alpha;
+			}
+			else
+			{
+				_Scalar beta=std::sqrt(alpha*alpha+xnorm*xnorm);
+				beta= alpha>=_Scalar(0) ? -beta : beta;
+				tau[k+i]=(beta-alpha)/beta;
+				V.col(i).tail(m-1)*=_Scalar(1)/(alpha-beta);
+				e[k+i]=beta;
+			}
+			V(i+1,i)=1;
+
+			//w = tau*(A - V*W^T - W*V^T)*v, where A is the rest of the matrix not yet updated in this block
+			Eigen::Ref<Vector> v=V.col(i).tail(m);
+			Eigen::Ref<Vector> w=W.col(i).tail(m);
+			spmv(m,_Scalar(1),ap+diagIndex(n,k+i+1),v.data(),_Scalar(0),w.data());
+			if(i>0)
+			{
+				t.noalias()=W.block(i+1,0,m,i).transpose()*v;
+				w.noalias()-=V.block(i+1,0,m,i)*t;
+				t.noalias()=V.block(i+1,0,m,i).transpose()*v;
+				w.noalias()-=W.block(i+1,0,m,i)*t;
+			}
+			w*=tau[k+i];
+			w+=(_Scalar(-0.5)*tau[k+i]*w.dot(v))*v;
+		}
+
+		//Keeps the reflections in the packed rows of the block
+		for(Eigen::Index j=0;j<b;j++)
+		{
+			_Scalar* row=ap+diagIndex(n,k+j);
+			std::copy(&V(j,j),&V(j,j)+(nn-j),row);
+		}
+
+		//Rest of the matrix: A22 -= V*W^T + W*V^T
+		if(nn>b)
+		{
+			syr2kTiles(_Scalar(-1),V.bottomRows(nn-b),W.bottomRows(nn-b),_Scalar(1),ap+diagIndex(n,k+b));
+		}
+	}
+}
+
+//Applies the rotations of one QL sweep(rows of Z, columns i and i+1 for i=last-1 down to first)
 template<typename _Scalar>
-SymMat<_Scalar>::SymMat()
+void applyRotations(Eigen::Matrix<_Scalar,Eigen::Dynamic,Eigen::Dynamic>& Z,Eigen::Index first,Eigen::Index last,const _Scalar* c,const _Scalar* s)
 {
-	int elements,i;
-	order=3;
-	elements=6;
-	mat.resize(elements);
-	std::fill(mat.begin(),mat.end(),0); //filling all elements of the vector with '0'
+	const Eigen::Index rows=Z.rows(),chunk=256,chunks=(rows+chunk-1)/chunk;
+
+#ifdef _OPENMP
+	#pragma omp parallel for schedule(static) if(rows>=SYMMAT_PARALLEL_THRESHOLD)
+#endif
+	for(Eigen::Index p=0;p<chunks;p++)
+	{
+		const Eigen::Index r0=p*chunk,r1=std::min(rows,r0+chunk);
+		for(Eigen::Index i=last-1;i>=first;i--)
+		{
+			_Scalar* zi=&Z(0,i);
+			_Scalar* zi1=&Z(0,i+1);
+			for(Eigen::Index r=r0;r<r1;r++)
+			{
+				const _Scalar f=zi1[r];
+				zi1[r]=s[i]*zi[r]+c[i]*f;
+				zi[r]=c[i]*zi[r]-s[i]*f;
+			}
+		}
+	}
 }
 
-//Custom matrice of order as inputted by user intialised with '0'
+//Implicit QL on the tridiagonal matrix(d,e), e(i) couples i and i+1. Z(if not null) is rotated
 template<typename _Scalar>
-SymMat<_Scalar>::SymMat(int o)
+int tridiagonalQL(Eigen::Index n,_Scalar* d,_Scalar* e,Eigen::Matrix<_Scalar,Eigen::Dynamic,Eigen::Dynamic>* Z)
 {
-	int elements;
-	order=o;
-	elements=(order*(order+1))/2;
-	mat.resize(elements);
-	std::fill(mat.begin(),mat.end(),0); //filling all elements of the vector with '0'
+	const _Scalar eps=std::numeric_limits<_Scalar>::epsilon();
+	std::vector<_Scalar> c(n),s(n);
+	if(n>0)
+	{
+		e[n-1]=0;
+	}
+
+	for(Eigen::Index l=0;l<n;l++)
+	{
+		int iter=0;
+		Eigen::Index m;
+		do
+		{
+			//Looks for a small off-diagonal element which splits the matrix
+			for(m=l;m<n-1;m++)
+			{
+				const _Scalar dd=std::abs(d[m])+std::abs(d[m+1]);
+				if(std::abs(e[m])<=eps*dd)
+				{
+					break;
+				}
+			}
+			if(m==l)
+			{
+				break;
+			}
+			if(iter++==30)
+			{
+				return int(l+1);
+			}
+
+			//Wilkinson shift
+			_Scalar g=(d[l+1]-d[l])/(2*e[l]);
+			_Scalar r=std::sqrt(g*g+1);
+			g=d[m]-d[l]+e[l]/(g+(g>=0 ? r : -r));
+			_Scalar sn=1,cs=1,p=0;
+			Eigen::Index i;
+			for(i=m-1;i>=l;i--)
+			{
+				const _Scalar f=sn*e[i],b=cs*e[i];
+				r=std::sqrt(f*f+g*g);
+				e[i+1]=r;
+				if(r==_Scalar(0))
+				{
+					//Underflow, the sweep is restarted
+					d[i+1]-=p;
+					e[m]=0;
+					break;
+				}
+				sn=f/r;
+				cs=g/r;
+				g=d[i+1]-p;
+				r=(d[i]-g)*sn+2*cs*b;
+				p=sn*r;
+				d[i+1]=g+p;
+				g=cs*r-b;
+				c[i]=cs;
+				s[i]=sn;
+			}
+			if(Z)
+			{
+				applyRotations(*Z,i+1,m,c.data(),s.data());
+			}
+			if(r==_Scalar(0) && i>=l)
+			{
+				continue;
+			}
+			d[l]-=p;
+			e[l]=g;
+			e[m]=0;
+		}while(m!=l);
+	}
+	return 0;
 }
 
-//Using initializer_list to initialize the matrice
+//Z = Q*Z, where Q is the product of the reflections kept by tridiagonalize()
 template<typename _Scalar>
-SymMat<_Scalar>::SymMat(std::initializer_list<_Scalar> list) :mat(list) 
+void applyReflections(Eigen::Index n,const _Scalar* ap,const _Scalar* tau,Eigen::Matrix<_Scalar,Eigen::Dynamic,Eigen::Dynamic>& Z)
 {
-	/*First it is checked whether the number of elements entered are equal to the elements in
-	  the upper triangle of a square matrix.	
-	  Since the the no. of elements follow the following series:- 3(for 2x2),6(for 3x3),10(for 4x4),... 
-	  the following formula is used to calculate the order of the matrix and whether such an order exist:-
-	  -----------------------------------
-	  no.of elements=(order*(order+1))/2 
-	  (Sum of arithmetic series:- 1,2,3,4...)
-	  -----------------------------------
-	  */
-	order=int(sqrt(2*(mat.size())));
-	try
+	typedef Eigen::Matrix<_Scalar,Eigen::Dynamic,Eigen::Dynamic> Matrix;
+	const Eigen::Index nb=SYMMAT_EIG_BLOCK,count=n-1;
+	if(count<=0)
+	{
+		return;
+	}
+	const Eigen::Index blocks=(count+nb-1)/nb;
+	Matrix V,T,VZ;
+
+	//Q = H(0)*H(1)*...*H(n-2), so the last block is applied first
+	for(Eigen::Index p=blocks-1;p>=0;p--)
 	{
-		if((order*(order+1))/2!=mat.size())
+		const Eigen::Index k=p*nb,b=std::min(nb,count-k),rows=n-k-1;
+
+		//V(j,j)=1 and reflection j acts on rows k+j+1 and below
+		V.setZero(rows,b);
+		for(Eigen::Index j=0;j<b;j++)
 		{
-			throw 'f';	
+			const _Scalar* row=ap+diagIndex(n,k+j)+1;
+			std::copy(row,row+(rows-j),&V(j,j));
+			V(j,j)=1;
 		}
-		
+
+		//H(k)*...*H(k+b-1) = I - V*T*V^T
+		T.setZero(b,b);
+		for(Eigen::Index j=0;j<b;j++)
+		{
+			T(j,j)=tau[k+j];
+			if(j>0)
+			{
+				Eigen::Matrix<_Scalar,Eigen::Dynamic,1> vv=-tau[k+j]*(V.leftCols(j).transpose()*V.col(j));
+				T.col(j).head(j).noalias()=T.topLeftCorner(j,j).template triangularView<Eigen::Upper>()*vv;
+			}
+		}
+
+		VZ.noalias()=V.transpose()*Z.bottomRows(rows);
+		VZ=T.template triangularView<Eigen::Upper>()*VZ;
+		Z.bottomRows(rows).noalias()-=V*VZ;
 	}
-	catch(char& check)
+}
+
+//Sorts the eigenvalues in increasing order, together with the eigenvectors
+template<typename _Scalar>
+void sortEigen(Eigen::Matrix<_Scalar,Eigen::Dynamic,1>& values,Eigen::Matrix<_Scalar,Eigen::Dynamic,Eigen::Dynamic>* vectors)
+{
+	const Eigen::Index n=values.size();
+	for(Eigen::Index i=0;i<n-1;i++)
 	{
-		std::cout<<"Wrong number of elements for a upper triangle of square matrix!\nTerminating the program..."<<std::endl;
-		std::exit(0);
+		Eigen::Index k;
+		values.segment(i,n-i).minCoeff(&k);
+		if(k>0)
+		{
+			std::swap(values[i],values[k+i]);
+			if(vectors)
+			{
+				vectors->col(i).swap(vectors->col(k+i));
+			}
+		}
 	}
-	
 }
 
-/*******************************************************************************************************
-						OVERLOADING FUNCTION CALL OPERATOR
-********************************************************************************************************/
 template<typename _Scalar>
-_Scalar& SymMat<_Scalar>::operator()(int i, int j)
+int symmetricEigen(Eigen::Index n,_Scalar* ap,Eigen::Matrix<_Scalar,Eigen::Dynamic,1>& values,Eigen::Matrix<_Scalar,Eigen::Dynamic,Eigen::Dynamic>* vectors)
 {
-	if(i>=j)
+	std::vector<_Scalar> e(n+1),tau(n+1);
+	values.resize(n);
+	tridiagonalize(n,ap,values.data(),e.data(),tau.data());
+
+	if(vectors)
 	{
-		return mat[index(i,j)];
+		vectors->setIdentity(n,n);
 	}
-	else
+	const int info=tridiagonalQL(n,values.data(),e.data(),vectors);
+	if(vectors)
+	{
+		applyReflections(n,ap,tau.data(),*vectors);
+	}
+	sortEigen(values,vectors);
+	return info;
+}
+
+} //namespace SymMatInternal
+
+
+//Eigenvalues of m1 in increasing order
+template<typename _Scalar>
+int eigenvalues(SymMat<_Scalar>& m1,Eigen::Matrix<_Scalar,Eigen::Dynamic,1>& values,bool inplace)
+{
+	SYMMAT_TRACE_OP("eigenvalues",_Scalar,m1.order,m1.mat.size(),sizeof(_Scalar)*m1.mat.size());
+	if(inplace)
 	{
-		//Since the matrix is symmetric, it means that A(i,j)==A(j,i)
-		return mat[index(j,i)];
+		return SymMatInternal::symmetricEigen(Eigen::Index(m1.order),m1.mat.data(),values,(Eigen::Matrix<_Scalar,Eigen::Dynamic,Eigen::Dynamic>*)0);
 	}
-
+	std::vector<_Scalar> work(m1.mat.begin(),m1.mat.end());
+	return SymMatInternal::symmetricEigen(Eigen::Index(m1.order),work.data(),values,(Eigen::Matrix<_Scalar,Eigen::Dynamic,Eigen::Dynamic>*)0);
 }
 
-/********************************************************************************************************
-				CALCULATES THE INDEX OF ELEMENT AT (i,j) IN VECTOR
-*********************************************************************************************************/
+//Eigenvalues of m1 in increasing order and the eigenvectors(columns of vectors) in the same order
 template<typename _Scalar>
-int SymMat<_Scalar>::index(int i, int j)
+int eigenvectors(SymMat<_Scalar>& m1,Eigen::Matrix<_Scalar,Eigen::Dynamic,1>& values,Eigen::Matrix<_Scalar,Eigen::Dynamic,Eigen::Dynamic>& vectors,bool inplace)
 {
-	//to make calculations easy to understand (since the index starts from 0)
-	i=i+1;
-	j=j+1;
-
-	int Index,total_elements,below_elements,temp;
-	if(i>j)  //swapping i and j since the 
+	SYMMAT_TRACE_OP("eigenvectors",_Scalar,m1.order,m1.mat.size(),sizeof(_Scalar)*(m1.mat.size()+Eigen::Index(m1.order)*m1.order));
+	if(inplace)
 	{
-		temp=i;
-		i=j;
-		j=temp;
+		return SymMatInternal::symmetricEigen(Eigen::Index(m1.order),m1.mat.data(),values,&vectors);
 	}
+	std::vector<_Scalar> work(m1.mat.begin(),m1.mat.end());
+	return SymMatInternal::symmetricEigen(Eigen::Index(m1.order),work.data(),values,&vectors);
+}
 
-	//This variable stores the total no. of elements in the triangle
-	total_elements=((order)*(order+1))/2;
-
-	//This variable stores the elements which are below/next (from top to bottom) the element to be accessed
-	below_elements=((order-i)*(order-i+1))/2 +(order-j);
-
-	//This gives us the index of that element
-	Index=total_elements-below_elements-1;	
 
-	return Index;
+/**********************************************************************************************************
+						MULTIPLICATION
+					--------------------	
+There is function overloading for the following:
+1)Both belongs to SymMat
+2)First belongs to SymMat and other to Eigen::Matrix
+3)First belongs to Eigen::Matrix and other to SymMat
 
-}
+Efficiency improvement:-
+The symmetric matrix is never read element by element through index(). It is cut into panels of
+SYMMAT_SYMM_BLOCK rows; each panel is unpacked once from the packed vector into a small dense buffer
+(the part left of the diagonal is a contiguous piece of the packed rows above the panel), and then
+multiplied by Eigen's matrix product, which is blocked for the caches and uses vectorized register
+blocked micro-kernels. The panels are shared between the threads when OpenMP is used.
+************************************************************************************************************/
 
+//Rows of the symmetric matrix in each panel
+#ifndef SYMMAT_SYMM_BLOCK
+#define SYMMAT_SYMM_BLOCK 128
+#endif
 
-/**********************************************************************************************************
-						PRINT MATRIX
-***********************************************************************************************************/
+namespace SymMatInternal
+{
 
-//Print function for printing the matrix belonging to SymMat class on screen
-template<typename _Scalar>
-void SymMat<_Scalar>::print()
+//Copies rows r..r+rows-1 of the packed matrix of order n into the column major array P(rows x n)
+template<typename _Scalar,typename _Packed>
+void unpackPanel(Eigen::Index n,_Packed ap,Eigen::Index r,Eigen::Index rows,_Scalar* P)
 {
-  int i,j;
-  for(i=0;i<order;i++)
-  {
-  	for (j=0;j<order;j++)
-  	{  
-  		std::cout<<std::setw(4)<<mat[index(i,j)]<<" ";  //setw() here sets 4 digits space for each element
-	} 
-  	std::cout<<"\n";
-  }
-}
+	//Columns left of the panel: S(r+i,j)=S(j,r+i) is a contiguous piece of packed row j
+	for(Eigen::Index j=0;j<r;j++)
+	{
+		readPacked(ap+(diagIndex(n,j)+(r-j)),rows,P+j*rows);
+	}
 
-/**********************************************************************************************************
-						TRACE OF MATRIX
-***********************************************************************************************************/
+	//Rows of the panel from the diagonal to the end, and their mirror below the diagonal
+	_Scalar* buffer=DirectPacked<_Packed,_Scalar>::value ? 0 : scratch<_Scalar,ScratchPanelRow>(size_t(n-r));
+	for(Eigen::Index i=0;i<rows;i++)
+	{
+		const Eigen::Index gi=r+i;
+		const _Scalar* src=rowData(ap+diagIndex(n,gi),n-gi,buffer);		//src[c-gi] is S(gi,c) for c>=gi
+		for(Eigen::Index c=gi;c<n;c++)
+		{
+			P[c*rows+i]=src[c-gi];
+		}
+		for(Eigen::Index c=gi+1;c<r+rows;c++)
+		{
+			P[gi*rows+(c-r)]=src[c-gi];
+		}
+	}
+}
 
-//Trace function to return trace of matrix
-template<typename _Scalar>
-_Scalar SymMat<_Scalar>::trace()
+//C = S*B, where S is a packed matrix of order n
+template<typename _Packed,typename _MatrixB,typename _MatrixC>
+void symmLeft(Eigen::Index n,_Packed ap,const _MatrixB& B,_MatrixC& C)
 {
+	typedef typename _MatrixC::Scalar _Scalar;
+	typedef Eigen::Map< const Eigen::Matrix<_Scalar,Eigen::Dynamic,Eigen::Dynamic> > Panel;
+	const Eigen::Index bs=SYMMAT_SYMM_BLOCK,panels=(n+bs-1)/bs;
 
-  //This variable stores the trace of the matrix
-  _Scalar store_trace=0;  
+#ifdef _OPENMP
+	#pragma omp parallel if(panels>1)
+#endif
+	{
+		_Scalar* buffer=scratch<_Scalar,ScratchPanel>(size_t(std::min(bs,n))*n);
 
-  for(int i=0;i<order;i++)
-  {
-  	store_trace += mat[index(i,i)];
-  }
-  return store_trace;
+#ifdef _OPENMP
+		#pragma omp for schedule(dynamic)
+#endif
+		for(Eigen::Index p=0;p<panels;p++)
+		{
+			const Eigen::Index r=p*bs,rows=std::min(bs,n-r);
+			unpackPanel(n,ap,r,rows,buffer);
+			C.middleRows(r,rows).noalias()=Panel(buffer,rows,n)*B;
+		}
+	}
 }
 
-/**********************************************************************************************************
-						PRODUCT OF DIAGONAL ELEMENTS OF THE MATRIX
-***********************************************************************************************************/
-
-//Function to return the product elements of the matrix
-template<typename _Scalar>
-_Scalar SymMat<_Scalar>::diagprod()
+//C = B*S, where S is a packed matrix of order n
+template<typename _Packed,typename _MatrixB,typename _MatrixC>
+void symmRight(Eigen::Index n,_Packed ap,const _MatrixB& B,_MatrixC& C)
 {
+	typedef typename _MatrixC::Scalar _Scalar;
+	typedef Eigen::Map< const Eigen::Matrix<_Scalar,Eigen::Dynamic,Eigen::Dynamic> > Panel;
+	const Eigen::Index bs=SYMMAT_SYMM_BLOCK,panels=(n+bs-1)/bs;
 
-  //This variable stores the trace of the matrix
-  _Scalar store_diag_prod=1;  
+#ifdef _OPENMP
+	#pragma omp parallel if(panels>1)
+#endif
+	{
+		_Scalar* buffer=scratch<_Scalar,ScratchPanel>(size_t(std::min(bs,n))*n);
 
-  for(int i=0;i<order;i++)
-  {
-  	store_diag_prod *= mat[index(i,i)];
-  }
-  return store_diag_prod;
+		//Columns r..r+rows-1 of S are the transposed panel
+#ifdef _OPENMP
+		#pragma omp for schedule(dynamic)
+#endif
+		for(Eigen::Index p=0;p<panels;p++)
+		{
+			const Eigen::Index r=p*bs,rows=std::min(bs,n-r);
+			unpackPanel(n,ap,r,rows,buffer);
+			C.middleCols(r,rows).noalias()=B*Panel(buffer,rows,n).transpose();
+		}
+	}
 }
 
+} //namespace SymMatInternal
 
 
+//Multiplication function for two matrices belonging to SymMat class
+/*
+Only for this function the template parameters are passed from the main funciton since both the function parameters are 
+matrices belonging to SymMat class, so they don't contain rows and columns.
+This will be corrected once this class inherits from Eigen::Matrix or is changed fully to match the Eigen library
+*/
+template<typename _Scalar,int _Rows, int _Cols>
+Eigen::Matrix<_Scalar,_Rows,_Cols> mult(const SymMat<_Scalar>& m1,const SymMat<_Scalar>& m2)
+{	
+	Eigen::Matrix<_Scalar,_Rows,_Cols> m3;
+	mult(m1,m2,m3);
+	return m3;
+}
 
-/**********************************************************************************************************
-						SUM OF THE ELEMENTS OF MATRIX
-
-Efficiency improvement:-
 
-In a normal matrix, we have to traverse through all the elements to calculate the sum,
-However here, the elements in upper triangle except the diagonal elements are same in the lower half, 
-So we have to only calculate the sum of upper triangel except the diagonal elements and make it twice 
-and then add it to the sum of diagonal elements.
+//Multiplication function between one matrix of SymMat class(first parameter) and another from Eigen::Matrix class(second parameter)
+template<typename _Scalar,int _Rows, int _Cols>
+Eigen::Matrix<_Scalar,_Rows,_Cols> mult(const SymMat<_Scalar>& m1,const Eigen::Matrix<_Scalar,_Rows,_Cols>& m2)
+{
+	Eigen::Matrix<_Scalar,_Rows,_Cols> m3;
+	mult(m1,m2,m3);
+	return m3;
+}
 
-***********************************************************************************************************/
 
-//Sum function to return trace of matrix
-template<typename _Scalar>
-_Scalar SymMat<_Scalar>::sum()
+//Multiplication function between one matrix of Eigen::Matrix class(first parameter) and another from SymMat class(second parameter)
+template<typename _Scalar,int _Rows, int _Cols>
+Eigen::Matrix<_Scalar,_Rows,_Cols> mult(const Eigen::Matrix<_Scalar,_Rows,_Cols>& m2,const SymMat<_Scalar>& m1)
 {
+	Eigen::Matrix<_Scalar,_Rows,_Cols> m3;
+	mult(m2,m1,m3);
+	return m3;
+}
 
-  //This variable stores the sum of the elements of matrix
-  _Scalar store_sum=0,store_trace;
 
-  store_trace=trace();
+/*
+The same products into a destination m3 given by the caller, which is resized only when its size differs, so
+that a loop reusing m3 does not allocate it again. m3 must not be the Eigen::Matrix operand.
+*/
+template<typename _Scalar,int _Rows, int _Cols>
+void mult(const SymMat<_Scalar>& m1,const SymMat<_Scalar>& m2,Eigen::Matrix<_Scalar,_Rows,_Cols>& m3)
+{
+	SYMMAT_TRACE_OP("mult(S,S)",_Scalar,m1.order,2*m1.mat.size(),sizeof(_Scalar)*(2*m1.mat.size()+Eigen::Index(m1.order)*m1.order));
+	try
+	{
+		if(m1.order != m2.order)
+		{
+		  throw 'f';
+		}
 
-  for(int i=0;i<mat.size();i++)
-  {
-  	store_sum+=mat[i];
-  }
-  store_sum-=store_trace;
-  store_sum*=2;
-  store_sum+=store_trace;
+	}
+	catch(char& check)
+	{
+		std::cout<< "Matrices are not compatible for multiplication!\nTerminating the program..."<< std::endl;
+		exit(0);
+	}
 
-  return store_sum;
+	//Multiplication(the second matrix is unpacked once, the first one panel by panel)
+	m3.resize(m1.order,m1.order);
+	Eigen::Matrix<_Scalar,Eigen::Dynamic,Eigen::Dynamic> dense2(m2.order,m2.order);
+	SymMatInternal::unpackDense(Eigen::Index(m2.order),m2.mat.data(),dense2.data());
+	SymMatInternal::symmLeft(Eigen::Index(m1.order),m1.mat.data(),dense2,m3);
 }
 
-/**********************************************************************************************************
-						PRODUCT OF THE ELEMENTS OF MATRIX
+template<typename _Scalar,int _Rows, int _Cols>
+void mult(const SymMat<_Scalar>& m1,const Eigen::Matrix<_Scalar,_Rows,_Cols>& m2,Eigen::Matrix<_Scalar,_Rows,_Cols>& m3)
+{
+	SYMMAT_TRACE_OP("mult(S,M)",_Scalar,m1.order,m1.mat.size(),sizeof(_Scalar)*(m1.mat.size()+2*m2.size()));
+	assert(m3.data()!=m2.data());       //The product cannot be written over its operand
 
-Efficiency improvement:-
+	try
+	{
+		if(m1.order != m2.rows())
+		{
+		  throw 'f';
+		}
 
-In a normal matrix, we have to traverse through all the elements to calculate the product,
-However here, the elements in upper triangle except the diagonal elements are same in the lower half, 
-So we have to only calculate the product of upper triangel except the diagonal elements and make it squared 
-and then multiply it by the product of diagonal elements.
+	}
+	catch(char& check)
+	{
+		std::cout<< "Matrices are not compatible for multiplication!\nTerminating the program..."<< std::endl;
+		exit(0);
+	}
 
-***********************************************************************************************************/
+	//Multiplication
+	m3.resize(m1.order,m2.cols());
 
-//Sum function to return trace of matrix
-template<typename _Scalar>
-_Scalar SymMat<_Scalar>::prod()
-{
+	//A single column is a matrix-vector product, which reads the packed vector only once
+	if(m2.cols()==1)
+	{
+		SymMatInternal::spmv(Eigen::Index(m1.order),_Scalar(1),m1.mat.data(),m2.data(),_Scalar(0),m3.data());
+		return;
+	}
 
-  //This variable stores the sum of the elements of matrix
-  _Scalar store_prod=1,store_diag_prod;
+	SymMatInternal::symmLeft(Eigen::Index(m1.order),m1.mat.data(),m2,m3);
+}
 
-  store_diag_prod=diagprod();
+template<typename _Scalar,int _Rows, int _Cols>
+void mult(const Eigen::Matrix<_Scalar,_Rows,_Cols>& m2,const SymMat<_Scalar>& m1,Eigen::Matrix<_Scalar,_Rows,_Cols>& m3)
+{
+	SYMMAT_TRACE_OP("mult(M,S)",_Scalar,m1.order,m1.mat.size(),sizeof(_Scalar)*(m1.mat.size()+2*m2.size()));
+	assert(m3.data()!=m2.data());       //The product cannot be written over its operand
+	try
+	{
+		if(m1.order != m2.cols())
+		{
+		  throw 'f';
+		}
 
-  for(int i=0;i<mat.size();i++)
-  {
-  	store_prod*=mat[i];
-  }
-  store_prod/=store_diag_prod;
-  store_prod*=store_prod;
-  store_prod*=store_diag_prod;
+	}
+	catch(char& check)
+	{
+		std::cout<<"Matrices are not compatible for multiplication!\nTerminating the program..."<< std::endl;
+		exit(0);
+	}
 
-  return store_prod;
+	//Multiplication
+	m3.resize(m2.rows(),m1.order);
+	SymMatInternal::symmRight(Eigen::Index(m1.order),m1.mat.data(),m2,m3);
 }
- 
- 
 
 
 /**********************************************************************************************************
-						MEAN OF THE ELEMENTS OF MATRIX
+						CONGRUENCE TRANSFORM
+					----------------------------
+R = alpha*A^T*S*A + beta*R		(A has S.order rows and R.order columns, it need not be square)
+
+Covariance propagation(P = F*P*F^T + Q is congruence(1,P,F.transpose(),1,Q)), basis changes and the
+quadratic forms of several vectors at once are all A^T*S*A.
 
 Efficiency improvement:-
+R is written directly into its packed vector and only its upper triangle is computed, so there is no dense
+result. Of the two ways below the one with fewer flops is used(S is n x n and R is m x m):-
+
+1)m < n: S is split as S = L + L^T, where L is its lower triangle with half of the diagonal, so that
+	A^T*S*A = A^T*V + V^T*A		with V = L*A
+  V is a triangular product(half of the flops of S*A) and A^T*V + V^T*A is a symmetric rank-2k update,
+  n^2*m + 2*n*m^2 flops in all. The rows of S are taken in panels of SYMMAT_CONGRUENCE_BLOCK rows: the
+  rows of L are unpacked(contiguous pieces of the packed rows, since S(i,j) = S(j,i)), V(p) = L(p)*A is
+  computed by Eigen and R += A(p)^T*V(p) + V(p)^T*A(p) is written by the tiles of syr2k. Only a panel of V
+  exists at a time, so there is no n x m product, and S is read once.
+
+2)m >= n: W = S*A is computed like mult(S,M) and only the tiles of A^T*W in the upper triangle are
+  computed(syrk's tiles), 2*n^2*m + n*m^2 flops. W is n x m, not larger than R. A single panel and a single
+  tile(small matrices) are computed without starting the threads.
+
+Both are 3n^3 flops for n = m, against 4n^3 for the two dense products.
+************************************************************************************************************/
 
-In a normal matrix, we have to traverse through all the elements to calculate the sum, and then divide by 
-the total number of elements to get the mean.
+//Rows of S in each panel
+#ifndef SYMMAT_CONGRUENCE_BLOCK
+#define SYMMAT_CONGRUENCE_BLOCK 256
+#endif
 
-However, in this class the sum is calculated efficiently using the sum() function and then it is divided by 
-the total number of elements.
+namespace SymMatInternal
+{
 
-Hence overall it is faster to calculate the mean of the matrix.
+//Rows r..r+rows-1 of L(the lower triangle of S with half of the diagonal), columns 0..r+rows-1, into the
+//column major rows x (r+rows) matrix P
+template<typename _Packed,typename _Scalar>
+void unpackLowerPanel(Eigen::Index n,_Packed ap,Eigen::Index r,Eigen::Index rows,_Scalar* P)
+{
+	//Columns left of the panel: L(r+i,j)=S(j,r+i) is a contiguous piece of packed row j
+	for(Eigen::Index j=0;j<r;j++)
+	{
+		readPacked(ap+(diagIndex(n,j)+(r-j)),rows,P+j*rows);
+	}
 
-***********************************************************************************************************/
+	//Diagonal block: zeros above the diagonal, half of it, and packed row j below it
+	for(Eigen::Index j=r;j<r+rows;j++)
+	{
+		_Scalar* column=P+j*rows;
+		const Eigen::Index d=j-r;
+		readPacked(ap+diagIndex(n,j),rows-d,column+d);
+		std::fill(column,column+d,_Scalar(0));
+		column[d]*=_Scalar(0.5);
+	}
+}
 
-//Mean function to return the mean of elements of the matrix
-template<typename _Scalar>
-_Scalar SymMat<_Scalar>::mean()
+//R = alpha*A^T*S*A + beta*R on the packed vectors ap(order n = A.rows()) and rp(order A.cols()), from
+//W = S*A and the tiles of A^T*W in the upper triangle
+template<typename _Scalar,typename _MatrixType>
+void congruenceTiles(_Scalar alpha,const _Scalar* ap,const _MatrixType& A,_Scalar beta,_Scalar* rp)
 {
+	typedef Eigen::Map< const Eigen::Matrix<_Scalar,Eigen::Dynamic,Eigen::Dynamic> > Panel;
+	typedef Eigen::Map< Eigen::Matrix<_Scalar,Eigen::Dynamic,Eigen::Dynamic> > Product;
+	typedef Eigen::Map< Eigen::Matrix<_Scalar,Eigen::Dynamic,Eigen::Dynamic,Eigen::RowMajor> > Tile;
 
-  //This variable stores the sum of the elements of matrix
-  _Scalar store_sum,store_mean;  
-
-  store_sum=sum();
-  store_mean=store_sum/(order*order);
+	const Eigen::Index n=A.rows(),m=A.cols();
 
-  return store_mean;
+	//A single panel of S and a single tile of R, without the threads(W is at most a block, so it is kept)
+	if(n<=SYMMAT_SYMM_BLOCK && m<=SYMMAT_SYRK_BLOCK)
+	{
+		Product W(scratch<_Scalar,ScratchProduct>(size_t(n)*m),n,m);
+		_Scalar* panel=scratch<_Scalar,ScratchPanel>(size_t(n)*n);
+		unpackPanel(n,ap,0,n,panel);
+		W.noalias()=Panel(panel,n,n)*A;
+		Tile T(scratch<_Scalar,ScratchTile>(size_t(m)*m),m,m);
+		T.noalias()=A.transpose()*W;
+		storeTile(m,alpha,beta,rp,0,m,0,m,T.data(),m);
+		return;
+	}
+	//W is n x m, so like the product of mult(S,S) it is allocated for this call and not kept by the thread
+	Eigen::Matrix<_Scalar,Eigen::Dynamic,Eigen::Dynamic> W(n,m);
+	symmLeft(n,ap,A,W);
+	packedTiles(A.cols(),alpha,beta,rp,
+		[&A,&W](Eigen::Index r,Eigen::Index br,Eigen::Index c,Eigen::Index bc,Tile& T)
+		{
+			T.topLeftCorner(br,bc).noalias()=A.middleCols(r,br).transpose()*W.middleCols(c,bc);
+		});
 }
 
+//The same from panels of S = L + L^T
+template<typename _Scalar,typename _MatrixType>
+void congruencePanels(_Scalar alpha,const _Scalar* ap,const _MatrixType& A,_Scalar beta,_Scalar* rp)
+{
+	typedef Eigen::Map< const Eigen::Matrix<_Scalar,Eigen::Dynamic,Eigen::Dynamic> > Panel;
+	typedef Eigen::Map< Eigen::Matrix<_Scalar,Eigen::Dynamic,Eigen::Dynamic> > Product;
 
-/**********************************************************************************************************
-						MAX COEFFICIENT AMONGST THE ELEMENTS OF MATRIX
-
-Efficiency improvement:-
+	const Eigen::Index n=A.rows(),m=A.cols();
+	const Eigen::Index bs=SYMMAT_CONGRUENCE_BLOCK;
 
-In a normal matrix, we have to traverse through all the elements to check all the elements.
+	_Scalar* panel=scratch<_Scalar,ScratchPanel>(size_t(std::min(bs,n))*n);
+	_Scalar* V=scratch<_Scalar,ScratchProduct>(size_t(std::min(bs,n))*m);
+	for(Eigen::Index r=0;r<n;r+=bs)
+	{
+		const Eigen::Index rows=std::min(bs,n-r);
+		unpackLowerPanel(n,ap,r,rows,panel);
+		Product Vp(V,rows,m);
+		Vp.noalias()=Panel(panel,rows,r+rows)*A.topRows(r+rows);
 
-In this class, we have to traverse through only the elements in the upper triangle. 
+		//The first panel scales R by beta, the others add to it
+		syr2kTiles(alpha,A.middleRows(r,rows).transpose(),Vp.transpose(),r==0 ? beta : _Scalar(1),rp);
+	}
+}
 
-This improves the efficiency since the no. of iterations to check the maximum element value are less.
+} //namespace SymMatInternal
 
-***********************************************************************************************************/
+//Congruence transform into a new matrix of order A.cols()
+template<typename _Scalar,typename _Derived>
+SymMat<_Scalar> congruence(const SymMat<_Scalar>& m1,const Eigen::MatrixBase<_Derived>& A)
+{
+	SymMat<_Scalar> m2(int(A.cols()));
+	congruence(_Scalar(1),m1,A,_Scalar(0),m2);
+	return m2;
+}
 
-//Function to return the maximum coefficient in the matrix
-template<typename _Scalar>
-_Scalar SymMat<_Scalar>::maxCoeff()
+//Congruence transform into R(the order of R is changed to A.cols() only when beta is 0)
+template<typename _Scalar,typename _Derived>
+void congruence(_Scalar alpha,const SymMat<_Scalar>& m1,const Eigen::MatrixBase<_Derived>& A,_Scalar beta,SymMat<_Scalar>& m2)
 {
+	SYMMAT_TRACE_OP("congruence",_Scalar,m1.order,m1.mat.size(),sizeof(_Scalar)*(m1.mat.size()+A.size()+m2.mat.size()));
+	assert(m1.order==A.rows());       //Condition for the matrices to be conformable
+	assert(m1.mat.data()!=m2.mat.data());       //R cannot be written over S
+	//An empty or differently sized R can only be overwritten
+	if(m2.order!=A.cols())
+	{
+		assert(beta==_Scalar(0));
+		m2=SymMat<_Scalar>(int(A.cols()));
+	}
+	//Expressions(like F.transpose()) are evaluated once, plain matrices are used directly
+	typename Eigen::internal::nested_eval<_Derived,2>::type a(A.derived());
+	if(a.cols()<a.rows() && a.rows()>SYMMAT_SYMM_BLOCK)
+	{
+		SymMatInternal::congruencePanels(alpha,m1.mat.data(),a,beta,m2.mat.data());
+	}
+	else
+	{
+		SymMatInternal::congruenceTiles(alpha,m1.mat.data(),a,beta,m2.mat.data());
+	}
+}
 
-  //This variable stores the maximum of the elements of matrix
-  _Scalar store_max=mat[0];  
 
-  for(int i=1;i<mat.size();i++)
-  {
-  	if(mat[i]>store_max)
-  	{
-  		store_max=mat[i];
-  	}
-  }
+/**********************************************************************************************************
+						PAIRWISE DISTANCES AND KERNELS
+					-------------------------------------
+R(i,j) = f(x(i),x(j)) for the rows x(0..N-1) of an N x d matrix X, with f one of
 
-  return store_max;
-}
+	SymMatSquaredEuclidean	|x-y|^2
+	SymMatEuclidean			|x-y|
+	SymMatCosine			1 - x.y/(|x|*|y|)		(a row of zeros is at distance 1 from every other row)
+	SymMatRbf				exp(-gamma*|x-y|^2)		(Gaussian kernel)
+
+Efficiency improvement:-
+|x-y|^2 = |x|^2 + |y|^2 - 2*x.y, so all the distances come from the inner products X*X^T and the N norms.
+The inner products are computed exactly like syrk: the upper triangle is cut into tiles of
+SYMMAT_SYRK_BLOCK rows, each tile is a product of two blocks of rows of X by Eigen(blocked and vectorized,
+instead of N^2/2 separate dot products), and the tiles are handed to the threads one pair of blocks at a
+time(dynamic schedule), so the threads get the same amount of work although the rows of the triangle
+have different lengths. f is applied to the whole tile with Eigen's array functions(vectorized sqrt
+and exp) while it is still in the cache, and only the upper triangle is written into the packed vector.
+
+For points much further from the origin than from each other the norms cancel and the smallest
+distances lose digits(|x|^2 is rounded before the subtraction); the negative results are set to 0 and
+the diagonal is exact(0, or 1 for the kernel).
+************************************************************************************************************/
 
+namespace SymMatInternal
+{
 
-/**********************************************************************************************************
-						MINIMUM COEFFICIENT AMONGST THE ELEMENTS OF MATRIX
+//R = f(x(i),x(j)) on the packed vector rp of order X.rows()
+template<typename _Scalar,typename _MatrixType>
+void pairwiseTiles(const _MatrixType& X,SymMatDistance kind,_Scalar gamma,_Scalar* rp)
+{
+	typedef Eigen::Map< Eigen::Matrix<_Scalar,Eigen::Dynamic,Eigen::Dynamic,Eigen::RowMajor> > Tile;
+	typedef Eigen::Map< Eigen::Array<_Scalar,Eigen::Dynamic,Eigen::Dynamic,Eigen::RowMajor>,0,Eigen::OuterStride<> > TileArray;
+	typedef Eigen::Map< Eigen::Array<_Scalar,Eigen::Dynamic,1> > Norms;
+	const Eigen::Index n=X.rows();
+
+	//Squared norms of the rows, or their inverse norms for the cosine
+	_Scalar* norms=scratch<_Scalar,ScratchRow>(size_t(n));
+	Norms nrm(norms,n);
+	nrm=X.rowwise().squaredNorm().array();
+	if(kind==SymMatCosine)
+	{
+		nrm=(nrm>_Scalar(0)).select(nrm.rsqrt(),_Scalar(0));
+	}
 
-Efficiency improvement:-
+	packedTiles(n,_Scalar(1),_Scalar(0),rp,
+		[&X,kind,gamma,norms](Eigen::Index r,Eigen::Index br,Eigen::Index c,Eigen::Index bc,Tile& T)
+		{
+			T.topLeftCorner(br,bc).noalias()=X.middleRows(r,br)*X.middleRows(c,bc).transpose();
+			TileArray t(T.data(),br,bc,Eigen::OuterStride<>(T.cols()));
+			const Norms nc(norms+c,bc);
 
-In a normal matrix, we have to traverse through all the elements to check all the elements.
+			//Row by row, so that the norms of the columns are a contiguous vector like the row of the tile
+			for(Eigen::Index i=0;i<br;i++)
+			{
+				const _Scalar ni=norms[r+i];
+				if(kind==SymMatCosine)
+				{
+					t.row(i)=(_Scalar(1)-ni*t.row(i)*nc.transpose()).max(_Scalar(0));
+				}
+				else
+				{
+					t.row(i)=(ni+nc.transpose()-_Scalar(2)*t.row(i)).max(_Scalar(0));
+					if(kind==SymMatEuclidean)
+					{
+						t.row(i)=t.row(i).sqrt();
+					}
+					else if(kind==SymMatRbf)
+					{
+						t.row(i)=(-gamma*t.row(i)).exp();
+					}
+				}
+			}
 
-In this class, we have to traverse through only the elements in the upper triangle. 
+			//The diagonal is known exactly
+			if(r==c)
+			{
+				for(Eigen::Index k=0;k<br;k++)
+				{
+					t(k,k)= kind==SymMatRbf ? _Scalar(1) : _Scalar(0);
+				}
+			}
+		});
+}
 
-This improves the efficiency since the no. of iterations to check the minimum element value are less.
+} //namespace SymMatInternal
 
-***********************************************************************************************************/
+//Pairwise distances(or kernel) of the rows of X as a new packed matrix of order X.rows()
+template<typename _Derived>
+SymMat<typename _Derived::Scalar> pairwise(const Eigen::MatrixBase<_Derived>& X,SymMatDistance kind,typename _Derived::Scalar gamma)
+{
+	SymMat<typename _Derived::Scalar> m1(int(X.rows()));
+	pairwise(X,kind,m1,gamma);
+	return m1;
+}
 
-//Function to return the minimum coefficient in the matrix
+//Pairwise distances(or kernel) of the rows of X into R(whose order is changed to X.rows())
+template<typename _Scalar,typename _Derived>
+void pairwise(const Eigen::MatrixBase<_Derived>& X,SymMatDistance kind,SymMat<_Scalar>& m1,_Scalar gamma)
+{
+	SYMMAT_TRACE_OP("pairwise",_Scalar,X.rows(),(Eigen::Index(X.rows())*(X.rows()+1))/2,sizeof(_Scalar)*((Eigen::Index(X.rows())*(X.rows()+1))/2+X.size()));
+	if(m1.order!=X.rows())
+	{
+		m1=SymMat<_Scalar>(int(X.rows()));
+	}
+	//Expressions are evaluated once, plain matrices are used directly
+	typename Eigen::internal::nested_eval<_Derived,2>::type x(X.derived());
+	SymMatInternal::pairwiseTiles(x,kind,gamma,m1.mat.data());
+}
+
+//Pairwise distances(or kernel) of the rows of a row major array of rows x cols elements
 template<typename _Scalar>
-_Scalar SymMat<_Scalar>::minCoeff()
+void pairwise(const _Scalar* X,int rows,int cols,SymMatDistance kind,SymMat<_Scalar>& m1,_Scalar gamma)
 {
+	typedef Eigen::Map< const Eigen::Matrix<_Scalar,Eigen::Dynamic,Eigen::Dynamic,Eigen::RowMajor> > RowMajorMap;
+	pairwise(RowMajorMap(X,rows,cols),kind,m1,gamma);
+}
 
-  //This variable stores the minimum of the elements of matrix
-  _Scalar store_min=mat[0];  
 
-  for(int i=1;i<mat.size();i++)
-  {
-  	if(mat[i]<store_min)
-  	{
-  		store_min=mat[i];
-  	}
-  }
+/**********************************************************************************************************
+						VIEW OF AN EXISTING PACKED VECTOR
+					-----------------------------------------
+SymMatRef uses a packed vector owned by someone else(another library, a buffer read from a socket, a
+SymMat) in place, without copying it:-
 
-  return store_min;
-}
-/*******************************************************************************************************
-						NUMBER OF ELEMENTS STORED IN THE CLASSICAL PACKED FORMAT
-********************************************************************************************************/
-//Function to return the number of matrix elements stored in the classical packed format 
+	SymMatRef<double> R(buffer,n);		//buffer holds n(n+1)/2 elements, upper triangle row by row
+	spmv(1.0,R,x,0.0,y);
+	SymMat<double> S=2.0*R;				//R takes part in the expressions
+	R=S1+S2;							//written into buffer
+
+The buffer must stay alive as long as the view, and copying a view does not copy the elements.
+************************************************************************************************************/
 template<typename _Scalar>
-int SymMat<_Scalar>::elemstored()
+class SymMatRef : public SymMatExpr< SymMatRef<_Scalar> >
 {
-  return mat.size();
-}
-
+public:
 
+	typedef _Scalar Scalar;
 
-/***********************************************************************************************************
-						ADDITION
-					---------------	
-Efficiency improvement:-
-In addition between symmetric matrices, we only have to add the elements of upper triangle to get
+	//Order of the matrix
+	int order;
 
+	//Packed vector(not owned)
+	_Scalar* mat;
 
-There is function overloading for the following:
-1)Both belongs to SymMat
-2)First belongs to SymMat and other to Eigen::Matrix
-3)First belongs to Eigen::Matrix and other to SymMat
-************************************************************************************************************/
+	SymMatRef(_Scalar* p,int o) :order(o),mat(p) {}
+	SymMatRef(SymMat<_Scalar>& m) :order(m.order),mat(m.mat.data()) {}
 
+	//Evaluates a symmetric expression of the same order into the buffer
+	template<typename _Derived>
+	SymMatRef& operator=(const SymMatExpr<_Derived>&);
 
-//Addition function for two matrices belonging to SymMat class
-template<typename _Scalar>
-SymMat<_Scalar> add(SymMat<_Scalar>& m1,SymMat<_Scalar>& m2)
-{
-	assert((m1.mat).size()==(m2.mat).size());       //Condition for matrices to be conformable for addition
-	SymMat<_Scalar> m3(m1.order);					//Creating a matrix which stores the addition of these two matrices
+	//Assigning a view copies the elements into this buffer
+	SymMatRef& operator=(const SymMatRef& other) { return *this=static_cast<const SymMatExpr<SymMatRef>&>(other); }
 
-	for(int i=0;i<(m1.mat).size();i++)
+	//In place arithmetic on the buffer
+	template<typename _Derived>
+	SymMatRef& operator+=(const SymMatExpr<_Derived>& other)
 	{
-		m3.mat[i]=m1.mat[i]+m2.mat[i];
+		assert(size()==other.derived().size());       //Condition for matrices to be conformable for addition
+		SymMatInternal::compoundAssign(mat,other.derived(),SymMatSumOp());
+		return *this;
 	}
-	return m3;
+	template<typename _Derived>
+	SymMatRef& operator-=(const SymMatExpr<_Derived>& other)
+	{
+		assert(size()==other.derived().size());       //Condition for matrices to be conformable for subtraction
+		SymMatInternal::compoundAssign(mat,other.derived(),SymMatDifferenceOp());
+		return *this;
+	}
+	SymMatRef& operator*=(const _Scalar& a) { packed()*=a; return *this; }
+	SymMatRef& operator/=(const _Scalar& a) { packed()/=a; return *this; }
 
-}
+	//Element at position k of the packed vector(used by the expressions)
+	const _Scalar& coeff(Eigen::Index k) const { return mat[k]; }
 
+	//No. of elements stored in the classical packed format
+	Eigen::Index size() const { return (Eigen::Index(order)*(order+1))/2; }
 
-//Addition function between one matrix belonging to SymMat class(First argument) and another(Second argument) to Eigen::Matrix
-template<typename _Scalar,int _Rows, int _Cols>
-Eigen::Matrix<_Scalar,_Rows,_Cols> add(SymMat<_Scalar>& m1,Eigen::Matrix<_Scalar,_Rows,_Cols>& m2)
-{
-	assert(m1.order == m2.rows() && m1.order == m2.cols());       //Condition for matrices to be conformable for addition
-	Eigen::Matrix<_Scalar,_Rows,_Cols> m3;
-	for(int i=0;i<m1.order;i++)
+	//Returns the index of the element (i,j) stored in the vector
+	Eigen::Index index(Eigen::Index i,Eigen::Index j) const
 	{
-		for(int j=0;j<m1.order;j++)
+		if(i>j)  //only the upper triangle is stored
 		{
-			m3(i,j)=m1.mat[m1.index(i,j)]+m2(i,j);
+			std::swap(i,j);
 		}
+		return SymMatInternal::diagIndex(order,i)+(j-i);
 	}
-	return m3;
-}
 
+	_Scalar& operator()(Eigen::Index i,Eigen::Index j) const { return mat[index(i,j)]; }
 
-//Addition function between one matrix belonging to Eigen::matrix(First argument) and SymMat class(Second argument) to Eigen::Matrix
-template<typename _Scalar,int _Rows, int _Cols>
-Eigen::Matrix<_Scalar,_Rows,_Cols> add(Eigen::Matrix<_Scalar,_Rows,_Cols>& m2,SymMat<_Scalar>& m1)
-{
-	assert(m1.order==m2.rows() && m1.order == m2.cols());       //Condition for matrices to be conformable for addition
-	Eigen::Matrix<_Scalar,_Rows,_Cols> m3;
-	for(int i=0;i<m1.order;i++)
+	//The packed vector as an Eigen vector
+	Eigen::Map< Eigen::Matrix<_Scalar,Eigen::Dynamic,1> > packed() const { return Eigen::Map< Eigen::Matrix<_Scalar,Eigen::Dynamic,1> >(mat,size()); }
+
+	//The whole matrix(both triangles) as a dense Eigen matrix
+	Eigen::Matrix<_Scalar,Eigen::Dynamic,Eigen::Dynamic> dense() const
+	{
+		Eigen::Matrix<_Scalar,Eigen::Dynamic,Eigen::Dynamic> m2(order,order);
+		SymMatInternal::unpackDense(Eigen::Index(order),(const _Scalar*)mat,m2.data());
+		return m2;
+	}
+
+	//Sum of the packed vector, and of all the elements
+	_Scalar packedSum() const { return SymMatInternal::packedSum((const _Scalar*)mat,size()); }
+	_Scalar trace() const
 	{
-		for(int j=0;j<m1.order;j++)
+		_Scalar total=0;
+		for(int i=0;i<order;i++)
 		{
-			m3(i,j)=m1.mat[m1.index(i,j)]+m2(i,j);
+			total+=mat[SymMatInternal::diagIndex(order,i)];
 		}
+		return total;
 	}
-	return m3;
-}
-
-
-
-/********************************************************************************************************
-						SUBTRACTION
-					------------------	
-There is function overloading for the following:
-1)Both belongs to SymMat
-2)First belongs to SymMat and other to Eigen::Matrix
-3)First belongs to Eigen::Matrix and other to SymMat
-**********************************************************************************************************/
+	_Scalar sum() const { return 2*packedSum()-trace(); }
+};
 
-//Addition function for two matrices belonging to SymMat class
+//Matrices are only referred to inside the expressions, never copied
 template<typename _Scalar>
-SymMat<_Scalar> sub(SymMat<_Scalar>& m1,SymMat<_Scalar>& m2)
+struct SymMatTraits< SymMatRef<_Scalar> >
 {
-	assert((m1.mat).size()==(m2.mat).size());       //Condition for matrices to be conformable for addition
-	SymMat<_Scalar> m3(m1.order);
+	typedef _Scalar Scalar;
+	typedef const SymMatRef<_Scalar>& Nested;
+};
 
-	for(int i=0;i<(m1.mat).size();i++)
+template<typename _Scalar>
+template<typename _Derived>
+SymMatRef<_Scalar>& SymMatRef<_Scalar>::operator=(const SymMatExpr<_Derived>& other)
+{
+	const _Derived& expr=other.derived();
+	assert(size()==expr.size());       //Condition for matrices to be conformable(the buffer cannot grow)
+	const Eigen::Index elements=expr.size();
+	for(Eigen::Index k=0;k<elements;k++)
 	{
-		m3.mat[i]=m1.mat[i]-m2.mat[i];
+		mat[k]=expr.coeff(k);
 	}
-	return m3;
+	return *this;
+}
 
+template<typename _Scalar>
+void spmv(_Scalar alpha,const SymMatRef<_Scalar>& m1,const _Scalar* x,_Scalar beta,_Scalar* y)
+{
+	SymMatInternal::spmv(Eigen::Index(m1.order),alpha,(const _Scalar*)m1.mat,x,beta,y);
 }
 
+template<typename _Scalar,int _Rows>
+void spmv(_Scalar alpha,const SymMatRef<_Scalar>& m1,const Eigen::Matrix<_Scalar,_Rows,1>& x,_Scalar beta,Eigen::Matrix<_Scalar,_Rows,1>& y)
+{
+	assert(m1.order==x.rows());       //Condition for the matrix and the vector to be conformable
+	y.resize(m1.order);
+	SymMatInternal::spmv(Eigen::Index(m1.order),alpha,(const _Scalar*)m1.mat,x.data(),beta,y.data());
+}
 
-//Addition function between one matrix belonging to SymMat class(First argument) and another(Second argument) to Eigen::Matrix
-template<typename _Scalar,int _Rows, int _Cols>
-Eigen::Matrix<_Scalar,_Rows,_Cols> sub(SymMat<_Scalar>& m1,Eigen::Matrix<_Scalar,_Rows,_Cols>& m2)
+template<typename _Scalar,int _Rows,int _Cols>
+Eigen::Matrix<_Scalar,_Rows,_Cols> mult(const SymMatRef<_Scalar>& m1,const Eigen::Matrix<_Scalar,_Rows,_Cols>& m2)
 {
-	assert(m1.order == m2.rows() && m1.order == m2.cols());       //Condition for matrices to be conformable for addition
-	Eigen::Matrix<_Scalar,_Rows,_Cols> m3;
-	for(int i=0;i<m1.order;i++)
-	{
-		for(int j=0;j<m1.order;j++)
-		{
-			m3(i,j)=m1.mat[m1.index(i,j)]-m2(i,j);
-		}
-	}
+	assert(m1.order==m2.rows());       //Condition for matrices to be conformable for multiplication
+	Eigen::Matrix<_Scalar,_Rows,_Cols> m3(m1.order,m2.cols());
+	SymMatInternal::symmLeft(Eigen::Index(m1.order),(const _Scalar*)m1.mat,m2,m3);
 	return m3;
 }
 
-
-//Addition function between one matrix belonging to Eigen::matrix(First argument) and SymMat class(Second argument) to Eigen::Matrix
-template<typename _Scalar,int _Rows, int _Cols>
-Eigen::Matrix<_Scalar,_Rows,_Cols> sub(Eigen::Matrix<_Scalar,_Rows,_Cols>& m2,SymMat<_Scalar>& m1)
+template<typename _Scalar,int _Rows,int _Cols>
+Eigen::Matrix<_Scalar,_Rows,_Cols> mult(const Eigen::Matrix<_Scalar,_Rows,_Cols>& m2,const SymMatRef<_Scalar>& m1)
 {
-	assert(m1.order==m2.rows() && m1.order == m2.cols());       //Condition for matrices to be conformable for addition
-	Eigen::Matrix<_Scalar,_Rows,_Cols> m3;
-	for(int i=0;i<m1.order;i++)
-	{
-		for(int j=0;j<m1.order;j++)
-		{
-			m3(i,j)=m2(i,j)-m1.mat[m1.index(i,j)];
-		}
-	}
+	assert(m1.order==m2.cols());       //Condition for matrices to be conformable for multiplication
+	Eigen::Matrix<_Scalar,_Rows,_Cols> m3(m2.rows(),m1.order);
+	SymMatInternal::symmRight(Eigen::Index(m1.order),(const _Scalar*)m1.mat,m2,m3);
 	return m3;
 }
 
+
 /**********************************************************************************************************
-						MULTIPLICATION
-					--------------------	
-There is function overloading for the following:
-1)Both belongs to SymMat
-2)First belongs to SymMat and other to Eigen::Matrix
-3)First belongs to Eigen::Matrix and other to SymMat
+						FIXED ORDER SYMMETRIC MATRIX
+					------------------------------------
+SymMat<_Scalar,N>(e.g. SymMat<double,3> for a stress tensor, SymMat<double,6> for a covariance) is the
+same packed matrix, with the order known at compile time, like Eigen::Matrix<_Scalar,3,3>:-
+
+1)The N(N+1)/2 elements are kept in a std::array inside the object, so there is no heap allocation
+  and no order is stored(the matrix is exactly N(N+1)/2 scalars).
+2)index(i,j) is constexpr, so the position of an element with constant (i,j) is computed by the compiler.
+3)The loops of trace, sum, add/sub and mult are unrolled at compile time by SymMatInternal::Unroll.
+
+It is a SymMatExpr like SymMat, so the expressions(a*S1+S2) work between fixed matrices, and the result
+is computed in one unrolled loop when it is assigned to a fixed matrix.
 ************************************************************************************************************/
+namespace SymMatInternal
+{
 
-//Multiplication function for two matrices belonging to SymMat class
-/*
-Only for this function the template parameters are passed from the main funciton since both the function parameters are 
-matrices belonging to SymMat class, so they don't contain rows and columns.
-This will be corrected once this class inherits from Eigen::Matrix or is changed fully to match the Eigen library
-*/
-template<typename _Scalar,int _Rows, int _Cols>
-Eigen::Matrix<_Scalar,_Rows,_Cols> mult(SymMat<_Scalar>& m1,SymMat<_Scalar>& m2)
-{	
-	try
+//Calls f(k) for k=_First,...,_Last-1, unrolled at compile time. The range is split in halves, so the
+//depth of the instantiations is log2 of its length(SymMat<double,48> has 1176 elements, mult of order
+//32 1024 products)
+template<int _First,int _Last,int _Length=_Last-_First>
+struct Unroll
+{
+	template<typename _Function>
+	static void run(_Function& f)
 	{
-		if(m1.order != m2.order)
-		{
-		  throw 'f';
-		}
+		Unroll<_First,_First+_Length/2>::run(f);
+		Unroll<_First+_Length/2,_Last>::run(f);
+	}
+};
+
+template<int _First,int _Last>
+struct Unroll<_First,_Last,1>
+{
+	template<typename _Function>
+	static void run(_Function& f) { f(_First); }
+};
+
+template<int _First,int _Last>
+struct Unroll<_First,_Last,0>
+{
+	template<typename _Function>
+	static void run(_Function&) {}
+};
+
+//Type is _Type only for a fixed order, so that the functions of fixed matrices are not used for SymMat<_Scalar>
+template<int _Order,typename _Type>
+struct FixedOnly : std::enable_if<_Order!=Eigen::Dynamic,_Type> {};
+
+} //namespace SymMatInternal
+
+template <typename _Scalar,int _Order>
+class SymMat : public SymMatExpr< SymMat<_Scalar,_Order> >
+{
+public:
+
+	typedef _Scalar Scalar;
+
+	//No. of elements stored in the classical packed format
+	enum { Size=(_Order*(_Order+1))/2 };
+
+	//Order of the matrix
+	static constexpr int order=_Order;
+
+	//Array which stores the elements of the matrix
+	std::array<_Scalar,Size> mat;
+
+	//Matrix of zeros
+	SymMat() { mat.fill(_Scalar(0)); }
+
+	//Initializer list(the elements of the upper triangle, row by row)
+	SymMat(std::initializer_list<_Scalar>);
+
+	//Evaluates a symmetric expression of the same order into a new matrix
+	template<typename _Derived>
+	SymMat(const SymMatExpr<_Derived>& other) { *this=other; }
+
+	//Evaluates a symmetric expression of the same order into this matrix in a single unrolled loop
+	template<typename _Derived>
+	SymMat& operator=(const SymMatExpr<_Derived>&);
+
+	//In place arithmetic, unrolled like the assignment
+	template<typename _Derived>
+	SymMat& operator+=(const SymMatExpr<_Derived>& other) { return compound(other.derived(),SymMatSumOp()); }
+	template<typename _Derived>
+	SymMat& operator-=(const SymMatExpr<_Derived>& other) { return compound(other.derived(),SymMatDifferenceOp()); }
+	SymMat& operator*=(const _Scalar& a) { return *this=a*(*this); }
+	SymMat& operator/=(const _Scalar& a) { return *this=(_Scalar(1)/a)*(*this); }
 
+	//Element at position k of the packed vector(used by the expressions)
+	const _Scalar& coeff(Eigen::Index k) const { return mat[k]; }
+
+	//No. of elements stored in the classical packed format
+	static constexpr Eigen::Index size() { return Size; }
+
+	//Returns the index of the element (i,j) stored in the array
+	static constexpr int index(int i,int j)
+	{
+		return i>j ? index(j,i) : i*_Order-(i*(i-1))/2+(j-i);
 	}
-	catch(char& check)
+
+	//Overloading the funtion call operator
+	_Scalar& operator()(int i,int j) { return mat[index(i,j)]; }
+	const _Scalar& operator()(int i,int j) const { return mat[index(i,j)]; }
+
+	//Full matrix with both triangles filled
+	Eigen::Matrix<_Scalar,_Order,_Order> dense() const;
+
+	//Prints the matrix
+	void print() const;
+
+	/***BASIC ARITHMETIC REDUCTION OPERATIONS*****/
+	_Scalar trace() const;
+	_Scalar packedSum() const;
+	_Scalar sum() const { return 2*packedSum()-trace(); }
+	_Scalar mean() const { return sum()/_Scalar(_Order*_Order); }
+	_Scalar diagprod() const;
+	_Scalar minCoeff() const { return *std::min_element(mat.begin(),mat.end()); }
+	_Scalar maxCoeff() const { return *std::max_element(mat.begin(),mat.end()); }
+
+	//No.of elements stored in the classical packed format
+	int elemstored() const { return Size; }
+
+private:
+	template<typename _Derived,typename _Op>
+	SymMat& compound(const _Derived& expr,_Op op)
 	{
-		std::cout<< "Matrices are not compatible for multiplication!\nTerminating the program..."<< std::endl;
-		exit(0);
+		assert(expr.size()==Size);       //Condition for matrices to be conformable
+		_Scalar* dst=mat.data();
+		auto f=[&](int k){ dst[k]=op(dst[k],expr.coeff(k)); };
+		SymMatInternal::Unroll<0,Size>::run(f);
+		return *this;
 	}
+};
 
-	//Multiplication
-	Eigen::Matrix<_Scalar,_Rows,_Cols> m3;
-	int i,j,k;
-	for(i=0;i<m2.order;i++)
+template<typename _Scalar,int _Order>
+constexpr int SymMat<_Scalar,_Order>::order;
+
+template<typename _Scalar,int _Order>
+SymMat<_Scalar,_Order>::SymMat(std::initializer_list<_Scalar> list)
+{
+	//The order is fixed, so the list must have exactly the elements of its upper triangle
+	if(list.size()!=size_t(Size))
 	{
-		for(j=0;j<m2.order;j++)
-		{
-			m3(i,j)=0;
-			for(k=0;k<m2.order;k++)
-			{
-				m3(i,j)+=m1.mat[m1.index(i,k)]*m2.mat[m2.index(k,j)];
-			}
-		}
+		std::cout<<"Wrong number of elements for a upper triangle of square matrix!\nTerminating the program..."<<std::endl;
+		std::exit(0);
 	}
-	return m3;
+	std::copy(list.begin(),list.end(),mat.begin());
 }
 
-
-//Multiplication function between one matrix of SymMat class(first parameter) and another from Eigen::Matrix class(second parameter)
-template<typename _Scalar,int _Rows, int _Cols>
-Eigen::Matrix<_Scalar,_Rows,_Cols> mult(SymMat<_Scalar>& m1,Eigen::Matrix<_Scalar,_Rows,_Cols>& m2)
+template<typename _Scalar,int _Order>
+template<typename _Derived>
+SymMat<_Scalar,_Order>& SymMat<_Scalar,_Order>::operator=(const SymMatExpr<_Derived>& other)
 {
+	const _Derived& expr=other.derived();
+	assert(expr.size()==Size);       //Condition for matrices to be conformable
 
-	try
-	{
-		if(m1.order != m2.rows())
-		{
-		  throw 'f';
-		}
+	_Scalar* dst=mat.data();
+	auto f=[&](int k){ dst[k]=expr.coeff(k); };
+	SymMatInternal::Unroll<0,Size>::run(f);
+	return *this;
+}
 
-	}
-	catch(char& check)
+template<typename _Scalar,int _Order>
+Eigen::Matrix<_Scalar,_Order,_Order> SymMat<_Scalar,_Order>::dense() const
+{
+	Eigen::Matrix<_Scalar,_Order,_Order> m;
+	auto f=[&](int k)
 	{
-		std::cout<< "Matrices are not compatible for multiplication!\nTerminating the program..."<< std::endl;
-		exit(0);
-	}
+		const int i=k/_Order,j=k%_Order;
+		m(i,j)=mat[index(i,j)];
+	};
+	SymMatInternal::Unroll<0,_Order*_Order>::run(f);
+	return m;
+}
 
-	//Multiplication
-	Eigen::Matrix<_Scalar,_Rows,_Cols> m3;
-	int i,j,k;
-	for(i=0;i<m1.order;i++)
+template<typename _Scalar,int _Order>
+void SymMat<_Scalar,_Order>::print() const
+{
+	for(int i=0;i<_Order;i++)
 	{
-		for(j=0;j<m2.cols();j++)
+		for(int j=0;j<_Order;j++)
 		{
-			m3(i,j)=0;
-			for(k=0;k<m1.order;k++)
-			{
-				m3(i,j)+=m1.mat[m1.index(i,k)]*m2(k,j);
-			}
+			std::cout<<std::setw(4)<<mat[index(i,j)]<<" ";  //setw() here sets 4 digits space for each element
 		}
+		std::cout<<"\n";
 	}
-	return m3;
 }
 
+template<typename _Scalar,int _Order>
+_Scalar SymMat<_Scalar,_Order>::trace() const
+{
+	_Scalar store_trace=0;
+	auto f=[&](int i){ store_trace+=mat[index(i,i)]; };
+	SymMatInternal::Unroll<0,_Order>::run(f);
+	return store_trace;
+}
 
-//Multiplication function between one matrix of Eigen::Matrix class(first parameter) and another from SymMat class(second parameter)
-template<typename _Scalar,int _Rows, int _Cols>
-Eigen::Matrix<_Scalar,_Rows,_Cols> mult(Eigen::Matrix<_Scalar,_Rows,_Cols>& m2,SymMat<_Scalar>& m1)
+template<typename _Scalar,int _Order>
+_Scalar SymMat<_Scalar,_Order>::diagprod() const
 {
-	try
-	{
-		if(m1.order != m2.cols())
-		{
-		  throw 'f';
-		}
+	_Scalar store_diag_prod=1;
+	auto f=[&](int i){ store_diag_prod*=mat[index(i,i)]; };
+	SymMatInternal::Unroll<0,_Order>::run(f);
+	return store_diag_prod;
+}
 
-	}
-	catch(char& check)
-	{
-		std::cout<<"Matrices are not compatible for multiplication!\nTerminating the program..."<< std::endl;
-		exit(0);
-	}
+template<typename _Scalar,int _Order>
+_Scalar SymMat<_Scalar,_Order>::packedSum() const
+{
+	_Scalar store_sum=0;
+	auto f=[&](int k){ store_sum+=mat[k]; };
+	SymMatInternal::Unroll<0,Size>::run(f);
+	return store_sum;
+}
 
-	//Multiplication
-	Eigen::Matrix<_Scalar,_Cols,_Rows> m3;
-	int i,j,k;
-	for(i=0;i<m2.rows();i++)
+//Addition and subtraction with a fixed size Eigen matrix of the same order----------------------------
+template<typename _Scalar,int _Order>
+typename SymMatInternal::FixedOnly<_Order,Eigen::Matrix<_Scalar,_Order,_Order> >::type add(const SymMat<_Scalar,_Order>& m1,const Eigen::Matrix<_Scalar,_Order,_Order>& m2)
+{
+	return m1.dense()+m2;
+}
+
+template<typename _Scalar,int _Order>
+typename SymMatInternal::FixedOnly<_Order,Eigen::Matrix<_Scalar,_Order,_Order> >::type add(const Eigen::Matrix<_Scalar,_Order,_Order>& m2,const SymMat<_Scalar,_Order>& m1)
+{
+	return m2+m1.dense();
+}
+
+template<typename _Scalar,int _Order>
+typename SymMatInternal::FixedOnly<_Order,Eigen::Matrix<_Scalar,_Order,_Order> >::type sub(const SymMat<_Scalar,_Order>& m1,const Eigen::Matrix<_Scalar,_Order,_Order>& m2)
+{
+	return m1.dense()-m2;
+}
+
+template<typename _Scalar,int _Order>
+typename SymMatInternal::FixedOnly<_Order,Eigen::Matrix<_Scalar,_Order,_Order> >::type sub(const Eigen::Matrix<_Scalar,_Order,_Order>& m2,const SymMat<_Scalar,_Order>& m1)
+{
+	return m2-m1.dense();
+}
+
+/*
+Multiplication: the symmetric matrix is unpacked(unrolled) into a fixed size Eigen matrix, and the
+product is done by Eigen, which unrolls the products of small fixed size matrices. The orders are checked
+by the compiler.
+*/
+template<typename _Scalar,int _Order>
+typename SymMatInternal::FixedOnly<_Order,Eigen::Matrix<_Scalar,_Order,_Order> >::type mult(const SymMat<_Scalar,_Order>& m1,const SymMat<_Scalar,_Order>& m2)
+{
+	return (m1.dense()*m2.dense()).eval();
+}
+
+template<typename _Scalar,int _Order,int _Cols>
+typename SymMatInternal::FixedOnly<_Order,Eigen::Matrix<_Scalar,_Order,_Cols> >::type mult(const SymMat<_Scalar,_Order>& m1,const Eigen::Matrix<_Scalar,_Order,_Cols>& m2)
+{
+	return (m1.dense()*m2).eval();
+}
+
+template<typename _Scalar,int _Rows,int _Order>
+typename SymMatInternal::FixedOnly<_Order,Eigen::Matrix<_Scalar,_Rows,_Order> >::type mult(const Eigen::Matrix<_Scalar,_Rows,_Order>& m2,const SymMat<_Scalar,_Order>& m1)
+{
+	return (m2*m1.dense()).eval();
+}
+
+/*
+Congruence transform A^T*S*A of fixed orders: S*A is computed by Eigen on the unpacked matrix, and only the
+upper triangle of the result is computed from it. The loops are unrolled.
+*/
+template<typename _Scalar,int _Order,int _Cols>
+typename SymMatInternal::FixedOnly<_Order,typename SymMatInternal::FixedOnly<_Cols,SymMat<_Scalar,_Cols> >::type>::type congruence(const SymMat<_Scalar,_Order>& m1,const Eigen::Matrix<_Scalar,_Order,_Cols>& A)
+{
+	const Eigen::Matrix<_Scalar,_Order,_Cols> W=m1.dense()*A;
+	SymMat<_Scalar,_Cols> m2;
+	auto f=[&](int k)
 	{
-		for(j=0;j<m1.order;j++)
+		const int i=k/_Cols,j=k%_Cols;
+		if(i<=j)
 		{
-			m3(i,j)=0;
-			for(k=0;k<m1.order;k++)
-			{
-				m3(i,j)+=m2(i,k)*m1.mat[m1.index(k,j)];
-			}
+			m2(i,j)=A.col(i).dot(W.col(j));
 		}
-	}
-	return m3;
+	};
+	SymMatInternal::Unroll<0,_Cols*_Cols>::run(f);
+	return m2;
 }
 
 
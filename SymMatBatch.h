@@ -0,0 +1,533 @@
+/***********************************************************************************************
+This header file contains SymMatBatch - a batch of many small symmetric matrices of the same order
+
+A SymMat<_Scalar,N> keeps the N(N+1)/2 elements of one matrix together, so a loop over millions of
+them works on one matrix at a time. SymMatBatch<_Scalar,N> stores the batch the other way round
+(structure of arrays): element k of every matrix is kept in one contiguous plane,
+
+	plane 0:  S0(0,0) S1(0,0) S2(0,0) ...
+	plane 1:  S0(0,1) S1(0,1) S2(0,1) ...
+	...
+
+so an operation on the batch is the same arithmetic done on whole planes. The loops of the kernels
+go over the matrices, which are independent, and the compiler vectorizes them across the batch
+(each SIMD lane is a different matrix). The batch is cut into chunks of SYMMAT_BATCH_CHUNK matrices,
+which are shared between the threads when OpenMP is used.
+
+Vectors of the batch(one vector of order N per matrix) are Eigen matrices with one row per matrix
+and N columns, which are column major, so component i of every vector is also contiguous.
+
+************************************************************************************************/
+//-----------------------------------------------------------------------------------------------
+
+
+/************************************************************************************************
+						INCLUDE GAURDS
+*************************************************************************************************/
+#ifndef SYMMAT_BATCH_H
+#define SYMMAT_BATCH_H
+
+
+/*************************************************************************************************
+						INCLUDING THE DEPENDENCIES
+**************************************************************************************************/
+#include "SymMat.h"				//fixed order SymMat, SymMatAllocator
+
+
+//Matrices in each chunk of work given to a thread
+#ifndef SYMMAT_BATCH_CHUNK
+#define SYMMAT_BATCH_CHUNK 4096
+#endif
+
+namespace SymMatInternal
+{
+
+//Calls f(first,last) for the chunks of [0,count), in parallel for large batches
+template<typename _Function>
+void batchChunks(Eigen::Index count,_Function f)
+{
+	const Eigen::Index chunk=SYMMAT_BATCH_CHUNK,chunks=(count+chunk-1)/chunk;
+
+#ifdef _OPENMP
+	#pragma omp parallel for schedule(static) if(chunks>1)
+#endif
+	for(Eigen::Index c=0;c<chunks;c++)
+	{
+		f(c*chunk,std::min(count,(c+1)*chunk));
+	}
+}
+
+} //namespace SymMatInternal
+
+
+/*************************************************************************************************
+						CLASS DEFINITION
+**************************************************************************************************/
+template <typename _Scalar,int _Order>
+class SymMatBatch
+{
+public:
+
+	typedef _Scalar Scalar;
+
+	//No. of elements of each matrix and the matrix type of one element of the batch
+	enum { Size=(_Order*(_Order+1))/2 };
+	typedef SymMat<_Scalar,_Order> Matrix;
+
+	//One vector of order _Order(or a whole matrix) per row
+	typedef Eigen::Matrix<_Scalar,Eigen::Dynamic,_Order> Vectors;
+	typedef Eigen::Matrix<_Scalar,Eigen::Dynamic,_Order*_Order> Matrices;
+
+	//No. of matrices
+	Eigen::Index count;
+
+	//Distance between two planes(count rounded up so that every plane starts aligned)
+	Eigen::Index stride;
+
+	//The planes one after another, element k of matrix b is mat[k*stride+b]
+	std::vector< _Scalar,SymMatAllocator<_Scalar> > mat;
+
+	//Batch of n matrices of zeros
+	explicit SymMatBatch(Eigen::Index n=0) { resize(n); }
+
+	//Changes the no. of matrices, all the elements are set to '0'
+	void resize(Eigen::Index n)
+	{
+		const Eigen::Index lanes=std::max(Eigen::Index(SYMMAT_ALIGN/sizeof(_Scalar)),Eigen::Index(1));
+		count=n;
+		stride=((n+lanes-1)/lanes)*lanes;
+		mat.assign(size_t(stride*Size),_Scalar(0));
+	}
+
+	//Plane k(element k of every matrix)
+	_Scalar* plane(int k) { return mat.data()+k*stride; }
+	const _Scalar* plane(int k) const { return mat.data()+k*stride; }
+
+	//Element (i,j) of matrix b
+	_Scalar& operator()(Eigen::Index b,int i,int j) { return mat[Matrix::index(i,j)*stride+b]; }
+
+	//Copies matrix b out of the batch, or into it
+	Matrix get(Eigen::Index b) const
+	{
+		Matrix m;
+		for(int k=0;k<Size;k++)
+		{
+			m.mat[k]=mat[k*stride+b];
+		}
+		return m;
+	}
+
+	void set(Eigen::Index b,const Matrix& m)
+	{
+		for(int k=0;k<Size;k++)
+		{
+			mat[k*stride+b]=m.mat[k];
+		}
+	}
+};
+
+
+/*************************************************************************************************
+						ADDITION AND SUBTRACTION
+Each plane of the result is the sum(difference) of the same planes of the operands.
+**************************************************************************************************/
+namespace SymMatInternal
+{
+
+template<typename _Scalar,int _Order,typename _Op>
+SymMatBatch<_Scalar,_Order> batchBinary(const SymMatBatch<_Scalar,_Order>& m1,const SymMatBatch<_Scalar,_Order>& m2,_Op op)
+{
+	assert(m1.count==m2.count);       //Condition for batches to be conformable
+	SymMatBatch<_Scalar,_Order> m3(m1.count);
+	batchChunks(m1.count,[&](Eigen::Index first,Eigen::Index last)
+	{
+		for(int k=0;k<SymMatBatch<_Scalar,_Order>::Size;k++)
+		{
+			const _Scalar* a=m1.plane(k);
+			const _Scalar* b=m2.plane(k);
+			_Scalar* c=m3.plane(k);
+			for(Eigen::Index p=first;p<last;p++)
+			{
+				c[p]=op(a[p],b[p]);
+			}
+		}
+	});
+	return m3;
+}
+
+} //namespace SymMatInternal
+
+template<typename _Scalar,int _Order>
+SymMatBatch<_Scalar,_Order> add(const SymMatBatch<_Scalar,_Order>& m1,const SymMatBatch<_Scalar,_Order>& m2)
+{
+	return SymMatInternal::batchBinary(m1,m2,SymMatSumOp());
+}
+
+template<typename _Scalar,int _Order>
+SymMatBatch<_Scalar,_Order> sub(const SymMatBatch<_Scalar,_Order>& m1,const SymMatBatch<_Scalar,_Order>& m2)
+{
+	return SymMatInternal::batchBinary(m1,m2,SymMatDifferenceOp());
+}
+
+
+/*************************************************************************************************
+						TRACE AND MATRIX-VECTOR PRODUCT
+trace(B)(b) = trace of matrix b,   spmv: row b of Y = S_b * (row b of X)
+**************************************************************************************************/
+template<typename _Scalar,int _Order>
+Eigen::Matrix<_Scalar,Eigen::Dynamic,1> trace(const SymMatBatch<_Scalar,_Order>& m1)
+{
+	typedef SymMat<_Scalar,_Order> Matrix;
+	Eigen::Matrix<_Scalar,Eigen::Dynamic,1> t=Eigen::Matrix<_Scalar,Eigen::Dynamic,1>::Zero(m1.count);
+	_Scalar* pt=t.data();
+	SymMatInternal::batchChunks(m1.count,[&](Eigen::Index first,Eigen::Index last)
+	{
+		for(int i=0;i<_Order;i++)
+		{
+			const _Scalar* a=m1.plane(Matrix::index(i,i));
+			for(Eigen::Index p=first;p<last;p++)
+			{
+				pt[p]+=a[p];
+			}
+		}
+	});
+	return t;
+}
+
+template<typename _Scalar,int _Order>
+void spmv(const SymMatBatch<_Scalar,_Order>& m1,const typename SymMatBatch<_Scalar,_Order>::Vectors& x,typename SymMatBatch<_Scalar,_Order>::Vectors& y)
+{
+	typedef SymMat<_Scalar,_Order> Matrix;
+	assert(x.rows()==m1.count);       //Condition for the batches to be conformable
+	y.setZero(m1.count,_Order);
+	SymMatInternal::batchChunks(m1.count,[&](Eigen::Index first,Eigen::Index last)
+	{
+		for(int i=0;i<_Order;i++)
+		{
+			_Scalar* yi=&y(0,i);
+			for(int j=0;j<_Order;j++)
+			{
+				const _Scalar* a=m1.plane(Matrix::index(i,j));
+				const _Scalar* xj=&x(0,j);
+				for(Eigen::Index p=first;p<last;p++)
+				{
+					yi[p]+=a[p]*xj[p];
+				}
+			}
+		}
+	});
+}
+
+
+/*************************************************************************************************
+						DETERMINANT AND INVERSE(ORDER 2 AND 3)
+Closed forms on the planes, packed elements of order 3:  a b c / d e / f  (order 2:  a b / d)
+The inverse is the adjugate divided by the determinant, the adjugate of a symmetric matrix being
+symmetric too.
+**************************************************************************************************/
+template<typename _Scalar,int _Order>
+Eigen::Matrix<_Scalar,Eigen::Dynamic,1> determinant(const SymMatBatch<_Scalar,_Order>& m1)
+{
+	static_assert(_Order==2 || _Order==3,"closed form determinant is only for order 2 and 3");
+	Eigen::Matrix<_Scalar,Eigen::Dynamic,1> det(m1.count);
+	_Scalar* pd=det.data();
+	SymMatInternal::batchChunks(m1.count,[&](Eigen::Index first,Eigen::Index last)
+	{
+		if(_Order==2)
+		{
+			const _Scalar *a=m1.plane(0),*b=m1.plane(1),*d=m1.plane(2);
+			for(Eigen::Index p=first;p<last;p++)
+			{
+				pd[p]=a[p]*d[p]-b[p]*b[p];
+			}
+		}
+		else
+		{
+			const _Scalar *a=m1.plane(0),*b=m1.plane(1),*c=m1.plane(2);
+			const _Scalar *d=m1.plane(_Order==3 ? 3 : 0),*e=m1.plane(_Order==3 ? 4 : 0),*f=m1.plane(_Order==3 ? 5 : 0);
+			for(Eigen::Index p=first;p<last;p++)
+			{
+				pd[p]=a[p]*(d[p]*f[p]-e[p]*e[p])-b[p]*(b[p]*f[p]-c[p]*e[p])+c[p]*(b[p]*e[p]-c[p]*d[p]);
+			}
+		}
+	});
+	return det;
+}
+
+template<typename _Scalar,int _Order>
+SymMatBatch<_Scalar,_Order> inverse(const SymMatBatch<_Scalar,_Order>& m1)
+{
+	static_assert(_Order==2 || _Order==3,"closed form inverse is only for order 2 and 3");
+	SymMatBatch<_Scalar,_Order> m2(m1.count);
+	SymMatInternal::batchChunks(m1.count,[&](Eigen::Index first,Eigen::Index last)
+	{
+		if(_Order==2)
+		{
+			const _Scalar *a=m1.plane(0),*b=m1.plane(1),*d=m1.plane(2);
+			_Scalar *ia=m2.plane(0),*ib=m2.plane(1),*id=m2.plane(2);
+			for(Eigen::Index p=first;p<last;p++)
+			{
+				const _Scalar r=_Scalar(1)/(a[p]*d[p]-b[p]*b[p]);
+				ia[p]=d[p]*r;
+				ib[p]=-b[p]*r;
+				id[p]=a[p]*r;
+			}
+		}
+		else
+		{
+			const int k3=_Order==3 ? 3 : 0,k4=_Order==3 ? 4 : 0,k5=_Order==3 ? 5 : 0;
+			const _Scalar *a=m1.plane(0),*b=m1.plane(1),*c=m1.plane(2),*d=m1.plane(k3),*e=m1.plane(k4),*f=m1.plane(k5);
+			_Scalar *ia=m2.plane(0),*ib=m2.plane(1),*ic=m2.plane(2),*id=m2.plane(k3),*ie=m2.plane(k4),*iff=m2.plane(k5);
+			for(Eigen::Index p=first;p<last;p++)
+			{
+				const _Scalar A=d[p]*f[p]-e[p]*e[p],B=c[p]*e[p]-b[p]*f[p],C=b[p]*e[p]-c[p]*d[p];
+				const _Scalar r=_Scalar(1)/(a[p]*A+b[p]*B+c[p]*C);
+				ia[p]=A*r;
+				ib[p]=B*r;
+				ic[p]=C*r;
+				id[p]=(a[p]*f[p]-c[p]*c[p])*r;
+				ie[p]=(b[p]*c[p]-a[p]*e[p])*r;
+				iff[p]=(a[p]*d[p]-b[p]*b[p])*r;
+			}
+		}
+	});
+	return m2;
+}
+
+
+/*************************************************************************************************
+						EIGENVALUES AND EIGENVECTORS(ORDER 2 AND 3)
+						-------------------------------------------
+eigenvalues(B,values)				values(b,i) is eigenvalue i of matrix b(in increasing order)
+eigenvectors(B,values,vectors)		vectors(b,j*N+i) is component i of eigenvector j of matrix b
+
+Order 2:- the rotation angle t = atan2(2b,a-d)/2 gives both eigenvectors (cos t,sin t) and(-sin t,cos t),
+without any branch.
+Order 3:- the matrix is shifted by trace/3 and scaled, and the eigenvalues are the roots of the
+characteristic cubic found with the trigonometric formula(no branches, so the values only loop
+vectorizes). The eigenvectors are found from cross products of the rows of A - lambda*I in a second pass
+over each block of a chunk: every candidate(and the vector used for (nearly) repeated eigenvalues) is
+computed and the right one selected without branches, so that loop vectorizes as well.
+**************************************************************************************************/
+namespace SymMatInternal
+{
+
+//Eigenvalues(increasing) of the matrix  a b c / d e / f  already shifted and scaled
+template<typename _Scalar>
+inline void cubicRoots(_Scalar a,_Scalar b,_Scalar c,_Scalar d,_Scalar e,_Scalar f,_Scalar* w)
+{
+	const _Scalar inv3=_Scalar(1)/_Scalar(3),sqrt3=std::sqrt(_Scalar(3));
+
+	//Characteristic equation  x^3 - c2*x^2 + c1*x - c0 = 0
+	const _Scalar c0=a*d*f+2*b*c*e-a*e*e-d*c*c-f*b*b;
+	const _Scalar c1=a*d-b*b+a*f-c*c+d*f-e*e;
+	const _Scalar c2=a+d+f;
+	const _Scalar c2over3=c2*inv3;
+	_Scalar aover3=(c2*c2over3-c1)*inv3;
+	aover3= aover3>_Scalar(0) ? aover3 : _Scalar(0);
+	const _Scalar halfb=_Scalar(0.5)*(c0+c2over3*(2*c2over3*c2over3-c1));
+	_Scalar q=aover3*aover3*aover3-halfb*halfb;
+	q= q>_Scalar(0) ? q : _Scalar(0);
+
+	const _Scalar rho=std::sqrt(aover3);
+	const _Scalar theta=std::atan2(std::sqrt(q),halfb)*inv3;
+	const _Scalar ct=std::cos(theta),st=std::sin(theta);
+	w[0]=c2over3-rho*(ct+sqrt3*st);
+	w[1]=c2over3-rho*(ct-sqrt3*st);
+	w[2]=c2over3+2*rho*ct;
+}
+
+//Unit vector v in the kernel of the (nearly) singular matrix  a-l b c / d-l e / f-l, and its row of largest
+//norm(orthogonal to v). The cross product of the two rows spanning the range best is taken, all three are
+//computed and selected without branches so that the loop over a chunk vectorizes
+template<typename _Scalar>
+inline void kernelVector(_Scalar a,_Scalar b,_Scalar c,_Scalar d,_Scalar e,_Scalar f,_Scalar l,_Scalar* v,_Scalar* row)
+{
+	a-=l;
+	d-=l;
+	f-=l;
+	//Rows (a,b,c) (b,d,e) (c,e,f), crossed two by two
+	const _Scalar x01=b*e-c*d,y01=c*b-a*e,z01=a*d-b*b;
+	const _Scalar x02=b*f-c*e,y02=c*c-a*f,z02=a*e-b*c;
+	const _Scalar x12=d*f-e*e,y12=e*c-b*f,z12=b*e-d*c;
+	const _Scalar n01=x01*x01+y01*y01+z01*z01,n02=x02*x02+y02*y02+z02*z02,n12=x12*x12+y12*y12+z12*z12;
+	const bool use01= n01>=n02 && n01>=n12,use02= !use01 && n02>=n12;
+	const _Scalar n= use01 ? n01 : (use02 ? n02 : n12);
+	const _Scalar r= n>_Scalar(0) ? _Scalar(1)/std::sqrt(n) : _Scalar(0);
+	v[0]=(use01 ? x01 : (use02 ? x02 : x12))*r;
+	v[1]=(use01 ? y01 : (use02 ? y02 : y12))*r;
+	v[2]=(use01 ? z01 : (use02 ? z02 : z12))*r;
+
+	const _Scalar s0=a*a+b*b+c*c,s1=b*b+d*d+e*e,s2=c*c+e*e+f*f;
+	const bool use0= s0>=s1 && s0>=s2,use1= !use0 && s1>=s2;
+	row[0]= use0 ? a : (use1 ? b : c);
+	row[1]= use0 ? b : (use1 ? d : e);
+	row[2]= use0 ? c : (use1 ? e : f);
+}
+
+} //namespace SymMatInternal
+
+template<typename _Scalar,int _Order>
+void eigenvalues(const SymMatBatch<_Scalar,_Order>& m1,typename SymMatBatch<_Scalar,_Order>::Vectors& values)
+{
+	static_assert(_Order==2 || _Order==3,"closed form eigenvalues are only for order 2 and 3");
+	values.resize(m1.count,_Order);
+	SymMatInternal::batchChunks(m1.count,[&](Eigen::Index first,Eigen::Index last)
+	{
+		_Scalar* w0=&values(0,0);
+		_Scalar* w1=&values(0,1);
+		if(_Order==2)
+		{
+			const _Scalar *a=m1.plane(0),*b=m1.plane(1),*d=m1.plane(2);
+			for(Eigen::Index p=first;p<last;p++)
+			{
+				const _Scalar mid=_Scalar(0.5)*(a[p]+d[p]),h=_Scalar(0.5)*(a[p]-d[p]);
+				const _Scalar r=std::sqrt(h*h+b[p]*b[p]);
+				w0[p]=mid-r;
+				w1[p]=mid+r;
+			}
+		}
+		else
+		{
+			const int k3=_Order==3 ? 3 : 0,k4=_Order==3 ? 4 : 0,k5=_Order==3 ? 5 : 0;
+			const _Scalar *a=m1.plane(0),*b=m1.plane(1),*c=m1.plane(2),*d=m1.plane(k3),*e=m1.plane(k4),*f=m1.plane(k5);
+			_Scalar* w2=&values(0,_Order-1);
+			for(Eigen::Index p=first;p<last;p++)
+			{
+				//Shifted by trace/3 and scaled, the roots come out in increasing order
+				const _Scalar shift=(a[p]+d[p]+f[p])/_Scalar(3);
+				const _Scalar aa=a[p]-shift,dd=d[p]-shift,ff=f[p]-shift;
+				_Scalar scale=std::max(std::max(std::max(std::abs(aa),std::abs(dd)),std::max(std::abs(ff),std::abs(b[p]))),
+									   std::max(std::abs(c[p]),std::abs(e[p])));
+				scale= scale>_Scalar(0) ? scale : _Scalar(1);
+				const _Scalar r=_Scalar(1)/scale;
+				_Scalar w[3];
+				SymMatInternal::cubicRoots(aa*r,b[p]*r,c[p]*r,dd*r,e[p]*r,ff*r,w);
+				w0[p]=w[0]*scale+shift;
+				w1[p]=w[1]*scale+shift;
+				w2[p]=w[2]*scale+shift;
+			}
+		}
+	});
+}
+
+template<typename _Scalar,int _Order>
+void eigenvectors(const SymMatBatch<_Scalar,_Order>& m1,typename SymMatBatch<_Scalar,_Order>::Vectors& values,
+				  typename SymMatBatch<_Scalar,_Order>::Matrices& vectors)
+{
+	static_assert(_Order==2 || _Order==3,"closed form eigenvectors are only for order 2 and 3");
+	values.resize(m1.count,_Order);
+	vectors.resize(m1.count,_Order*_Order);
+	SymMatInternal::batchChunks(m1.count,[&](Eigen::Index first,Eigen::Index last)
+	{
+		if(_Order==2)
+		{
+			const _Scalar *a=m1.plane(0),*b=m1.plane(1),*d=m1.plane(2);
+			_Scalar *w0=&values(0,0),*w1=&values(0,1);
+			_Scalar *v00=&vectors(0,0),*v10=&vectors(0,1),*v01=&vectors(0,2),*v11=&vectors(0,3);
+			for(Eigen::Index p=first;p<last;p++)
+			{
+				const _Scalar mid=_Scalar(0.5)*(a[p]+d[p]),h=_Scalar(0.5)*(a[p]-d[p]);
+				const _Scalar r=std::sqrt(h*h+b[p]*b[p]);
+				const _Scalar t=_Scalar(0.5)*std::atan2(b[p],h);
+				const _Scalar ct=std::cos(t),st=std::sin(t);
+				w0[p]=mid-r;
+				w1[p]=mid+r;
+				v00[p]=-st;  v10[p]=ct;		//eigenvector of the smaller eigenvalue
+				v01[p]=ct;   v11[p]=st;
+			}
+		}
+		else
+		{
+			const _Scalar eps=std::numeric_limits<_Scalar>::epsilon();
+			const int k3=_Order==3 ? 3 : 0,k4=_Order==3 ? 4 : 0,k5=_Order==3 ? 5 : 0;
+			const _Scalar *a=m1.plane(0),*b=m1.plane(1),*c=m1.plane(2),*d=m1.plane(k3),*e=m1.plane(k4),*f=m1.plane(k5);
+
+			//The chunk is done a block at a time, the passes keep their results in local planes(which
+			//the compiler knows are not the batch, so the loops need no alias checks to vectorize)
+			enum { Block=64 };
+			_Scalar shift[Block],scale[Block],x0[Block],x1[Block],x2[Block],out[9][Block];
+			for(Eigen::Index start=first;start<last;start+=Block)
+			{
+				const int n=int(std::min(Eigen::Index(Block),last-start));
+				const _Scalar *ab=a+start,*bb=b+start,*cb=c+start,*db=d+start,*eb=e+start,*fb=f+start;
+
+				//Roots of the shifted and scaled matrices
+				for(int q=0;q<n;q++)
+				{
+					shift[q]=(ab[q]+db[q]+fb[q])/_Scalar(3);
+					const _Scalar aa=ab[q]-shift[q],dd=db[q]-shift[q],ff=fb[q]-shift[q];
+					_Scalar s=std::max(std::max(std::max(std::abs(aa),std::abs(dd)),std::max(std::abs(ff),std::abs(bb[q]))),
+									   std::max(std::abs(cb[q]),std::abs(eb[q])));
+					s= s>_Scalar(0) ? s : _Scalar(1);
+					const _Scalar r=_Scalar(1)/s;
+					_Scalar w[3];
+					SymMatInternal::cubicRoots(aa*r,bb[q]*r,cb[q]*r,dd*r,eb[q]*r,ff*r,w);
+					x0[q]=w[0];
+					x1[q]=w[1];
+					x2[q]=w[2];
+					scale[q]=s;
+				}
+
+				//Eigenvectors, the one of the eigenvalue farthest from the others is found first
+				for(int q=0;q<n;q++)
+				{
+					const _Scalar r=_Scalar(1)/scale[q];
+					const _Scalar aa=(ab[q]-shift[q])*r,bq=bb[q]*r,cq=cb[q]*r,dd=(db[q]-shift[q])*r,eq=eb[q]*r,ff=(fb[q]-shift[q])*r;
+					const _Scalar d0=x2[q]-x1[q],d1=x1[q]-x0[q];
+					const bool far2= d0>d1;
+					_Scalar vk[3],rep[3],vl[3],unused[3];
+					SymMatInternal::kernelVector(aa,bq,cq,dd,eq,ff,far2 ? x2[q] : x0[q],vk,rep);
+					SymMatInternal::kernelVector(aa,bq,cq,dd,eq,ff,far2 ? x0[q] : x2[q],vl,unused);
+
+					//The other two eigenvalues are the same, any unit vector orthogonal to vk will do
+					const _Scalar kr=vk[0]*rep[0]+vk[1]*rep[1]+vk[2]*rep[2];
+					const _Scalar o0=rep[0]-kr*vk[0],o1=rep[1]-kr*vk[1],o2=rep[2]-kr*vk[2];
+					const _Scalar on=o0*o0+o1*o1+o2*o2,oi= on>_Scalar(0) ? _Scalar(1)/std::sqrt(on) : _Scalar(0);
+					const bool pair= d0<=2*eps*d1 || d1<=2*eps*d0;
+					vl[0]= pair ? o0*oi : vl[0];
+					vl[1]= pair ? o1*oi : vl[1];
+					vl[2]= pair ? o2*oi : vl[2];
+
+					//Columns 0 and 2, the middle one is their cross product
+					const _Scalar p0= far2 ? vl[0] : vk[0],p1= far2 ? vl[1] : vk[1],p2= far2 ? vl[2] : vk[2];
+					const _Scalar q0= far2 ? vk[0] : vl[0],q1= far2 ? vk[1] : vl[1],q2= far2 ? vk[2] : vl[2];
+					const _Scalar u0=q1*p2-q2*p1,u1=q2*p0-q0*p2,u2=q0*p1-q1*p0;
+					const _Scalar un=u0*u0+u1*u1+u2*u2,ui= un>_Scalar(0) ? _Scalar(1)/std::sqrt(un) : _Scalar(0);
+
+					//All the eigenvalues are the same
+					const bool same= x2[q]-x0[q]<=eps;
+					const _Scalar one=_Scalar(1),zero=_Scalar(0);
+					out[0][q]=same ? one : p0;          out[1][q]=same ? zero : p1;         out[2][q]=same ? zero : p2;
+					out[3][q]=same ? zero : u0*ui;      out[4][q]=same ? one : u1*ui;       out[5][q]=same ? zero : u2*ui;
+					out[6][q]=same ? zero : q0;         out[7][q]=same ? zero : q1;         out[8][q]=same ? one : q2;
+					x0[q]=x0[q]*scale[q]+shift[q];
+					x1[q]=x1[q]*scale[q]+shift[q];
+					x2[q]=x2[q]*scale[q]+shift[q];
+				}
+
+				for(int q=0;q<n;q++)
+				{
+					values(start+q,0)=x0[q];
+					values(start+q,_Order/2)=x1[q];
+					values(start+q,_Order-1)=x2[q];
+				}
+				for(int k=0;k<_Order*_Order;k++)
+				{
+					_Scalar* vk=&vectors(start,k);
+					for(int q=0;q<n;q++)
+					{
+						vk[q]=out[k][q];
+					}
+				}
+			}
+		}
+	});
+}
+
+
+//------------------------------------------------------------------------------------------------
+#endif //SYMMAT_BATCH_H
+/*************************************************************************************************
+								SYMMAT BATCH HEADER FILE ENDED
+**************************************************************************************************/
@@ -0,0 +1,547 @@
+/***********************************************************************************************
+This header file contains SymMatCovariance - the mean and covariance of a stream of observations
+
+Each observation is a row of order values(one per feature). The rows arrive in batches and are never
+kept, so the stream can be much larger than the memory. What is kept is the no. of rows, their mean
+and the scatter matrix about the mean,
+
+	M2 = sum (x - mean)*(x - mean)^T
+
+in a packed SymMat, from which the covariance(M2/(count-1)) and the Gram matrix(X^T*X = M2 +
+count*mean*mean^T) are computed. Summing x*x^T and subtracting count*mean*mean^T at the end loses all
+the digits for data far from the origin, so the rows are centered before they are added.
+
+Efficiency improvement:-
+A batch is split between the threads, and every thread keeps its own partial result(no. of rows,
+mean and M2) for the whole stream, so the threads never write to the same memory and nothing is
+merged while the rows are added. Each thread centers a chunk of at most SYMMAT_COVARIANCE_CHUNK rows
+about the mean of the chunk, adds it to its M2 with syrk and merges the chunk into its partial with
+Chan's formula(na and nb rows, delta = meanb - meana),
+
+	M2   = M2a + M2b + (na*nb/(na+nb))*delta*delta^T		(one spr)
+	mean = meana + (nb/(na+nb))*delta
+
+The partials are merged with the same formula only when a result is asked for(snapshot), always in
+the order of the threads, so the result depends on the batches and the no. of threads but never on
+which thread finished first.
+
+SymMatRowReader reads the rows from a binary file(row major values of _Scalar) or a CSV file, and
+accumulate() reads the next batch on another thread while the current one is being added. std::async
+needs -pthread on the systems with glibc older than 2.34.
+
+************************************************************************************************/
+//-----------------------------------------------------------------------------------------------
+
+
+/************************************************************************************************
+						INCLUDE GAURDS
+*************************************************************************************************/
+#ifndef SYMMAT_COVARIANCE_H
+#define SYMMAT_COVARIANCE_H
+
+
+/*************************************************************************************************
+						INCLUDING THE DEPENDENCIES
+**************************************************************************************************/
+#include "SymMat.h"				//packed SymMat, syrk and spr
+#include <string>				//file names
+#include <cstdio>				//to use fopen and fread
+#include <cstdlib>				//to use strtod
+#include <future>				//to read the next batch with std::async
+
+//Rows centered and added to the scatter matrix at a time by each thread
+#ifndef SYMMAT_COVARIANCE_CHUNK
+#define SYMMAT_COVARIANCE_CHUNK 1024
+#endif
+
+//Rows read from a file for each batch by accumulate()
+#ifndef SYMMAT_COVARIANCE_BATCH
+#define SYMMAT_COVARIANCE_BATCH 8192
+#endif
+
+
+/*************************************************************************************************
+						CLASS DEFINITION
+**************************************************************************************************/
+template <typename _Scalar>
+class SymMatCovariance
+{
+public:
+
+	typedef _Scalar Scalar;
+	typedef Eigen::Matrix<_Scalar,Eigen::Dynamic,1> Vector;
+
+	//No. of rows, mean and scatter matrix of the rows added by one thread
+	struct Partial
+	{
+		Eigen::Index count;
+		Vector mean;
+		SymMat<_Scalar> scatter;
+
+		//The centered chunk(row major) and its mean, kept so that they are allocated only once
+		std::vector<_Scalar> centered;
+		Vector chunkMean;
+	};
+
+	//No. of values in each row
+	int order;
+
+	//One partial result per thread
+	std::vector<Partial> partials;
+
+	//Accumulator of rows of o values, with no rows
+	explicit SymMatCovariance(int o=3) :order(o) { reset(); }
+
+	//Forgets all the rows
+	void reset();
+
+	//Adds the rows of X(one observation per row, order columns)
+	template<typename _Derived>
+	void add(const Eigen::MatrixBase<_Derived>& X);
+
+	//Adds rows of order values stored one after another
+	void add(const _Scalar* rows,Eigen::Index count);
+
+	//Adds all the rows of another accumulator(e.g. of another part of the stream)
+	void merge(const SymMatCovariance& other);
+
+	//No. of rows added so far
+	Eigen::Index count() const;
+
+	//Mean and covariance of the rows so far(divided by count-1, or by count when sample is false)
+	void snapshot(Vector& mean,SymMat<_Scalar>& covariance,bool sample=true) const;
+	SymMat<_Scalar> covariance(bool sample=true) const;
+	Vector mean() const;
+
+	//X^T*X of the rows so far
+	SymMat<_Scalar> gram() const;
+
+private:
+
+	//Mean and scatter matrix of all the partials, merged in order
+	void combine(Eigen::Index& n,Vector& mean,SymMat<_Scalar>& scatter) const;
+};
+
+
+namespace SymMatInternal
+{
+
+//Merges nb rows of mean meanb(and scatter matrix already added to scatter) into na rows of mean meana
+template<typename _Scalar>
+void chanMerge(Eigen::Index& na,Eigen::Matrix<_Scalar,Eigen::Dynamic,1>& meana,SymMat<_Scalar>& scatter,
+			   Eigen::Index nb,const Eigen::Matrix<_Scalar,Eigen::Dynamic,1>& meanb)
+{
+	if(nb==0)
+	{
+		return;
+	}
+	const Eigen::Index n=na+nb;
+	if(na>0)
+	{
+		Eigen::Matrix<_Scalar,Eigen::Dynamic,1>& delta=meana; //meana is not needed once delta is known
+		const _Scalar wb=_Scalar(double(nb)/double(n));
+		delta=meanb-meana;
+		spr(_Scalar(double(na)*wb),delta.data(),scatter);
+		meana=meanb-(_Scalar(1)-wb)*delta; //meana + wb*delta, from delta
+	}
+	else
+	{
+		meana=meanb;
+	}
+	na=n;
+}
+
+//Adds the rows first..last-1 of X to the partial p, a chunk at a time
+template<typename _Scalar,typename _MatrixType,typename _Partial>
+void covarianceRows(const _MatrixType& X,Eigen::Index first,Eigen::Index last,_Partial& p)
+{
+	typedef Eigen::Map< Eigen::Matrix<_Scalar,Eigen::Dynamic,Eigen::Dynamic,Eigen::RowMajor> > RowMajorMap;
+	const Eigen::Index n=X.cols();
+	for(Eigen::Index r=first;r<last;r+=SYMMAT_COVARIANCE_CHUNK)
+	{
+		const Eigen::Index rows=std::min(Eigen::Index(SYMMAT_COVARIANCE_CHUNK),last-r);
+		if(p.centered.size()<size_t(rows*n))
+		{
+			p.centered.resize(size_t(SYMMAT_COVARIANCE_CHUNK*n));
+		}
+		RowMajorMap C(p.centered.data(),rows,n);
+		p.chunkMean=X.middleRows(r,rows).colwise().mean().transpose();
+		C=X.middleRows(r,rows).rowwise()-p.chunkMean.transpose();
+
+		//M2b is added straight into the scatter matrix, only the delta term is left for the merge
+		syrk(_Scalar(1),C.transpose(),_Scalar(1),p.scatter);
+		chanMerge(p.count,p.mean,p.scatter,rows,p.chunkMean);
+	}
+}
+
+} //namespace SymMatInternal
+
+
+/*************************************************************************************************
+						MEMBER FUNCTIONS
+**************************************************************************************************/
+template<typename _Scalar>
+void SymMatCovariance<_Scalar>::reset()
+{
+	int threads=1;
+#ifdef _OPENMP
+	threads=omp_get_max_threads();
+#endif
+	partials.resize(size_t(threads));
+	for(size_t t=0;t<partials.size();t++)
+	{
+		partials[t].count=0;
+		partials[t].mean=Vector::Zero(order);
+		partials[t].scatter=SymMat<_Scalar>(order);
+	}
+}
+
+template<typename _Scalar>
+template<typename _Derived>
+void SymMatCovariance<_Scalar>::add(const Eigen::MatrixBase<_Derived>& X)
+{
+	assert(X.cols()==order); //Condition for the rows to be observations of the same features
+	SYMMAT_TRACE_OP("covariance.add",_Scalar,order,X.size(),sizeof(_Scalar)*(X.size()+partials[0].scatter.mat.size()));
+	//Expressions are evaluated once, plain matrices and maps are used directly
+	typename Eigen::internal::nested_eval<_Derived,2>::type x(X.derived());
+	const Eigen::Index rows=x.rows();
+
+#ifdef _OPENMP
+	//Each thread needs enough rows to pay for its merge(one spr) and the parallel region
+	int threads=omp_get_max_threads();
+	if(threads>1 && !omp_in_parallel() && rows>=2*Eigen::Index(threads)
+	   && double(rows)*order*order>=double(SYMMAT_PARALLEL_THRESHOLD)*SYMMAT_PARALLEL_THRESHOLD*order)
+	{
+		if(partials.size()<size_t(threads))
+		{
+			const size_t old=partials.size();
+			partials.resize(size_t(threads));
+			for(size_t t=old;t<partials.size();t++)
+			{
+				partials[t].count=0;
+				partials[t].mean=Vector::Zero(order);
+				partials[t].scatter=SymMat<_Scalar>(order);
+			}
+		}
+
+		//Part t always goes to partial t, whichever thread of the team(which can be smaller) adds it
+		#pragma omp parallel num_threads(threads)
+		{
+			for(int t=omp_get_thread_num();t<threads;t+=omp_get_num_threads())
+			{
+				SymMatInternal::covarianceRows<_Scalar>(x,(rows*t)/threads,(rows*(t+1))/threads,partials[t]);
+			}
+		}
+		return;
+	}
+#endif
+	SymMatInternal::covarianceRows<_Scalar>(x,0,rows,partials[0]);
+}
+
+template<typename _Scalar>
+void SymMatCovariance<_Scalar>::add(const _Scalar* rows,Eigen::Index count)
+{
+	typedef Eigen::Map< const Eigen::Matrix<_Scalar,Eigen::Dynamic,Eigen::Dynamic,Eigen::RowMajor> > RowMajorMap;
+	add(RowMajorMap(rows,count,order));
+}
+
+template<typename _Scalar>
+void SymMatCovariance<_Scalar>::merge(const SymMatCovariance& other)
+{
+	assert(other.order==order); //Condition for both accumulators to have the same features
+	Eigen::Index n;
+	Vector m;
+	SymMat<_Scalar> s(order);
+	other.combine(n,m,s);
+	partials[0].scatter+=s;
+	SymMatInternal::chanMerge(partials[0].count,partials[0].mean,partials[0].scatter,n,m);
+}
+
+template<typename _Scalar>
+Eigen::Index SymMatCovariance<_Scalar>::count() const
+{
+	Eigen::Index n=0;
+	for(size_t t=0;t<partials.size();t++)
+	{
+		n+=partials[t].count;
+	}
+	return n;
+}
+
+template<typename _Scalar>
+void SymMatCovariance<_Scalar>::combine(Eigen::Index& n,Vector& mean,SymMat<_Scalar>& scatter) const
+{
+	n=partials[0].count;
+	mean=partials[0].mean;
+	scatter=partials[0].scatter;
+	for(size_t t=1;t<partials.size();t++)
+	{
+		if(partials[t].count>0)
+		{
+			scatter+=partials[t].scatter;
+			SymMatInternal::chanMerge(n,mean,scatter,partials[t].count,partials[t].mean);
+		}
+	}
+}
+
+template<typename _Scalar>
+void SymMatCovariance<_Scalar>::snapshot(Vector& mean,SymMat<_Scalar>& covariance,bool sample) const
+{
+	SYMMAT_TRACE_OP("covariance.snapshot",_Scalar,order,Eigen::Index(partials.size())*partials[0].scatter.mat.size(),
+					sizeof(_Scalar)*partials.size()*partials[0].scatter.mat.size());
+	Eigen::Index n;
+	combine(n,mean,covariance);
+	const Eigen::Index dof= sample ? n-1 : n;
+	if(dof>0)
+	{
+		covariance/=_Scalar(dof);
+	}
+}
+
+template<typename _Scalar>
+SymMat<_Scalar> SymMatCovariance<_Scalar>::covariance(bool sample) const
+{
+	Vector m;
+	SymMat<_Scalar> c(order);
+	snapshot(m,c,sample);
+	return c;
+}
+
+template<typename _Scalar>
+typename SymMatCovariance<_Scalar>::Vector SymMatCovariance<_Scalar>::mean() const
+{
+	Eigen::Index n=0;
+	Vector m=Vector::Zero(order);
+	for(size_t t=0;t<partials.size();t++)
+	{
+		if(partials[t].count>0)
+		{
+			n+=partials[t].count;
+			m+=(_Scalar(double(partials[t].count)/double(n)))*(partials[t].mean-m);
+		}
+	}
+	return m;
+}
+
+template<typename _Scalar>
+SymMat<_Scalar> SymMatCovariance<_Scalar>::gram() const
+{
+	Eigen::Index n;
+	Vector m;
+	SymMat<_Scalar> g(order);
+	combine(n,m,g);
+	spr(_Scalar(n),m.data(),g);
+	return g;
+}
+
+
+/*************************************************************************************************
+						READING THE ROWS FROM A FILE
+**************************************************************************************************/
+//Formats of the files of rows
+enum SymMatRowFormat { SymMatRowsBinary, SymMatRowsCsv, SymMatRowsCsvHeader };
+
+/*
+Reads rows of order values from a file: binary(the values of each row one after another, as _Scalar)
+or CSV(one row per line, the values separated by commas, SymMatRowsCsvHeader skips the first line).
+A short last row or a line with a wrong no. of values stops the reading and sets failed.
+*/
+template <typename _Scalar>
+class SymMatRowReader
+{
+public:
+
+	SymMatRowReader(const std::string& path,int o,SymMatRowFormat f=SymMatRowsBinary)
+		:order(o),format(f),failed(false),begin(0),end(0)
+	{
+		file=std::fopen(path.c_str(),"rb");
+		if(file && format!=SymMatRowsBinary)
+		{
+			text.resize(1<<16);
+			const char* line;
+			size_t length;
+			if(format==SymMatRowsCsvHeader && !nextLine(line,length))
+			{
+				failed=true;
+			}
+		}
+	}
+
+	~SymMatRowReader() { if(file) std::fclose(file); }
+
+	bool isOpen() const { return file!=0; }
+
+	//Reads at most maxRows rows into rows(row major), returns the no. of rows read(0 at the end)
+	Eigen::Index read(_Scalar* rows,Eigen::Index maxRows);
+
+	//No. of values in each row
+	int order;
+
+	SymMatRowFormat format;
+
+	//Set when the file ends inside a row or a line cannot be read
+	bool failed;
+
+private:
+
+	SymMatRowReader(const SymMatRowReader&);
+	SymMatRowReader& operator=(const SymMatRowReader&);
+
+	//Next line of the text without its end of line, false at the end of the file
+	bool nextLine(const char*& line,size_t& length);
+
+	//Parses the values of one line into row
+	bool parseLine(const char* line,size_t length,_Scalar* row);
+
+	std::FILE* file;
+
+	//Text read from the file but not parsed yet is text[begin..end)
+	std::vector<char> text;
+	size_t begin,end;
+	std::vector<char> field;
+};
+
+template<typename _Scalar>
+bool SymMatRowReader<_Scalar>::nextLine(const char*& line,size_t& length)
+{
+	for(;;)
+	{
+		const char* start=text.data()+begin;
+		const char* newline=(const char*)std::memchr(start,'\n',end-begin);
+		if(newline)
+		{
+			line=start;
+			length=size_t(newline-start);
+			begin+=length+1;
+			if(length>0 && line[length-1]=='\r')
+			{
+				length--;
+			}
+			return true;
+		}
+
+		//Moves the unfinished line to the front and reads more after it(the buffer grows for long lines)
+		std::memmove(text.data(),start,end-begin);
+		end-=begin;
+		begin=0;
+		if(end==text.size())
+		{
+			text.resize(2*text.size());
+		}
+		const size_t got=std::fread(text.data()+end,1,text.size()-end,file);
+		if(got==0)
+		{
+			//The last line may have no end of line
+			if(end==0)
+			{
+				return false;
+			}
+			line=text.data();
+			length=end;
+			begin=end;
+			return true;
+		}
+		end+=got;
+	}
+}
+
+template<typename _Scalar>
+bool SymMatRowReader<_Scalar>::parseLine(const char* line,size_t length,_Scalar* row)
+{
+	//strtod needs a terminated string
+	field.assign(line,line+length);
+	field.push_back('\0');
+	const char* p=field.data();
+	for(int k=0;k<order;k++)
+	{
+		char* next;
+		row[k]=_Scalar(std::strtod(p,&next));
+		if(next==p)
+		{
+			return false;
+		}
+		p=next;
+		while(*p==' ' || *p=='\t')
+		{
+			p++;
+		}
+		if(k+1<order)
+		{
+			if(*p!=',')
+			{
+				return false;
+			}
+			p++;
+		}
+	}
+	return *p=='\0';
+}
+
+template<typename _Scalar>
+Eigen::Index SymMatRowReader<_Scalar>::read(_Scalar* rows,Eigen::Index maxRows)
+{
+	if(!file || failed)
+	{
+		return 0;
+	}
+	if(format==SymMatRowsBinary)
+	{
+		const size_t values=std::fread(rows,sizeof(_Scalar),size_t(maxRows*order),file);
+		if(values%size_t(order)!=0)
+		{
+			failed=true;
+		}
+		return Eigen::Index(values/size_t(order));
+	}
+
+	Eigen::Index r=0;
+	const char* line;
+	size_t length;
+	while(r<maxRows && nextLine(line,length))
+	{
+		//Empty lines are skipped
+		if(length==0)
+		{
+			continue;
+		}
+		if(!parseLine(line,length,rows+r*order))
+		{
+			failed=true;
+			break;
+		}
+		r++;
+	}
+	return r;
+}
+
+/*
+Adds all the rows of the reader to the accumulator, batch rows at a time. The next batch is read on
+another thread while the current one is added. Returns false when the file could not be read to the end.
+*/
+template<typename _Scalar>
+bool accumulate(SymMatRowReader<_Scalar>& reader,SymMatCovariance<_Scalar>& acc,Eigen::Index batch=SYMMAT_COVARIANCE_BATCH)
+{
+	assert(reader.order==acc.order); //Condition for the rows to be observations of the same features
+	if(!reader.isOpen())
+	{
+		return false;
+	}
+	std::vector<_Scalar> buffer[2];
+	buffer[0].resize(size_t(batch*reader.order));
+	buffer[1].resize(size_t(batch*reader.order));
+
+	Eigen::Index rows=reader.read(buffer[0].data(),batch);
+	for(int k=0;rows>0;k^=1)
+	{
+		_Scalar* next=buffer[k^1].data();
+		std::future<Eigen::Index> reading=std::async(std::launch::async,[&reader,next,batch]{ return reader.read(next,batch); });
+		acc.add(buffer[k].data(),rows);
+		rows=reading.get();
+	}
+	return !reader.failed;
+}
+
+#endif //SYMMAT_COVARIANCE_H
+/*************************************************************************************************
+								SYMMAT COVARIANCE HEADER FILE ENDED
+**************************************************************************************************/
@@ -0,0 +1,589 @@
+/***********************************************************************************************
+This header file contains SymMatHalf - a symmetric matrix stored with 16 bit floats
+
+The kernels on large matrices(spmv, the reductions) are limited by the memory bandwidth: they do
+very little arithmetic for each element they read. SymMatHalf stores the packed vector in half the
+bytes of float, in one of two formats:-
+
+	SymMatFp16	IEEE half		5 bits exponent, 10 bits mantissa, largest value 65504
+	SymMatBf16	bfloat16		8 bits exponent(the range of float), 7 bits mantissa
+
+The elements are only stored with 16 bits. They are converted to float when they are read, and all
+the arithmetic(the reductions, the expressions, spmv, mult) is done in float, or in double(the
+reductions add the sums of the blocks in double, and spmv/mult can be given double vectors).
+
+The conversions use F16C(IEEE half) and AVX-512 BF16(float to bfloat16) when the processor has them,
+otherwise a portable version, which gives the same results(round to nearest even, float denormals
+stored as zero in bfloat16).
+
+************************************************************************************************/
+//-----------------------------------------------------------------------------------------------
+
+
+/************************************************************************************************
+						INCLUDE GAURDS
+*************************************************************************************************/
+#ifndef SYMMAT_HALF_H
+#define SYMMAT_HALF_H
+
+
+/*************************************************************************************************
+						INCLUDING THE DEPENDENCIES
+**************************************************************************************************/
+#include "SymMat.h"				//packed SymMat, expressions and kernels
+#include <stdint.h>				//bits of the 16 bit floats
+
+
+/*************************************************************************************************
+						ERROR BOUNDS
+						------------
+Storing an element rounds it to the nearest 16 bit value, which changes it by at most u times its
+magnitude(u is the unit roundoff of the format):-
+
+	SymMatFp16	u = 2^-11 = 4.9e-4		(values above 65504 become infinity, below 6.1e-5 lose precision)
+	SymMatBf16	u = 2^-8  = 3.9e-3
+
+So for every result computed from the stored matrix H instead of the float matrix S:-
+
+	|H(i,j) - S(i,j)|		<= u*|S(i,j)|
+	|H.sum() - S.sum()|		<= u*sum(|S(i,j)|)			+ the rounding of the sum itself
+	|H*x - S*x|(row i)		<= u*sum_j(|S(i,j)|*|x(j)|)	+ the rounding of the float products
+
+The rounding of the float arithmetic is the same as for SymMat<float>(about n*2^-24 for a row of n
+elements), so for the matrices whose elements do not cancel each other the storage error u
+dominates. The testcases check these bounds against the float results.
+**************************************************************************************************/
+
+
+/*************************************************************************************************
+						16 BIT FLOATS
+**************************************************************************************************/
+namespace SymMatInternal
+{
+
+inline uint32_t floatBits(float f)
+{
+	uint32_t x;
+	std::memcpy(&x,&f,sizeof(x));
+	return x;
+}
+
+inline float bitsFloat(uint32_t x)
+{
+	float f;
+	std::memcpy(&f,&x,sizeof(f));
+	return f;
+}
+
+//IEEE half -> float(exact)
+inline float fp16ToFloat(uint16_t h)
+{
+	const uint32_t sign=uint32_t(h&0x8000)<<16;
+	const uint32_t exponent=(h>>10)&0x1f;
+	const uint32_t mantissa=h&0x3ff;
+	if(exponent==0)		//zero and subnormals: mantissa*2^-24
+	{
+		const float value=float(mantissa)*5.9604644775390625e-8f;
+		return bitsFloat(sign|floatBits(value));
+	}
+	if(exponent==31)	//infinity and NaN
+	{
+		return bitsFloat(sign|0x7f800000|(mantissa<<13));
+	}
+	return bitsFloat(sign|((exponent+112)<<23)|(mantissa<<13));
+}
+
+//float -> IEEE half, rounded to nearest even
+inline uint16_t floatToFp16(float f)
+{
+	uint32_t x=floatBits(f);
+	const uint16_t sign=uint16_t((x>>16)&0x8000);
+	x&=0x7fffffff;
+	if(x>=0x7f800000)	//infinity and NaN(kept quiet)
+	{
+		return sign|(x>0x7f800000 ? 0x7e00 : 0x7c00);
+	}
+	if(x>=0x477ff000)	//65520 and above round to infinity
+	{
+		return sign|0x7c00;
+	}
+	if(x<0x38800000)	//below 2^-14: subnormal half, the value*2^24 rounded to an integer
+	{
+		return sign|uint16_t(std::nearbyint(bitsFloat(x)*16777216.0f));
+	}
+	//The 13 bits dropped are rounded to nearest even, a carry goes into the exponent
+	x+=0xfff+((x>>13)&1);
+	return sign|uint16_t((x-0x38000000)>>13);
+}
+
+//bfloat16 -> float(exact, the 16 high bits of the float)
+inline float bf16ToFloat(uint16_t h)
+{
+	return bitsFloat(uint32_t(h)<<16);
+}
+
+//float -> bfloat16, rounded to nearest even(float denormals become zero, like AVX-512 BF16 does)
+inline uint16_t floatToBf16(float f)
+{
+	const uint32_t x=floatBits(f);
+	if((x&0x7fffffff)>0x7f800000)	//NaN(kept quiet)
+	{
+		return uint16_t((x>>16)|0x40);
+	}
+	if((x&0x7f800000)==0)			//zero and denormals
+	{
+		return uint16_t((x>>16)&0x8000);
+	}
+	return uint16_t((x+0x7fff+((x>>16)&1))>>16);
+}
+
+} //namespace SymMatInternal
+
+//IEEE half precision element
+struct SymMatFp16
+{
+	uint16_t bits;
+
+	SymMatFp16()=default;
+	SymMatFp16(float f) :bits(SymMatInternal::floatToFp16(f)) {}
+	operator float() const { return SymMatInternal::fp16ToFloat(bits); }
+};
+
+//bfloat16 element
+struct SymMatBf16
+{
+	uint16_t bits;
+
+	SymMatBf16()=default;
+	SymMatBf16(float f) :bits(SymMatInternal::floatToBf16(f)) {}
+	operator float() const { return SymMatInternal::bf16ToFloat(bits); }
+};
+
+
+/*************************************************************************************************
+						VECTOR CONVERSIONS
+The kernels read the packed vector through SymMatInternal::Convert, which is specialized here to
+convert whole rows with F16C/AVX2/AVX-512 BF16 when the processor has them. The other element
+types(double) go through float one element at a time.
+**************************************************************************************************/
+namespace SymMatInternal
+{
+
+//Portable conversions of n elements
+inline void fp16ToFloatScalar(const SymMatFp16* src,Eigen::Index n,float* dst)
+{
+	for(Eigen::Index k=0;k<n;k++)
+	{
+		dst[k]=fp16ToFloat(src[k].bits);
+	}
+}
+
+inline void floatToFp16Scalar(const float* src,Eigen::Index n,SymMatFp16* dst)
+{
+	for(Eigen::Index k=0;k<n;k++)
+	{
+		dst[k].bits=floatToFp16(src[k]);
+	}
+}
+
+inline void bf16ToFloatScalar(const SymMatBf16* src,Eigen::Index n,float* dst)
+{
+	for(Eigen::Index k=0;k<n;k++)
+	{
+		dst[k]=bf16ToFloat(src[k].bits);
+	}
+}
+
+inline void floatToBf16Scalar(const float* src,Eigen::Index n,SymMatBf16* dst)
+{
+	for(Eigen::Index k=0;k<n;k++)
+	{
+		dst[k].bits=floatToBf16(src[k]);
+	}
+}
+
+#if defined(SYMMAT_X86_DISPATCH)
+#define SYMMAT_F16C __attribute__((target("avx,f16c")))
+#define SYMMAT_AVX2_ONLY __attribute__((target("avx2")))
+#define SYMMAT_BF16 __attribute__((target("avx512f,avx512bf16")))
+
+//Which conversions the processor has(detected once)
+inline bool hasF16c()
+{
+	static const bool f16c=__builtin_cpu_supports("avx") && __builtin_cpu_supports("f16c");
+	return f16c;
+}
+
+inline bool hasBf16()
+{
+	static const bool bf16=__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bf16");
+	return bf16;
+}
+
+SYMMAT_F16C inline void fp16ToFloatF16c(const SymMatFp16* src,Eigen::Index n,float* dst)
+{
+	Eigen::Index k=0;
+	for(;k+8<=n;k+=8)
+	{
+		_mm256_storeu_ps(dst+k,_mm256_cvtph_ps(_mm_loadu_si128((const __m128i*)(src+k))));
+	}
+	fp16ToFloatScalar(src+k,n-k,dst+k);
+}
+
+SYMMAT_F16C inline void floatToFp16F16c(const float* src,Eigen::Index n,SymMatFp16* dst)
+{
+	Eigen::Index k=0;
+	for(;k+8<=n;k+=8)
+	{
+		_mm_storeu_si128((__m128i*)(dst+k),_mm256_cvtps_ph(_mm256_loadu_ps(src+k),_MM_FROUND_TO_NEAREST_INT|_MM_FROUND_NO_EXC));
+	}
+	floatToFp16Scalar(src+k,n-k,dst+k);
+}
+
+//bfloat16 -> float is only a shift of each 16 bits into the high half of 32 bits
+SYMMAT_AVX2_ONLY inline void bf16ToFloatAvx2(const SymMatBf16* src,Eigen::Index n,float* dst)
+{
+	Eigen::Index k=0;
+	for(;k+8<=n;k+=8)
+	{
+		const __m256i wide=_mm256_cvtepu16_epi32(_mm_loadu_si128((const __m128i*)(src+k)));
+		_mm256_storeu_ps(dst+k,_mm256_castsi256_ps(_mm256_slli_epi32(wide,16)));
+	}
+	bf16ToFloatScalar(src+k,n-k,dst+k);
+}
+
+SYMMAT_BF16 inline void floatToBf16Avx512(const float* src,Eigen::Index n,SymMatBf16* dst)
+{
+	Eigen::Index k=0;
+	for(;k+16<=n;k+=16)
+	{
+		const __m256bh packed=_mm512_cvtneps_pbh(_mm512_loadu_ps(src+k));
+		std::memcpy(dst+k,&packed,sizeof(packed));
+	}
+	floatToBf16Scalar(src+k,n-k,dst+k);
+}
+#endif
+
+template<>
+struct Convert<SymMatFp16,float>
+{
+	static void run(const SymMatFp16* src,Eigen::Index n,float* dst)
+	{
+#if defined(SYMMAT_X86_DISPATCH)
+		if(hasF16c())
+		{
+			fp16ToFloatF16c(src,n,dst);
+			return;
+		}
+#endif
+		fp16ToFloatScalar(src,n,dst);
+	}
+};
+
+template<>
+struct Convert<float,SymMatFp16>
+{
+	static void run(const float* src,Eigen::Index n,SymMatFp16* dst)
+	{
+#if defined(SYMMAT_X86_DISPATCH)
+		if(hasF16c())
+		{
+			floatToFp16F16c(src,n,dst);
+			return;
+		}
+#endif
+		floatToFp16Scalar(src,n,dst);
+	}
+};
+
+template<>
+struct Convert<SymMatBf16,float>
+{
+	static void run(const SymMatBf16* src,Eigen::Index n,float* dst)
+	{
+#if defined(SYMMAT_X86_DISPATCH)
+		if(simdLevel()>=SimdAvx2)
+		{
+			bf16ToFloatAvx2(src,n,dst);
+			return;
+		}
+#endif
+		bf16ToFloatScalar(src,n,dst);
+	}
+};
+
+template<>
+struct Convert<float,SymMatBf16>
+{
+	static void run(const float* src,Eigen::Index n,SymMatBf16* dst)
+	{
+#if defined(SYMMAT_X86_DISPATCH)
+		if(hasBf16())
+		{
+			floatToBf16Avx512(src,n,dst);
+			return;
+		}
+#endif
+		floatToBf16Scalar(src,n,dst);
+	}
+};
+
+} //namespace SymMatInternal
+
+
+/*************************************************************************************************
+						CLASS DEFINITION
+_Storage is SymMatFp16 or SymMatBf16. The elements are read as float(operator() returns the stored
+element, which converts to and from float), and SymMatHalf takes part in the expressions like
+SymMat<float>:-
+
+	SymMatHalf<SymMatFp16> H=S;		//rounds a SymMat<float>(or double, or an expression)
+	SymMat<float> T=2.0f*H+S;		//computed in float
+**************************************************************************************************/
+
+//Elements converted at a time by the reductions and the assignments
+#ifndef SYMMAT_HALF_CHUNK
+#define SYMMAT_HALF_CHUNK 4096
+#endif
+
+template<typename _Storage>
+class SymMatHalf : public SymMatExpr< SymMatHalf<_Storage> >
+{
+public:
+
+	//The elements are computed as float
+	typedef float Scalar;
+
+	//Order of the matrix
+	int order;
+
+	//Packed vector of 16 bit elements
+	typedef std::vector< _Storage,SymMatAllocator<_Storage> > Storage;
+	Storage mat;
+
+	//Default constructor(3x3 matrix of zeros, like SymMat)
+	SymMatHalf() :order(3),mat(6,_Storage(0.0f)) {}
+
+	//Parametrized constructor(parameter is order of matrice), all the elements are '0'
+	explicit SymMatHalf(int o) :order(o),mat(SymMatInternal::checkedElements<_Storage>(o),_Storage(0.0f)) {}
+
+	//Rounds a symmetric matrix or expression
+	template<typename _Derived>
+	SymMatHalf(const SymMatExpr<_Derived>& other) :order(0) { *this=other; }
+
+	template<typename _Derived>
+	SymMatHalf& operator=(const SymMatExpr<_Derived>&);
+
+	//Element at position k of the packed vector(used by the expressions)
+	float coeff(Eigen::Index k) const { return float(mat[k]); }
+
+	//No. of elements stored in the classical packed format
+	Eigen::Index size() const { return Eigen::Index(mat.size()); }
+
+	//Returns the index of the element (i,j) stored in the vector
+	Eigen::Index index(Eigen::Index i,Eigen::Index j) const
+	{
+		if(i>j)  //only the upper triangle is stored
+		{
+			std::swap(i,j);
+		}
+		return SymMatInternal::diagIndex(order,i)+(j-i);
+	}
+
+	//Element (i,j), it can be assigned a float
+	_Storage& operator()(Eigen::Index i,Eigen::Index j) { return mat[index(i,j)]; }
+	float operator()(Eigen::Index i,Eigen::Index j) const { return float(mat[index(i,j)]); }
+
+	//Prints the matrix
+	void print() const;
+
+	/***REDUCTIONS(each block in float, the blocks added in double)*****/
+	float sum() const;
+	float mean() const;
+	float packedSum() const;
+	float packedMean() const;
+	float trace() const;
+	float minCoeff() const;
+	float maxCoeff() const;
+
+	//No. of elements stored in the classical packed format
+	Eigen::Index elemstored() const { return size(); }
+
+private:
+	//Calls f(block,length) for the packed vector converted to float, one block at a time
+	template<typename _Function>
+	void blocks(_Function f) const;
+};
+
+//Matrices are only referred to inside the expressions, never copied
+template<typename _Storage>
+struct SymMatTraits< SymMatHalf<_Storage> >
+{
+	typedef float Scalar;
+	typedef const SymMatHalf<_Storage>& Nested;
+};
+
+
+/*************************************************************************************************
+						ASSIGNMENT AND REDUCTIONS
+The packed vector is converted in blocks of SYMMAT_HALF_CHUNK elements through a float buffer which
+stays in the cache, so every element is read from memory once, with 2 bytes.
+**************************************************************************************************/
+template<typename _Storage>
+template<typename _Derived>
+SymMatHalf<_Storage>& SymMatHalf<_Storage>::operator=(const SymMatExpr<_Derived>& other)
+{
+	const _Derived& expr=other.derived();
+
+	//Storage is only reallocated when the order changes
+	if(order!=expr.order || Eigen::Index(mat.size())!=expr.size())
+	{
+		order=expr.order;
+		mat.resize(expr.size());
+	}
+
+	float buffer[SYMMAT_HALF_CHUNK];
+	const Eigen::Index elements=expr.size();
+	for(Eigen::Index first=0;first<elements;first+=SYMMAT_HALF_CHUNK)
+	{
+		const Eigen::Index len=std::min(Eigen::Index(SYMMAT_HALF_CHUNK),elements-first);
+		for(Eigen::Index k=0;k<len;k++)
+		{
+			buffer[k]=float(expr.coeff(first+k));
+		}
+		SymMatInternal::Convert<float,_Storage>::run(buffer,len,mat.data()+first);
+	}
+	return *this;
+}
+
+template<typename _Storage>
+template<typename _Function>
+void SymMatHalf<_Storage>::blocks(_Function f) const
+{
+	float buffer[SYMMAT_HALF_CHUNK];
+	const Eigen::Index elements=size();
+	for(Eigen::Index first=0;first<elements;first+=SYMMAT_HALF_CHUNK)
+	{
+		const Eigen::Index len=std::min(Eigen::Index(SYMMAT_HALF_CHUNK),elements-first);
+		SymMatInternal::Convert<_Storage,float>::run(mat.data()+first,len,buffer);
+		f(buffer,len);
+	}
+}
+
+template<typename _Storage>
+float SymMatHalf<_Storage>::packedSum() const
+{
+	double total=0;
+	blocks([&](const float* p,Eigen::Index len){ total+=SymMatInternal::packedSum(p,len); });
+	return float(total);
+}
+
+template<typename _Storage>
+float SymMatHalf<_Storage>::trace() const
+{
+	double total=0;
+	Eigen::Index diag=0;
+	for(int i=0;i<order;i++)
+	{
+		total+=float(mat[diag]);
+		diag+=order-i;
+	}
+	return float(total);
+}
+
+//2*(sum of packed vector) - trace, like SymMat::sum()
+template<typename _Storage>
+float SymMatHalf<_Storage>::sum() const
+{
+	double total=0;
+	blocks([&](const float* p,Eigen::Index len){ total+=SymMatInternal::packedSum(p,len); });
+	const double diagonal=trace();
+	return float(2*total-diagonal);
+}
+
+template<typename _Storage>
+float SymMatHalf<_Storage>::mean() const
+{
+	return float(double(sum())/(double(order)*double(order)));
+}
+
+template<typename _Storage>
+float SymMatHalf<_Storage>::packedMean() const
+{
+	return float(double(packedSum())/double(size()));
+}
+
+template<typename _Storage>
+float SymMatHalf<_Storage>::minCoeff() const
+{
+	float m=std::numeric_limits<float>::infinity();
+	blocks([&](const float* p,Eigen::Index len){ m=std::min(m,SymMatInternal::packedMin(p,len)); });
+	return m;
+}
+
+template<typename _Storage>
+float SymMatHalf<_Storage>::maxCoeff() const
+{
+	float m=-std::numeric_limits<float>::infinity();
+	blocks([&](const float* p,Eigen::Index len){ m=std::max(m,SymMatInternal::packedMax(p,len)); });
+	return m;
+}
+
+template<typename _Storage>
+void SymMatHalf<_Storage>::print() const
+{
+	for(int i=0;i<order;i++)
+	{
+		for(int j=0;j<order;j++)
+		{
+			std::cout<<std::setw(4)<<(*this)(i,j)<<" ";  //setw() here sets 4 digits space for each element
+		}
+		std::cout<<"\n";
+	}
+}
+
+
+/*************************************************************************************************
+						MATRIX-VECTOR PRODUCT AND MULTIPLICATION
+The same kernels as for SymMat(see SymMat.h): spmv converts each row to float just before the dot
+product and axpy on it, and mult converts each panel just before Eigen's product. _Scalar is the type
+of the vectors/matrices and of the arithmetic(float, or double for more accuracy).
+**************************************************************************************************/
+template<typename _Storage,typename _Scalar>
+void spmv(_Scalar alpha,SymMatHalf<_Storage>& m1,const _Scalar* x,_Scalar beta,_Scalar* y)
+{
+	SymMatInternal::spmv(Eigen::Index(m1.order),alpha,m1.mat.data(),x,beta,y);
+}
+
+template<typename _Storage,typename _Scalar,int _Rows>
+void spmv(_Scalar alpha,SymMatHalf<_Storage>& m1,const Eigen::Matrix<_Scalar,_Rows,1>& x,_Scalar beta,Eigen::Matrix<_Scalar,_Rows,1>& y)
+{
+	assert(m1.order==x.rows());       //Condition for the matrix and the vector to be conformable
+	y.resize(m1.order);
+	SymMatInternal::spmv(Eigen::Index(m1.order),alpha,m1.mat.data(),x.data(),beta,y.data());
+}
+
+template<typename _Storage,typename _Scalar,int _Rows,int _Cols>
+Eigen::Matrix<_Scalar,_Rows,_Cols> mult(SymMatHalf<_Storage>& m1,Eigen::Matrix<_Scalar,_Rows,_Cols>& m2)
+{
+	assert(m1.order==m2.rows());       //Condition for matrices to be conformable for multiplication
+	Eigen::Matrix<_Scalar,_Rows,_Cols> m3(m1.order,m2.cols());
+	SymMatInternal::symmLeft(Eigen::Index(m1.order),m1.mat.data(),m2,m3);
+	return m3;
+}
+
+template<typename _Storage,typename _Scalar,int _Rows,int _Cols>
+Eigen::Matrix<_Scalar,_Rows,_Cols> mult(Eigen::Matrix<_Scalar,_Rows,_Cols>& m2,SymMatHalf<_Storage>& m1)
+{
+	assert(m1.order==m2.cols());       //Condition for matrices to be conformable for multiplication
+	Eigen::Matrix<_Scalar,_Rows,_Cols> m3(m2.rows(),m1.order);
+	SymMatInternal::symmRight(Eigen::Index(m1.order),m1.mat.data(),m2,m3);
+	return m3;
+}
+
+
+//------------------------------------------------------------------------------------------------
+#endif //SYMMAT_HALF_H
+/*************************************************************************************************
+								SYMMAT HALF HEADER FILE ENDED
+**************************************************************************************************/
@@ -0,0 +1,244 @@
+/***********************************************************************************************
+This header file contains the binary file format of SymMat, with save() and load()
+
+print() writes the whole matrix as text, which is slow and loses precision. The binary format
+writes the packed vector exactly as it is in memory, behind a small header:-
+
+	| header(SYMMAT_FILE_HEADER bytes) | packed vector(n(n+1)/2 elements) |
+
+The header is padded to a whole page, so the packed vector starts on a page boundary. Because of
+that the same file can either be read into the vector of a SymMat(load), or mapped into memory
+without copying anything(SymMatMapped in SymMatMapped.h).
+
+************************************************************************************************/
+//-----------------------------------------------------------------------------------------------
+
+
+/************************************************************************************************
+						INCLUDE GAURDS
+*************************************************************************************************/
+#ifndef SYMMAT_IO_H
+#define SYMMAT_IO_H
+
+
+/*************************************************************************************************
+						INCLUDING THE DEPENDENCIES
+**************************************************************************************************/
+#include "SymMat.h"				//packed SymMat
+#include <string>				//file names
+#include <cstdio>				//to use fopen, fread and fwrite
+#include <climits>				//to use INT_MAX
+#include <stdint.h>				//fixed size integers of the header
+
+
+/*************************************************************************************************
+						HEADER
+						------
+	magic		"SYMMAT\0\0"
+	version		SYMMAT_FILE_VERSION, files of a newer version are not read
+	endian		0x01020304 written in the byte order of the machine which wrote the file
+	scalartype	code of the scalar type(FileScalar), and scalarsize its size in bytes
+	layout		how the elements are stored(only FilePacked: upper triangle, row by row)
+	flags		FileChecksum when checksum holds the checksum of the packed vector
+	order		order of the matrix, elements = order(order+1)/2
+
+A matrix written through a mapping(SymMatMapped) changes after the header is written, so its
+file has no checksum.
+**************************************************************************************************/
+
+//Bytes taken by the header in front of the packed vector
+#ifndef SYMMAT_FILE_HEADER
+#define SYMMAT_FILE_HEADER 4096
+#endif
+
+#define SYMMAT_FILE_VERSION 1
+
+namespace SymMatInternal
+{
+
+enum FileScalar { FileOther=0, FileFloat=1, FileDouble=2, FileInt32=3, FileInt64=4 };
+enum FileLayout { FilePacked=0 };
+enum FileFlags  { FileChecksum=1 };
+
+//Code written in the header for each scalar type
+template<typename _Scalar> struct FileScalarCode { enum { value=FileOther }; };
+template<> struct FileScalarCode<float>     { enum { value=FileFloat }; };
+template<> struct FileScalarCode<double>    { enum { value=FileDouble }; };
+template<> struct FileScalarCode<int32_t>   { enum { value=FileInt32 }; };
+template<> struct FileScalarCode<int64_t>   { enum { value=FileInt64 }; };
+
+struct FileHeader
+{
+	char magic[8];
+	uint32_t version;
+	uint32_t endian;
+	uint32_t scalartype;
+	uint32_t scalarsize;
+	uint32_t layout;
+	uint32_t flags;
+	uint64_t order;
+	uint64_t elements;
+	uint64_t checksum;
+};
+
+//Reverses the bytes of each of the count values of size bytes
+inline void byteSwap(void* data,size_t size,size_t count)
+{
+	unsigned char* p=(unsigned char*)data;
+	for(size_t k=0;k<count;k++,p+=size)
+	{
+		std::reverse(p,p+size);
+	}
+}
+
+//64 bit checksum of the bytes, four words at a time(xor, multiply and shift of each lane)
+inline uint64_t checksum(const void* data,size_t bytes)
+{
+	const unsigned char* p=(const unsigned char*)data;
+	const uint64_t prime=0x100000001b3ULL;
+	uint64_t h[4]={0xcbf29ce484222325ULL,0x84222325cbf29ce4ULL,0x9e3779b97f4a7c15ULL,0x7f4a7c159e3779b9ULL};
+	size_t k=0;
+	for(;k+32<=bytes;k+=32)
+	{
+		for(int l=0;l<4;l++)
+		{
+			uint64_t w;
+			std::memcpy(&w,p+k+8*l,8);
+			h[l]=(h[l]^w)*prime;
+			h[l]^=h[l]>>29;
+		}
+	}
+	for(;k<bytes;k++)
+	{
+		h[0]=(h[0]^p[k])*prime;
+	}
+	uint64_t total=bytes;
+	for(int l=0;l<4;l++)
+	{
+		total=(total^h[l])*prime;
+		total^=total>>29;
+	}
+	return total;
+}
+
+//Header of a packed matrix of the given order(without checksum)
+template<typename _Scalar>
+FileHeader makeHeader(uint64_t order)
+{
+	FileHeader header;
+	std::memset(&header,0,sizeof(header));
+	std::memcpy(header.magic,"SYMMAT\0\0",8);
+	header.version=SYMMAT_FILE_VERSION;
+	header.endian=0x01020304;
+	header.scalartype=FileScalarCode<_Scalar>::value;
+	header.scalarsize=sizeof(_Scalar);
+	header.layout=FilePacked;
+	header.order=order;
+	header.elements=(order*(order+1))/2;
+	return header;
+}
+
+/*
+Checks that the header can be read as a packed matrix of _Scalar. When the file was written on a machine
+with the other byte order, the header is swapped in place and swapped is set.
+*/
+template<typename _Scalar>
+bool checkHeader(FileHeader& header,bool& swapped)
+{
+	swapped=false;
+	if(std::memcmp(header.magic,"SYMMAT\0\0",8)!=0)
+	{
+		return false;
+	}
+	if(header.endian==0x04030201)
+	{
+		swapped=true;
+		byteSwap(&header.version,sizeof(uint32_t),6);
+		byteSwap(&header.order,sizeof(uint64_t),3);
+	}
+	return header.endian==0x01020304 && header.version<=SYMMAT_FILE_VERSION
+		&& header.scalartype==uint32_t(FileScalarCode<_Scalar>::value) && header.scalarsize==sizeof(_Scalar)
+		&& header.layout==FilePacked && header.order<=uint64_t(INT_MAX)
+		&& header.elements==(header.order*(header.order+1))/2;
+}
+
+} //namespace SymMatInternal
+
+
+/*************************************************************************************************
+						SAVE AND LOAD
+Both return false when the file cannot be written/read, or(load) when it does not hold a packed
+matrix of the same scalar type or its checksum is wrong. load() also reads the files written on a
+machine with the other byte order.
+**************************************************************************************************/
+template<typename _Scalar>
+bool save(SymMat<_Scalar>& m1,const std::string& path)
+{
+	SymMatInternal::FileHeader header=SymMatInternal::makeHeader<_Scalar>(uint64_t(m1.order));
+	header.flags=SymMatInternal::FileChecksum;
+	header.checksum=SymMatInternal::checksum(m1.mat.data(),sizeof(_Scalar)*m1.mat.size());
+
+	std::FILE* file=std::fopen(path.c_str(),"wb");
+	if(!file)
+	{
+		return false;
+	}
+	char page[SYMMAT_FILE_HEADER]={0};
+	std::memcpy(page,&header,sizeof(header));
+	bool ok= std::fwrite(page,1,sizeof(page),file)==sizeof(page)
+		  && std::fwrite(m1.mat.data(),sizeof(_Scalar),m1.mat.size(),file)==m1.mat.size();
+	ok= std::fclose(file)==0 && ok;
+	return ok;
+}
+
+template<typename _Scalar>
+bool load(SymMat<_Scalar>& m1,const std::string& path)
+{
+	std::FILE* file=std::fopen(path.c_str(),"rb");
+	if(!file)
+	{
+		return false;
+	}
+	SymMatInternal::FileHeader header;
+	bool swapped;
+	if(std::fread(&header,sizeof(header),1,file)!=1 || !SymMatInternal::checkHeader<_Scalar>(header,swapped)
+	   || SymMatInternal::packedElements<_Scalar>(Eigen::Index(header.order))<0 || std::fseek(file,0,SEEK_END)!=0)
+	{
+		std::fclose(file);
+		return false;
+	}
+	//The file must hold the whole packed vector before it is allocated(a damaged header would
+	//otherwise ask for any size)
+	const long bytes=std::ftell(file);
+	if(bytes<long(SYMMAT_FILE_HEADER) || uint64_t(bytes-SYMMAT_FILE_HEADER)/sizeof(_Scalar)<header.elements
+	   || std::fseek(file,SYMMAT_FILE_HEADER,SEEK_SET)!=0)
+	{
+		std::fclose(file);
+		return false;
+	}
+
+	typename SymMat<_Scalar>::Storage data(header.elements);
+	bool ok= std::fread(data.data(),sizeof(_Scalar),data.size(),file)==data.size();
+	std::fclose(file);
+
+	//The checksum is of the bytes as they are in the file
+	if(!ok || ((header.flags&SymMatInternal::FileChecksum)
+			   && SymMatInternal::checksum(data.data(),sizeof(_Scalar)*data.size())!=header.checksum))
+	{
+		return false;
+	}
+	if(swapped)
+	{
+		SymMatInternal::byteSwap(data.data(),sizeof(_Scalar),data.size());
+	}
+	m1.order=int(header.order);
+	m1.mat.swap(data);
+	return true;
+}
+
+
+//------------------------------------------------------------------------------------------------
+#endif //SYMMAT_IO_H
+/*************************************************************************************************
+								SYMMAT IO HEADER FILE ENDED
+**************************************************************************************************/
@@ -0,0 +1,364 @@
+/***********************************************************************************************
+This header file contains alternative storage layouts for symmetric matrices
+
+SymMat stores the upper triangle row by row(classical packed format). Going down a column of that
+format jumps across the vector with growing strides, which is slow for column oriented algorithms.
+The layouts here store the same n(n+1)/2 elements, but arranged so that the kernels work on
+contiguous dense blocks:-
+
+	1)SymMatBlocked - the matrix is cut into square tiles of size _Block. Only the tiles on and above
+	  the diagonal are stored; the diagonal tiles in packed format, the others as dense row major tiles.
+
+	2)SymMatRFP - LAPACK's Rectangular Full Packed format(TRANSR='N', UPLO='L'), where the lower triangle
+	  is rearranged into one dense column major array of (n+1)x(n/2)(n even) or nx((n+1)/2)(n odd),
+	  so it can be passed directly to the LAPACK routines for RFP matrices(dpftrf, dsfrk, ...).
+
+There are conversion functions between SymMat and each of the layouts.
+
+************************************************************************************************/
+//-----------------------------------------------------------------------------------------------
+
+
+/************************************************************************************************
+						INCLUDE GAURDS
+*************************************************************************************************/
+#ifndef SYMMAT_LAYOUT_H
+#define SYMMAT_LAYOUT_H
+
+
+/*************************************************************************************************
+						INCLUDING THE DEPENDENCIES
+**************************************************************************************************/
+#include "SymMat.h"				//packed SymMat and its kernels
+
+
+/*************************************************************************************************
+						BLOCKED(TILED) LAYOUT
+						---------------------
+For order 10 and _Block 4 the tiles are:-
+
+	| T00 T01 T02 |		T00,T11,T22 are diagonal tiles(4x4,4x4,2x2) stored in packed format
+	|     T11 T12 |		T01,T02,T12 are dense tiles(4x4,4x2,4x2) stored row by row
+	|         T22 |
+
+The tiles are stored one tile row after another: T00,T01,T02,T11,T12,T22
+**************************************************************************************************/
+template <typename _Scalar,int _Block=64>
+class SymMatBlocked
+{
+public:
+
+	typedef _Scalar Scalar;
+
+	//Dense tile, as it is stored in the vector
+	typedef Eigen::Map< Eigen::Matrix<_Scalar,Eigen::Dynamic,Eigen::Dynamic,Eigen::RowMajor> > Tile;
+
+	//Order of the matrix
+	int order;
+
+	//No. of tile rows(and tile columns)
+	int tiles;
+
+	//Vector which stores the elements of the matrix
+	std::vector<_Scalar> mat;
+
+	//Position of the first element of each tile row in the vector
+	std::vector<Eigen::Index> rowstart;
+
+	//Default constructor(3x3 matrix of zeros, like SymMat)
+	SymMatBlocked() { resize(3); }
+
+	//Parametrized constructor(parameter is order of matrice)
+	SymMatBlocked(int o) { resize(o); }
+
+	//Changes the order of the matrix, all the elements are set to '0'
+	void resize(int);
+
+	//Size of the tile row/column number I
+	int tilesize(int I) const { return std::min(_Block,order-I*_Block); }
+
+	//Returns the index of the element (i,j) stored in the vector
+	Eigen::Index index(int,int) const;
+
+	//Overloading the funtion call operator
+	_Scalar& operator()(int i,int j) { return mat[index(i,j)]; }
+
+	//Dense tile (I,J) with I<J
+	Tile tile(int,int);
+
+	//No.of elements stored
+	Eigen::Index elemstored() const { return mat.size(); }
+};
+
+
+template<typename _Scalar,int _Block>
+void SymMatBlocked<_Scalar,_Block>::resize(int o)
+{
+	order=o;
+	tiles=(order+_Block-1)/_Block;
+	rowstart.resize(tiles+1);
+
+	Eigen::Index start=0;
+	for(int I=0;I<tiles;I++)
+	{
+		rowstart[I]=start;
+		const Eigen::Index b=tilesize(I);
+		start+=(b*(b+1))/2+b*(order-I*_Block-b);	//diagonal tile + the tiles to its right
+	}
+	rowstart[tiles]=start;
+
+	mat.resize(start);
+	std::fill(mat.begin(),mat.end(),0); //filling all elements of the vector with '0'
+}
+
+
+template<typename _Scalar,int _Block>
+Eigen::Index SymMatBlocked<_Scalar,_Block>::index(int i,int j) const
+{
+	if(i>j)  //only the upper triangle is stored
+	{
+		std::swap(i,j);
+	}
+	const int I=i/_Block,J=j/_Block;
+	const Eigen::Index ii=i%_Block,jj=j%_Block,b=tilesize(I);
+
+	if(I==J)
+	{
+		//Packed upper triangle of the diagonal tile
+		return rowstart[I]+SymMatInternal::diagIndex(b,ii)+(jj-ii);
+	}
+	//All the tiles between the diagonal tile and tile J are full _Block wide
+	return rowstart[I]+(b*(b+1))/2+b*Eigen::Index(_Block)*(J-I-1)+ii*tilesize(J)+jj;
+}
+
+
+template<typename _Scalar,int _Block>
+typename SymMatBlocked<_Scalar,_Block>::Tile SymMatBlocked<_Scalar,_Block>::tile(int I,int J)
+{
+	assert(I<J && J<tiles);
+	return Tile(&mat[index(I*_Block,J*_Block)],tilesize(I),tilesize(J));
+}
+
+
+/*************************************************************************************************
+						RECTANGULAR FULL PACKED LAYOUT
+						------------------------------
+Lower triangle of A split in A11(k x k), A21 and A22, stored in the column major array AR:-
+
+	n even, k=n/2, AR is (n+1) x k			n odd, k=(n+1)/2, AR is n x k
+
+	AR(r,j)= A(k+j,k+r)  r<=j				AR(r,j)= A(r,j)        r>=j
+	AR(r,j)= A(r-1,j)    r>j				AR(r,j)= A(k-1+j,k+r)  r<j
+
+So A21 is one dense block, and A11/A22 are triangles of square dense blocks of AR.
+**************************************************************************************************/
+template <typename _Scalar>
+class SymMatRFP
+{
+public:
+
+	typedef _Scalar Scalar;
+
+	//Column major view of AR
+	typedef Eigen::Map< Eigen::Matrix<_Scalar,Eigen::Dynamic,Eigen::Dynamic>,0,Eigen::OuterStride<> > Block;
+
+	//Order of the matrix
+	int order;
+
+	//Vector which stores AR column by column
+	std::vector<_Scalar> mat;
+
+	//Default constructor(3x3 matrix of zeros, like SymMat)
+	SymMatRFP() { resize(3); }
+
+	//Parametrized constructor(parameter is order of matrice)
+	SymMatRFP(int o) { resize(o); }
+
+	//Changes the order of the matrix, all the elements are set to '0'
+	void resize(int o)
+	{
+		order=o;
+		mat.resize((Eigen::Index(order)*(order+1))/2);
+		std::fill(mat.begin(),mat.end(),0); //filling all elements of the vector with '0'
+	}
+
+	//Rows of AR(leading dimension for LAPACK) and order of A11
+	int ldar() const { return order%2==0 ? order+1 : order; }
+	int half() const { return (order+1)/2; }
+
+	//Returns the index of the element (i,j) stored in the vector
+	Eigen::Index index(int,int) const;
+
+	//Overloading the funtion call operator
+	_Scalar& operator()(int i,int j) { return mat[index(i,j)]; }
+
+	//Dense blocks holding A11(lower triangle), A21(full) and A22(upper triangle)
+	Block a11() { return block(order%2==0 ? 1 : 0,0,half(),half()); }
+	Block a21() { return block(order%2==0 ? half()+1 : half(),0,order-half(),half()); }
+	Block a22() { return block(0,order%2==0 ? 0 : 1,order-half(),order-half()); }
+
+	//No.of elements stored
+	Eigen::Index elemstored() const { return mat.size(); }
+
+private:
+	Block block(int r,int c,int rows,int cols)
+	{
+		return Block(mat.data()+Eigen::Index(c)*ldar()+r,rows,cols,Eigen::OuterStride<>(ldar()));
+	}
+};
+
+
+template<typename _Scalar>
+Eigen::Index SymMatRFP<_Scalar>::index(int i,int j) const
+{
+	if(i<j)  //only the lower triangle is stored
+	{
+		std::swap(i,j);
+	}
+	const int k=half();
+	const Eigen::Index lda=ldar();
+	if(order%2==0)
+	{
+		if(j>=k)
+		{
+			return Eigen::Index(i-k)*lda+(j-k);		//A22, stored transposed in the top rows
+		}
+		return Eigen::Index(j)*lda+(i+1);
+	}
+	if(j>=k)
+	{
+		return Eigen::Index(i-k+1)*lda+(j-k);		//A22, stored transposed right of A11
+	}
+	return Eigen::Index(j)*lda+i;
+}
+
+
+/*************************************************************************************************
+						CONVERSIONS BETWEEN THE LAYOUTS
+Each conversion walks the packed SymMat in storage order(row by row) and writes into the other layout.
+**************************************************************************************************/
+template<int _Block=64,typename _Scalar>
+SymMatBlocked<_Scalar,_Block> toBlocked(SymMat<_Scalar>& m1)
+{
+	SymMatBlocked<_Scalar,_Block> m2(m1.order);
+	Eigen::Index k=0;
+	for(int i=0;i<m1.order;i++)
+	{
+		for(int j=i;j<m1.order;j++)
+		{
+			m2.mat[m2.index(i,j)]=m1.mat[k++];
+		}
+	}
+	return m2;
+}
+
+template<typename _Scalar,int _Block>
+SymMat<_Scalar> toPacked(SymMatBlocked<_Scalar,_Block>& m1)
+{
+	SymMat<_Scalar> m2(m1.order);
+	Eigen::Index k=0;
+	for(int i=0;i<m1.order;i++)
+	{
+		for(int j=i;j<m1.order;j++)
+		{
+			m2.mat[k++]=m1.mat[m1.index(i,j)];
+		}
+	}
+	return m2;
+}
+
+template<typename _Scalar>
+SymMatRFP<_Scalar> toRFP(SymMat<_Scalar>& m1)
+{
+	SymMatRFP<_Scalar> m2(m1.order);
+	Eigen::Index k=0;
+	for(int i=0;i<m1.order;i++)
+	{
+		for(int j=i;j<m1.order;j++)
+		{
+			m2.mat[m2.index(j,i)]=m1.mat[k++];
+		}
+	}
+	return m2;
+}
+
+template<typename _Scalar>
+SymMat<_Scalar> toPacked(SymMatRFP<_Scalar>& m1)
+{
+	SymMat<_Scalar> m2(m1.order);
+	Eigen::Index k=0;
+	for(int i=0;i<m1.order;i++)
+	{
+		for(int j=i;j<m1.order;j++)
+		{
+			m2.mat[k++]=m1.mat[m1.index(j,i)];
+		}
+	}
+	return m2;
+}
+
+
+/*************************************************************************************************
+						MATRIX-VECTOR PRODUCT
+y = alpha*S*x + beta*y
+
+Blocked:- the diagonal tiles use the packed kernel of SymMat, and every dense tile T(I,J) is used for
+both y(I)+=T*x(J) and y(J)+=T^T*x(I) while it is in the cache.
+RFP:- the two triangles are done as self adjoint views and A21 as two dense products.
+**************************************************************************************************/
+template<typename _Scalar,int _Block>
+void spmv(_Scalar alpha,SymMatBlocked<_Scalar,_Block>& m1,const _Scalar* x,_Scalar beta,_Scalar* y)
+{
+	typedef Eigen::Map< Eigen::Matrix<_Scalar,Eigen::Dynamic,1> > Vec;
+	typedef Eigen::Map< const Eigen::Matrix<_Scalar,Eigen::Dynamic,1> > ConstVec;
+
+	Vec(y,m1.order)*=beta;
+	if(beta==_Scalar(0))
+	{
+		Vec(y,m1.order).setZero();
+	}
+
+	for(int I=0;I<m1.tiles;I++)
+	{
+		const int r=I*_Block,b=m1.tilesize(I);
+		SymMatInternal::spmvRows(Eigen::Index(b),Eigen::Index(0),Eigen::Index(b),alpha,&m1.mat[m1.rowstart[I]],x+r,y+r);
+
+		for(int J=I+1;J<m1.tiles;J++)
+		{
+			const int c=J*_Block,bc=m1.tilesize(J);
+			typename SymMatBlocked<_Scalar,_Block>::Tile T=m1.tile(I,J);
+			Vec(y+r,b).noalias()+=alpha*(T*ConstVec(x+c,bc));
+			Vec(y+c,bc).noalias()+=alpha*(T.transpose()*ConstVec(x+r,b));
+		}
+	}
+}
+
+template<typename _Scalar>
+void spmv(_Scalar alpha,SymMatRFP<_Scalar>& m1,const _Scalar* x,_Scalar beta,_Scalar* y)
+{
+	typedef Eigen::Map< Eigen::Matrix<_Scalar,Eigen::Dynamic,1> > Vec;
+	typedef Eigen::Map< const Eigen::Matrix<_Scalar,Eigen::Dynamic,1> > ConstVec;
+
+	const int k=m1.half(),r=m1.order-k;
+	Vec y1(y,k),y2(y+k,r);
+	ConstVec x1(x,k),x2(x+k,r);
+
+	Vec(y,m1.order)*=beta;
+	if(beta==_Scalar(0))
+	{
+		Vec(y,m1.order).setZero();
+	}
+
+	typename SymMatRFP<_Scalar>::Block A11=m1.a11(),A21=m1.a21(),A22=m1.a22();
+	y1.noalias()+=alpha*(A11.template selfadjointView<Eigen::Lower>()*x1);
+	y1.noalias()+=alpha*(A21.transpose()*x2);
+	y2.noalias()+=alpha*(A21*x1);
+	y2.noalias()+=alpha*(A22.template selfadjointView<Eigen::Upper>()*x2);
+}
+
+
+//------------------------------------------------------------------------------------------------
+#endif //SYMMAT_LAYOUT_H
+/*************************************************************************************************
+								SYMMAT LAYOUT HEADER FILE ENDED
+**************************************************************************************************/
@@ -0,0 +1,457 @@
+/***********************************************************************************************
+This header file contains SymMatMapped - a symmetric matrix whose packed vector lives in a file
+
+SymMat keeps its n(n+1)/2 elements in a std::vector, so the order is limited by the memory of the
+machine. SymMatMapped stores the same classical packed format(upper triangle, row by row) in a file
+which is mapped into memory with mmap:-
+
+	1)Opening a matrix only maps the file, nothing is read. The pages are read by the operating
+	  system when they are first used, so opening is instant whatever the order.
+
+	2)The kernels(reductions, add/sub, spmv) walk the packed vector in storage order, in chunks of
+	  SYMMAT_MAP_CHUNK bytes, and ask the system to read the next chunk while the current one is used.
+	  So the whole matrix never has to be in memory at the same time.
+
+It is a SymMatExpr like SymMat, so it can be used in the expressions(a*M1+M2-M3) and assigned to
+a SymMat(loading it into memory) or to another SymMatMapped(computed chunk by chunk).
+
+Only POSIX systems(Linux, macOS) are supported.
+
+************************************************************************************************/
+//-----------------------------------------------------------------------------------------------
+
+
+/************************************************************************************************
+						INCLUDE GAURDS
+*************************************************************************************************/
+#ifndef SYMMAT_MAPPED_H
+#define SYMMAT_MAPPED_H
+
+
+/*************************************************************************************************
+						INCLUDING THE DEPENDENCIES
+**************************************************************************************************/
+#include "SymMat.h"				//packed SymMat and its kernels
+#include "SymMatIO.h"			//file header
+#include <string>				//file names
+#include <fcntl.h>				//to use open
+#include <unistd.h>				//to use close, ftruncate and sysconf
+#include <sys/mman.h>			//to use mmap, munmap, msync and madvise
+#include <sys/stat.h>			//to use fstat
+
+
+/*************************************************************************************************
+						FILE LAYOUT
+						-----------
+The files are in the binary format of SymMatIO.h, so a matrix written by save() can be mapped, and a
+mapped matrix can be read by load(). The header takes a whole page, so the packed vector starts on a
+page boundary and every chunk the kernels walk(a multiple of the page size) covers whole pages.
+**************************************************************************************************/
+
+//Bytes of the packed vector processed between two prefetch hints(multiple of the page size)
+#ifndef SYMMAT_MAP_CHUNK
+#define SYMMAT_MAP_CHUNK (16*1024*1024)
+#endif
+
+namespace SymMatInternal
+{
+
+//Gives a hint about the pages holding [p,p+bytes) to the system(p is rounded down to a page)
+inline void adviseRange(const void* p,size_t bytes,int advice)
+{
+	static const size_t page=size_t(sysconf(_SC_PAGESIZE));
+	const size_t start=size_t(p)&~(page-1);
+	const size_t end=size_t(p)+bytes;
+	if(end>start)
+	{
+		madvise((void*)start,end-start,advice);
+	}
+}
+
+//Calls f(first,last) for consecutive chunks of [0,n) elements of p, prefetching the next chunk
+template<typename _Scalar,typename _Function>
+void streamChunks(const _Scalar* p,Eigen::Index n,_Function f)
+{
+	const Eigen::Index chunk=std::max(Eigen::Index(SYMMAT_MAP_CHUNK/sizeof(_Scalar)),Eigen::Index(1));
+	for(Eigen::Index first=0;first<n;first+=chunk)
+	{
+		const Eigen::Index last=std::min(n,first+chunk);
+		if(last<n)
+		{
+			adviseRange(p+last,sizeof(_Scalar)*size_t(std::min(chunk,n-last)),MADV_WILLNEED);
+		}
+		f(first,last);
+	}
+}
+
+} //namespace SymMatInternal
+
+
+/*************************************************************************************************
+						CLASS DEFINITION
+**************************************************************************************************/
+template <typename _Scalar>
+class SymMatMapped : public SymMatExpr< SymMatMapped<_Scalar> >
+{
+public:
+
+	typedef _Scalar Scalar;
+
+	//Order of the matrix
+	int order;
+
+	//Packed vector inside the mapped file(null when no file is open)
+	_Scalar* mat;
+
+	//No file is open
+	SymMatMapped() :order(0),mat(0),fd(-1),base(0),bytes(0) {}
+
+	~SymMatMapped() { close(); }
+
+	//Creates(or truncates) a file for a matrix of the given order, with all elements '0'
+	bool create(const std::string&,int);
+
+	//Maps an existing file, read only unless writable is true
+	bool open(const std::string&,bool writable=false);
+
+	//Writes the changed pages back to the file
+	void flush();
+
+	//Unmaps the file
+	void close();
+
+	bool isOpen() const { return mat!=0; }
+
+	//Evaluates a symmetric expression of the same order into the file, chunk by chunk
+	template<typename _Derived>
+	SymMatMapped& operator=(const SymMatExpr<_Derived>&);
+
+	//Copies the elements of another mapped matrix(the files stay different)
+	SymMatMapped& operator=(const SymMatMapped& other) { return *this=static_cast<const SymMatExpr<SymMatMapped>&>(other); }
+
+	//Element at position k of the packed vector(used by the expressions)
+	const _Scalar& coeff(Eigen::Index k) const { return mat[k]; }
+
+	//No. of elements stored in the classical packed format
+	Eigen::Index size() const { return (Eigen::Index(order)*(order+1))/2; }
+
+	//Returns the index of the element (i,j) stored in the vector
+	Eigen::Index index(int i,int j) const
+	{
+		if(i>j)
+		{
+			std::swap(i,j);
+		}
+		return SymMatInternal::diagIndex(order,i)+(j-i);
+	}
+
+	//Overloading the funtion call operator
+	_Scalar& operator()(int i,int j) { return mat[index(i,j)]; }
+
+	/***STREAMING REDUCTIONS*****/
+	_Scalar sum();
+	_Scalar mean();
+	_Scalar packedSum();
+	_Scalar packedMean();
+	_Scalar trace();
+	_Scalar minCoeff();
+	_Scalar maxCoeff();
+
+private:
+	int fd;
+	void* base;
+	size_t bytes;
+
+	//The mapping owns the file, so it cannot be copy constructed
+	SymMatMapped(const SymMatMapped&);
+
+	bool map(int,bool);
+};
+
+//Mapped matrices are only referred to inside the expressions, never copied
+template<typename _Scalar>
+struct SymMatTraits< SymMatMapped<_Scalar> >
+{
+	typedef _Scalar Scalar;
+	typedef const SymMatMapped<_Scalar>& Nested;
+};
+
+
+/*************************************************************************************************
+						OPENING AND CLOSING THE FILE
+The file is mapped shared, so the changes made through mat go to the file. A new file is only
+extended with ftruncate, which does not write anything: the zeros are created by the file system
+when the pages are first touched.
+**************************************************************************************************/
+template<typename _Scalar>
+bool SymMatMapped<_Scalar>::create(const std::string& path,int o)
+{
+	close();
+	const Eigen::Index elements=SymMatInternal::packedElements<_Scalar>(o);
+	if(elements<0)
+	{
+		return false;
+	}
+	fd=::open(path.c_str(),O_RDWR|O_CREAT|O_TRUNC,0644);
+	if(fd<0)
+	{
+		return false;
+	}
+	const size_t total=SYMMAT_FILE_HEADER+sizeof(_Scalar)*size_t(elements);
+	if(ftruncate(fd,off_t(total))!=0)
+	{
+		close();
+		return false;
+	}
+
+	//The elements change after the header is written, so there is no checksum
+	SymMatInternal::FileHeader header=SymMatInternal::makeHeader<_Scalar>(uint64_t(o));
+	if(pwrite(fd,&header,sizeof(header),0)!=ssize_t(sizeof(header)))
+	{
+		close();
+		return false;
+	}
+	order=o;
+	return map(fd,true);
+}
+
+template<typename _Scalar>
+bool SymMatMapped<_Scalar>::open(const std::string& path,bool writable)
+{
+	close();
+	fd=::open(path.c_str(),writable ? O_RDWR : O_RDONLY);
+	if(fd<0)
+	{
+		return false;
+	}
+
+	//The header must match the scalar type and the byte order(the elements are used as they are
+	//in the file), and the file must hold the whole packed vector
+	SymMatInternal::FileHeader header;
+	struct stat info;
+	bool swapped;
+	if(pread(fd,&header,sizeof(header),0)!=ssize_t(sizeof(header)) || !SymMatInternal::checkHeader<_Scalar>(header,swapped)
+	   || swapped || fstat(fd,&info)!=0 || size_t(info.st_size)<SYMMAT_FILE_HEADER+sizeof(_Scalar)*size_t(header.elements))
+	{
+		close();
+		return false;
+	}
+
+	//The elements can be changed through the mapping, so the checksum would be wrong
+	if(writable && (header.flags&SymMatInternal::FileChecksum))
+	{
+		header.flags&=~uint32_t(SymMatInternal::FileChecksum);
+		header.checksum=0;
+		if(pwrite(fd,&header,sizeof(header),0)!=ssize_t(sizeof(header)))
+		{
+			close();
+			return false;
+		}
+	}
+	order=int(header.order);
+	return map(fd,writable);
+}
+
+template<typename _Scalar>
+bool SymMatMapped<_Scalar>::map(int file,bool writable)
+{
+	bytes=SYMMAT_FILE_HEADER+sizeof(_Scalar)*size_t(size());
+	base=mmap(0,bytes,writable ? PROT_READ|PROT_WRITE : PROT_READ,MAP_SHARED,file,0);
+	if(base==MAP_FAILED)
+	{
+		base=0;
+		close();
+		return false;
+	}
+	mat=(_Scalar*)((char*)base+SYMMAT_FILE_HEADER);
+
+	//The kernels walk the file in storage order
+	madvise(base,bytes,MADV_SEQUENTIAL);
+	return true;
+}
+
+template<typename _Scalar>
+void SymMatMapped<_Scalar>::flush()
+{
+	if(base)
+	{
+		msync(base,bytes,MS_SYNC);
+	}
+}
+
+template<typename _Scalar>
+void SymMatMapped<_Scalar>::close()
+{
+	if(base)
+	{
+		munmap(base,bytes);
+	}
+	if(fd>=0)
+	{
+		::close(fd);
+	}
+	fd=-1;
+	base=0;
+	bytes=0;
+	mat=0;
+	order=0;
+}
+
+//Zero-copy load of a file written by save()(or by another SymMatMapped), only the header is read
+template<typename _Scalar>
+bool load(SymMatMapped<_Scalar>& m1,const std::string& path,bool writable=false)
+{
+	return m1.open(path,writable);
+}
+
+
+/*************************************************************************************************
+						EVALUATING AN EXPRESSION
+Same single loop as SymMat::operator=, done one chunk at a time so that the pages of the result are
+prefetched ahead of the loop. The file is not resized, so the order must be the same.
+**************************************************************************************************/
+template<typename _Scalar>
+template<typename _Derived>
+SymMatMapped<_Scalar>& SymMatMapped<_Scalar>::operator=(const SymMatExpr<_Derived>& other)
+{
+	const _Derived& expr=other.derived();
+	assert(isOpen() && size()==expr.size());       //Condition for matrices to be conformable
+
+	_Scalar* dst=mat;
+	SymMatInternal::streamChunks(mat,size(),[&](Eigen::Index first,Eigen::Index last)
+	{
+		for(Eigen::Index k=first;k<last;k++)
+		{
+			dst[k]=expr.coeff(k);
+		}
+	});
+	return *this;
+}
+
+
+/*************************************************************************************************
+						STREAMING REDUCTIONS
+Every chunk is reduced by the SIMD kernels of SymMat and the results of the chunks are combined.
+sum() is 2*(sum of packed vector) - trace, like SymMat::sum().
+**************************************************************************************************/
+template<typename _Scalar>
+_Scalar SymMatMapped<_Scalar>::packedSum()
+{
+	_Scalar total=0;
+	const _Scalar* p=mat;
+	SymMatInternal::streamChunks(mat,size(),[&](Eigen::Index first,Eigen::Index last)
+	{
+		total+=SymMatInternal::packedSum(p+first,last-first);
+	});
+	return total;
+}
+
+template<typename _Scalar>
+_Scalar SymMatMapped<_Scalar>::trace()
+{
+	_Scalar store_trace=0;
+	Eigen::Index diag=0;
+	for(int i=0;i<order;i++)
+	{
+		store_trace+=mat[diag];
+		diag+=order-i;
+	}
+	return store_trace;
+}
+
+template<typename _Scalar>
+_Scalar SymMatMapped<_Scalar>::sum()
+{
+	const _Scalar store_trace=trace();
+	return 2*(packedSum()-store_trace)+store_trace;
+}
+
+template<typename _Scalar>
+_Scalar SymMatMapped<_Scalar>::mean()
+{
+	return sum()/(_Scalar(order)*_Scalar(order));
+}
+
+template<typename _Scalar>
+_Scalar SymMatMapped<_Scalar>::packedMean()
+{
+	return packedSum()/_Scalar(size());
+}
+
+template<typename _Scalar>
+_Scalar SymMatMapped<_Scalar>::maxCoeff()
+{
+	_Scalar best=mat[0];
+	const _Scalar* p=mat;
+	SymMatInternal::streamChunks(mat,size(),[&](Eigen::Index first,Eigen::Index last)
+	{
+		best=std::max(best,SymMatInternal::packedMax(p+first,last-first));
+	});
+	return best;
+}
+
+template<typename _Scalar>
+_Scalar SymMatMapped<_Scalar>::minCoeff()
+{
+	_Scalar best=mat[0];
+	const _Scalar* p=mat;
+	SymMatInternal::streamChunks(mat,size(),[&](Eigen::Index first,Eigen::Index last)
+	{
+		best=std::min(best,SymMatInternal::packedMin(p+first,last-first));
+	});
+	return best;
+}
+
+
+/*************************************************************************************************
+						MATRIX-VECTOR PRODUCT
+y = alpha*S*x + beta*y
+
+The rows are cut into groups holding about SYMMAT_MAP_CHUNK bytes, and each group is done by the
+row kernel of SymMat(which reads each stored element once) while the next group is prefetched.
+The product is limited by the speed of the disk, so it is done by one thread.
+**************************************************************************************************/
+template<typename _Scalar>
+void spmv(_Scalar alpha,SymMatMapped<_Scalar>& m1,const _Scalar* x,_Scalar beta,_Scalar* y)
+{
+	const Eigen::Index n=m1.order;
+	const Eigen::Index chunk=std::max(Eigen::Index(SYMMAT_MAP_CHUNK/sizeof(_Scalar)),Eigen::Index(1));
+	for(Eigen::Index i=0;i<n;i++)
+	{
+		y[i]= beta==_Scalar(0) ? _Scalar(0) : beta*y[i];
+	}
+
+	Eigen::Index first=0;
+	while(first<n)
+	{
+		//Rows first..last-1 hold about one chunk of elements
+		Eigen::Index last=first,elements=0;
+		while(last<n && (elements==0 || elements+(n-last)<=chunk))
+		{
+			elements+=n-last;
+			last++;
+		}
+		const Eigen::Index next=SymMatInternal::diagIndex(n,last);
+		if(last<n)
+		{
+			SymMatInternal::adviseRange(m1.mat+next,sizeof(_Scalar)*size_t(std::min(chunk,m1.size()-next)),MADV_WILLNEED);
+		}
+		SymMatInternal::spmvRows(n,first,last,alpha,m1.mat,x,y);
+		first=last;
+	}
+}
+
+template<typename _Scalar,int _Rows>
+void spmv(_Scalar alpha,SymMatMapped<_Scalar>& m1,const Eigen::Matrix<_Scalar,_Rows,1>& x,_Scalar beta,Eigen::Matrix<_Scalar,_Rows,1>& y)
+{
+	assert(m1.order==x.rows());       //Condition for the matrix and the vector to be conformable
+	y.resize(m1.order);
+	spmv(alpha,m1,x.data(),beta,y.data());
+}
+
+
+//------------------------------------------------------------------------------------------------
+#endif //SYMMAT_MAPPED_H
+/*************************************************************************************************
+								SYMMAT MAPPED HEADER FILE ENDED
+**************************************************************************************************/
@@ -0,0 +1,655 @@
+/***********************************************************************************************
+This header file contains SymMatQuant - a symmetric matrix quantized to 8 or 16 bit integers
+
+Large similarity and kernel matrices only need a few significant digits, so the packed vector is
+stored as integers(SymMatQuant<int8_t> uses 1 byte per element, a quarter of float) with a scale and
+a zero-point for each block of SYMMAT_QUANT_BLOCK consecutive elements of the packed vector:-
+
+	element = scale*(q - zero)			q is the stored integer
+
+Each block covers the range of its own elements, so a block of small similarities keeps its precision
+next to a block of large ones. The matrix is quantized from a SymMat(or any expression) and dequantized
+back to float on read:-
+
+	SymMatQuant<int8_t> Q=S;			//quantizes S
+	SymMat<float> T=dequantize(Q);		//or SymMat<float> T=Q;
+
+spmv and mult dequantize each row into float just before using it(so the matrix is read from memory
+in 1 or 2 bytes per element), the reductions add the integers of each block with AVX-512 VNNI or AVX2
+and apply the scale and the zero-point once per block, and topk finds the largest elements of a row.
+
+************************************************************************************************/
+//-----------------------------------------------------------------------------------------------
+
+
+/************************************************************************************************
+						INCLUDE GAURDS
+*************************************************************************************************/
+#ifndef SYMMAT_QUANT_H
+#define SYMMAT_QUANT_H
+
+
+/*************************************************************************************************
+						INCLUDING THE DEPENDENCIES
+**************************************************************************************************/
+#include "SymMat.h"				//packed SymMat, expressions and kernels
+#include <stdint.h>				//int8_t and int16_t
+
+
+/*************************************************************************************************
+						ERROR BOUNDS
+						------------
+A block whose elements lie between lo and hi gets scale=(hi-lo)/(2^bits-1), and every element is
+rounded to the nearest of the 2^bits levels between lo and hi:-
+
+	|Q(i,j) - S(i,j)|	<= scale/2 = (hi-lo)/510		for int8_t
+						<= (hi-lo)/131070				for int16_t
+
+so for a similarity matrix with elements in [0,1] every element is within 0.002(int8_t) of the float
+value. The error of spmv and of the sums is bounded by adding these errors(times |x(j)| for spmv).
+The testcases check these bounds against the float results.
+**************************************************************************************************/
+
+//Elements of the packed vector sharing one scale and zero-point
+#ifndef SYMMAT_QUANT_BLOCK
+#define SYMMAT_QUANT_BLOCK 256
+#endif
+
+//Scale and zero-point of a block
+struct SymMatQuantBlock
+{
+	float scale;
+	float zero;
+};
+
+
+/*************************************************************************************************
+						INTEGER KERNELS
+**************************************************************************************************/
+namespace SymMatInternal
+{
+
+//element = scale*(q - zero), for n integers of one block
+template<typename _Scalar,typename _Integer>
+inline void dequantizeScalar(const _Integer* q,Eigen::Index n,const SymMatQuantBlock& b,_Scalar* dst)
+{
+	for(Eigen::Index k=0;k<n;k++)
+	{
+		dst[k]=_Scalar(b.scale)*(_Scalar(q[k])-_Scalar(b.zero));
+	}
+}
+
+//Sum of n integers(n is at most a block)
+template<typename _Integer>
+inline int64_t quantSumScalar(const _Integer* q,Eigen::Index n)
+{
+	int64_t total=0;
+	for(Eigen::Index k=0;k<n;k++)
+	{
+		total+=q[k];
+	}
+	return total;
+}
+
+template<typename _Integer>
+inline void quantMinMaxScalar(const _Integer* q,Eigen::Index n,int& lo,int& hi)
+{
+	for(Eigen::Index k=0;k<n;k++)
+	{
+		lo=std::min(lo,int(q[k]));
+		hi=std::max(hi,int(q[k]));
+	}
+}
+
+#if defined(SYMMAT_X86_DISPATCH)
+#define SYMMAT_VNNI __attribute__((target("avx512f,avx512bw,avx512vnni")))
+
+inline bool hasVnni()
+{
+	static const bool vnni=__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw")
+						   && __builtin_cpu_supports("avx512vnni");
+	return vnni;
+}
+
+//8 integers widened to float and dequantized at a time
+SYMMAT_AVX2 inline void dequantizeAvx2(const int8_t* q,Eigen::Index n,const SymMatQuantBlock& b,float* dst)
+{
+	const __m256 scale=_mm256_set1_ps(b.scale),zero=_mm256_set1_ps(b.zero);
+	Eigen::Index k=0;
+	for(;k+8<=n;k+=8)
+	{
+		const __m256 v=_mm256_cvtepi32_ps(_mm256_cvtepi8_epi32(_mm_loadl_epi64((const __m128i*)(q+k))));
+		_mm256_storeu_ps(dst+k,_mm256_mul_ps(scale,_mm256_sub_ps(v,zero)));
+	}
+	dequantizeScalar(q+k,n-k,b,dst+k);
+}
+
+SYMMAT_AVX2 inline void dequantizeAvx2(const int16_t* q,Eigen::Index n,const SymMatQuantBlock& b,float* dst)
+{
+	const __m256 scale=_mm256_set1_ps(b.scale),zero=_mm256_set1_ps(b.zero);
+	Eigen::Index k=0;
+	for(;k+8<=n;k+=8)
+	{
+		const __m256 v=_mm256_cvtepi32_ps(_mm256_cvtepi16_epi32(_mm_loadu_si128((const __m128i*)(q+k))));
+		_mm256_storeu_ps(dst+k,_mm256_mul_ps(scale,_mm256_sub_ps(v,zero)));
+	}
+	dequantizeScalar(q+k,n-k,b,dst+k);
+}
+
+//Sums as dot products with a vector of ones: u8*s8(VNNI) or s16*s16 pairs(VNNI and AVX2)
+SYMMAT_VNNI inline int64_t quantSumVnni(const int8_t* q,Eigen::Index n)
+{
+	const __m512i ones=_mm512_set1_epi8(1);
+	__m512i acc=_mm512_setzero_si512();
+	Eigen::Index k=0;
+	for(;k+64<=n;k+=64)
+	{
+		acc=_mm512_dpbusd_epi32(acc,ones,_mm512_loadu_si512((const void*)(q+k)));
+	}
+	return _mm512_reduce_add_epi32(acc)+quantSumScalar(q+k,n-k);
+}
+
+SYMMAT_VNNI inline int64_t quantSumVnni(const int16_t* q,Eigen::Index n)
+{
+	const __m512i ones=_mm512_set1_epi16(1);
+	__m512i acc=_mm512_setzero_si512();
+	Eigen::Index k=0;
+	for(;k+32<=n;k+=32)
+	{
+		acc=_mm512_dpwssd_epi32(acc,_mm512_loadu_si512((const void*)(q+k)),ones);
+	}
+	return _mm512_reduce_add_epi32(acc)+quantSumScalar(q+k,n-k);
+}
+
+SYMMAT_AVX2 inline int64_t reduceAddAvx2(__m256i acc)
+{
+	alignas(32) int32_t lanes[8];
+	_mm256_store_si256((__m256i*)lanes,acc);
+	int64_t total=0;
+	for(int l=0;l<8;l++)
+	{
+		total+=lanes[l];
+	}
+	return total;
+}
+
+SYMMAT_AVX2 inline int64_t quantSumAvx2(const int8_t* q,Eigen::Index n)
+{
+	const __m256i ones=_mm256_set1_epi16(1);
+	__m256i acc=_mm256_setzero_si256();
+	Eigen::Index k=0;
+	for(;k+16<=n;k+=16)
+	{
+		const __m256i v=_mm256_cvtepi8_epi16(_mm_loadu_si128((const __m128i*)(q+k)));
+		acc=_mm256_add_epi32(acc,_mm256_madd_epi16(v,ones));
+	}
+	return reduceAddAvx2(acc)+quantSumScalar(q+k,n-k);
+}
+
+SYMMAT_AVX2 inline int64_t quantSumAvx2(const int16_t* q,Eigen::Index n)
+{
+	const __m256i ones=_mm256_set1_epi16(1);
+	__m256i acc=_mm256_setzero_si256();
+	Eigen::Index k=0;
+	for(;k+16<=n;k+=16)
+	{
+		acc=_mm256_add_epi32(acc,_mm256_madd_epi16(_mm256_loadu_si256((const __m256i*)(q+k)),ones));
+	}
+	return reduceAddAvx2(acc)+quantSumScalar(q+k,n-k);
+}
+
+SYMMAT_AVX2 inline void quantMinMaxAvx2(const int8_t* q,Eigen::Index n,int& lo,int& hi)
+{
+	__m256i mn=_mm256_set1_epi8(127),mx=_mm256_set1_epi8(-128);
+	Eigen::Index k=0;
+	for(;k+32<=n;k+=32)
+	{
+		const __m256i v=_mm256_loadu_si256((const __m256i*)(q+k));
+		mn=_mm256_min_epi8(mn,v);
+		mx=_mm256_max_epi8(mx,v);
+	}
+	//The registers start at the sentinels, which are not values of the block when the loop did not run
+	if(k>0)
+	{
+		alignas(32) int8_t a[32],b[32];
+		_mm256_store_si256((__m256i*)a,mn);
+		_mm256_store_si256((__m256i*)b,mx);
+		quantMinMaxScalar(a,32,lo,hi);
+		quantMinMaxScalar(b,32,lo,hi);
+	}
+	quantMinMaxScalar(q+k,n-k,lo,hi);
+}
+
+SYMMAT_AVX2 inline void quantMinMaxAvx2(const int16_t* q,Eigen::Index n,int& lo,int& hi)
+{
+	__m256i mn=_mm256_set1_epi16(32767),mx=_mm256_set1_epi16(-32768);
+	Eigen::Index k=0;
+	for(;k+16<=n;k+=16)
+	{
+		const __m256i v=_mm256_loadu_si256((const __m256i*)(q+k));
+		mn=_mm256_min_epi16(mn,v);
+		mx=_mm256_max_epi16(mx,v);
+	}
+	//The registers start at the sentinels, which are not values of the block when the loop did not run
+	if(k>0)
+	{
+		alignas(32) int16_t a[16],b[16];
+		_mm256_store_si256((__m256i*)a,mn);
+		_mm256_store_si256((__m256i*)b,mx);
+		quantMinMaxScalar(a,16,lo,hi);
+		quantMinMaxScalar(b,16,lo,hi);
+	}
+	quantMinMaxScalar(q+k,n-k,lo,hi);
+}
+#endif
+
+//Dispatchers(the double and the non x86 versions are the portable loops)
+template<typename _Scalar,typename _Integer>
+inline void dequantize(const _Integer* q,Eigen::Index n,const SymMatQuantBlock& b,_Scalar* dst)
+{
+	dequantizeScalar(q,n,b,dst);
+}
+
+template<typename _Integer>
+inline void dequantize(const _Integer* q,Eigen::Index n,const SymMatQuantBlock& b,float* dst)
+{
+#if defined(SYMMAT_X86_DISPATCH)
+	if(simdLevel()>=SimdAvx2)
+	{
+		dequantizeAvx2(q,n,b,dst);
+		return;
+	}
+#endif
+	dequantizeScalar(q,n,b,dst);
+}
+
+template<typename _Integer>
+inline int64_t quantSum(const _Integer* q,Eigen::Index n)
+{
+#if defined(SYMMAT_X86_DISPATCH)
+	if(hasVnni())
+	{
+		return quantSumVnni(q,n);
+	}
+	if(simdLevel()>=SimdAvx2)
+	{
+		return quantSumAvx2(q,n);
+	}
+#endif
+	return quantSumScalar(q,n);
+}
+
+template<typename _Integer>
+inline void quantMinMax(const _Integer* q,Eigen::Index n,int& lo,int& hi)
+{
+#if defined(SYMMAT_X86_DISPATCH)
+	if(simdLevel()>=SimdAvx2)
+	{
+		quantMinMaxAvx2(q,n,lo,hi);
+		return;
+	}
+#endif
+	quantMinMaxScalar(q,n,lo,hi);
+}
+
+//Position in a quantized packed vector, read by the kernels of SymMat.h through readPacked
+template<typename _Integer>
+struct QuantCursor
+{
+	const _Integer* q;
+	const SymMatQuantBlock* blocks;
+	Eigen::Index pos;
+
+	QuantCursor operator+(Eigen::Index k) const
+	{
+		QuantCursor moved=*this;
+		moved.pos+=k;
+		return moved;
+	}
+};
+
+//Dequantizes n elements from the cursor on, one piece of a block at a time
+template<typename _Scalar,typename _Integer>
+inline void readPacked(const QuantCursor<_Integer>& src,Eigen::Index n,_Scalar* dst)
+{
+	const Eigen::Index bs=SYMMAT_QUANT_BLOCK;
+	for(Eigen::Index k=0;k<n;)
+	{
+		const Eigen::Index pos=src.pos+k;
+		const Eigen::Index len=std::min(n-k,bs-pos%bs);
+		dequantize(src.q+pos,len,src.blocks[pos/bs],dst+k);
+		k+=len;
+	}
+}
+
+} //namespace SymMatInternal
+
+
+/*************************************************************************************************
+						CLASS DEFINITION
+_Integer is int8_t or int16_t. The elements are read as float, SymMatQuant takes part in the
+expressions like SymMat<float>, and it is changed by quantizing a matrix again(the elements can not
+be assigned one at a time, they share the scale of their block).
+**************************************************************************************************/
+template<typename _Integer>
+class SymMatQuant : public SymMatExpr< SymMatQuant<_Integer> >
+{
+	static_assert(std::is_same<_Integer,int8_t>::value || std::is_same<_Integer,int16_t>::value,
+				  "SymMatQuant stores int8_t or int16_t");
+
+public:
+
+	//The elements are computed as float
+	typedef float Scalar;
+
+	//Order of the matrix
+	int order;
+
+	//Quantized packed vector, and the scale and zero-point of each block of it
+	typedef std::vector< _Integer,SymMatAllocator<_Integer> > Storage;
+	Storage mat;
+	std::vector<SymMatQuantBlock> blocks;
+
+	//Default constructor(3x3 matrix of zeros, like SymMat)
+	SymMatQuant() :order(0) { *this=SymMat<float>(); }
+
+	//Parametrized constructor(parameter is order of matrice), all the elements are '0'
+	explicit SymMatQuant(int o) :order(0) { *this=SymMat<float>(o); }
+
+	//Quantizes a symmetric matrix or expression
+	template<typename _Derived>
+	SymMatQuant(const SymMatExpr<_Derived>& other) :order(0) { *this=other; }
+
+	template<typename _Derived>
+	SymMatQuant& operator=(const SymMatExpr<_Derived>&);
+
+	//Element at position k of the packed vector(used by the expressions)
+	float coeff(Eigen::Index k) const
+	{
+		const SymMatQuantBlock& b=blocks[k/SYMMAT_QUANT_BLOCK];
+		return b.scale*(float(mat[k])-b.zero);
+	}
+
+	//No. of elements stored in the classical packed format
+	Eigen::Index size() const { return Eigen::Index(mat.size()); }
+	Eigen::Index elemstored() const { return size(); }
+
+	//Returns the index of the element (i,j) stored in the vector
+	Eigen::Index index(Eigen::Index i,Eigen::Index j) const
+	{
+		if(i>j)  //only the upper triangle is stored
+		{
+			std::swap(i,j);
+		}
+		return SymMatInternal::diagIndex(order,i)+(j-i);
+	}
+
+	float operator()(Eigen::Index i,Eigen::Index j) const { return coeff(index(i,j)); }
+
+	//The packed vector as read by the kernels(spmv, mult)
+	SymMatInternal::QuantCursor<_Integer> packed() const
+	{
+		SymMatInternal::QuantCursor<_Integer> cursor={mat.data(),blocks.data(),0};
+		return cursor;
+	}
+
+	//Prints the matrix
+	void print() const;
+
+	/***REDUCTIONS(integer sums of the blocks, scaled once per block and added in double)*****/
+	float sum() const;
+	float mean() const;
+	float packedSum() const;
+	float packedMean() const;
+	float trace() const;
+	float minCoeff() const;
+	float maxCoeff() const;
+
+	//The k largest elements of row i(without the diagonal unless diagonal is true), largest first
+	void topk(Eigen::Index i,int k,Eigen::VectorXi& cols,Eigen::VectorXf& values,bool diagonal=false) const;
+};
+
+//Matrices are only referred to inside the expressions, never copied
+template<typename _Integer>
+struct SymMatTraits< SymMatQuant<_Integer> >
+{
+	typedef float Scalar;
+	typedef const SymMatQuant<_Integer>& Nested;
+};
+
+
+/*************************************************************************************************
+						QUANTIZATION
+Each block is evaluated into a float buffer, its range gives the scale and the zero-point, and each
+element is rounded to the nearest level. A block of equal elements is stored exactly(scale 1).
+**************************************************************************************************/
+template<typename _Integer>
+template<typename _Derived>
+SymMatQuant<_Integer>& SymMatQuant<_Integer>::operator=(const SymMatExpr<_Derived>& other)
+{
+	const _Derived& expr=other.derived();
+	const Eigen::Index elements=expr.size(),bs=SYMMAT_QUANT_BLOCK;
+	const double qmin=std::numeric_limits<_Integer>::min(),qmax=std::numeric_limits<_Integer>::max();
+
+	//Storage is only reallocated when the order changes
+	if(order!=expr.order || Eigen::Index(mat.size())!=elements)
+	{
+		order=expr.order;
+		mat.resize(elements);
+		blocks.resize((elements+bs-1)/bs);
+	}
+
+	float buffer[SYMMAT_QUANT_BLOCK];
+	for(Eigen::Index first=0;first<elements;first+=bs)
+	{
+		const Eigen::Index len=std::min(bs,elements-first);
+		float lo=std::numeric_limits<float>::infinity(),hi=-lo;
+		for(Eigen::Index k=0;k<len;k++)
+		{
+			buffer[k]=float(expr.coeff(first+k));
+			lo=std::min(lo,buffer[k]);
+			hi=std::max(hi,buffer[k]);
+		}
+
+		//The scale and the zero-point are rounded to float before the elements are rounded with them
+		double scale=(double(hi)-double(lo))/(qmax-qmin);
+		if(!(scale>0))
+		{
+			scale=1;
+		}
+		SymMatQuantBlock& b=blocks[first/bs];
+		b.scale=float(scale);
+		b.zero=float(qmin-double(lo)/double(b.scale));
+		for(Eigen::Index k=0;k<len;k++)
+		{
+			const double level=std::nearbyint(double(buffer[k])/double(b.scale)+double(b.zero));
+			mat[first+k]=_Integer(std::min(qmax,std::max(qmin,level)));
+		}
+	}
+	return *this;
+}
+
+//The whole matrix back in float
+template<typename _Integer>
+SymMat<float> dequantize(const SymMatQuant<_Integer>& m1)
+{
+	SymMat<float> m2(m1.order);
+	SymMatInternal::readPacked(m1.packed(),m1.size(),m2.mat.data());
+	return m2;
+}
+
+
+/*************************************************************************************************
+						REDUCTIONS
+The sum of a block is scale*(sum of q - zero*elements), so only the integers are added element by
+element.
+**************************************************************************************************/
+template<typename _Integer>
+float SymMatQuant<_Integer>::packedSum() const
+{
+	const Eigen::Index elements=size(),bs=SYMMAT_QUANT_BLOCK;
+	double total=0;
+	for(Eigen::Index first=0;first<elements;first+=bs)
+	{
+		const Eigen::Index len=std::min(bs,elements-first);
+		const SymMatQuantBlock& b=blocks[first/bs];
+		total+=double(b.scale)*(double(SymMatInternal::quantSum(mat.data()+first,len))-double(b.zero)*double(len));
+	}
+	return float(total);
+}
+
+template<typename _Integer>
+float SymMatQuant<_Integer>::trace() const
+{
+	double total=0;
+	Eigen::Index diag=0;
+	for(int i=0;i<order;i++)
+	{
+		total+=coeff(diag);
+		diag+=order-i;
+	}
+	return float(total);
+}
+
+//2*(sum of packed vector) - trace, like SymMat::sum()
+template<typename _Integer>
+float SymMatQuant<_Integer>::sum() const
+{
+	return float(2*double(packedSum())-double(trace()));
+}
+
+template<typename _Integer>
+float SymMatQuant<_Integer>::mean() const
+{
+	return float(double(sum())/(double(order)*double(order)));
+}
+
+template<typename _Integer>
+float SymMatQuant<_Integer>::packedMean() const
+{
+	return float(double(packedSum())/double(size()));
+}
+
+//The smallest integer of a block is its smallest element, since the scale is positive
+template<typename _Integer>
+float SymMatQuant<_Integer>::minCoeff() const
+{
+	const Eigen::Index elements=size(),bs=SYMMAT_QUANT_BLOCK;
+	float m=std::numeric_limits<float>::infinity();
+	for(Eigen::Index first=0;first<elements;first+=bs)
+	{
+		int lo=std::numeric_limits<int>::max(),hi=std::numeric_limits<int>::min();
+		SymMatInternal::quantMinMax(mat.data()+first,std::min(bs,elements-first),lo,hi);
+		const SymMatQuantBlock& b=blocks[first/bs];
+		m=std::min(m,b.scale*(float(lo)-b.zero));
+	}
+	return m;
+}
+
+template<typename _Integer>
+float SymMatQuant<_Integer>::maxCoeff() const
+{
+	const Eigen::Index elements=size(),bs=SYMMAT_QUANT_BLOCK;
+	float m=-std::numeric_limits<float>::infinity();
+	for(Eigen::Index first=0;first<elements;first+=bs)
+	{
+		int lo=std::numeric_limits<int>::max(),hi=std::numeric_limits<int>::min();
+		SymMatInternal::quantMinMax(mat.data()+first,std::min(bs,elements-first),lo,hi);
+		const SymMatQuantBlock& b=blocks[first/bs];
+		m=std::max(m,b.scale*(float(hi)-b.zero));
+	}
+	return m;
+}
+
+//Row i is column i above the diagonal(one element per packed row) and packed row i from the diagonal
+template<typename _Integer>
+void SymMatQuant<_Integer>::topk(Eigen::Index i,int k,Eigen::VectorXi& cols,Eigen::VectorXf& values,bool diagonal) const
+{
+	assert(i>=0 && i<order);       //Condition for the row to be in the matrix
+	std::vector<float> row(order);
+	for(Eigen::Index j=0;j<i;j++)
+	{
+		row[j]=coeff(index(j,i));
+	}
+	SymMatInternal::readPacked(packed()+SymMatInternal::diagIndex(order,i),order-i,row.data()+i);
+
+	std::vector<int> candidates;
+	candidates.reserve(order);
+	for(int j=0;j<order;j++)
+	{
+		if(diagonal || j!=i)
+		{
+			candidates.push_back(j);
+		}
+	}
+
+	//Largest first, the smaller column first among equal elements
+	k=std::max(0,std::min(k,int(candidates.size())));
+	std::partial_sort(candidates.begin(),candidates.begin()+k,candidates.end(),
+					  [&](int a,int b){ return row[a]>row[b] || (row[a]==row[b] && a<b); });
+	cols.resize(k);
+	values.resize(k);
+	for(int c=0;c<k;c++)
+	{
+		cols(c)=candidates[c];
+		values(c)=row[candidates[c]];
+	}
+}
+
+template<typename _Integer>
+void SymMatQuant<_Integer>::print() const
+{
+	for(int i=0;i<order;i++)
+	{
+		for(int j=0;j<order;j++)
+		{
+			std::cout<<std::setw(4)<<(*this)(i,j)<<" ";  //setw() here sets 4 digits space for each element
+		}
+		std::cout<<"\n";
+	}
+}
+
+
+/*************************************************************************************************
+						MATRIX-VECTOR PRODUCT AND MULTIPLICATION
+The same kernels as for SymMat(see SymMat.h), reading the rows through the quantized cursor. _Scalar
+is the type of the vectors/matrices and of the arithmetic(float, or double).
+**************************************************************************************************/
+template<typename _Integer,typename _Scalar>
+void spmv(_Scalar alpha,const SymMatQuant<_Integer>& m1,const _Scalar* x,_Scalar beta,_Scalar* y)
+{
+	SymMatInternal::spmv(Eigen::Index(m1.order),alpha,m1.packed(),x,beta,y);
+}
+
+template<typename _Integer,typename _Scalar,int _Rows>
+void spmv(_Scalar alpha,const SymMatQuant<_Integer>& m1,const Eigen::Matrix<_Scalar,_Rows,1>& x,_Scalar beta,Eigen::Matrix<_Scalar,_Rows,1>& y)
+{
+	assert(m1.order==x.rows());       //Condition for the matrix and the vector to be conformable
+	y.resize(m1.order);
+	SymMatInternal::spmv(Eigen::Index(m1.order),alpha,m1.packed(),x.data(),beta,y.data());
+}
+
+template<typename _Integer,typename _Scalar,int _Rows,int _Cols>
+Eigen::Matrix<_Scalar,_Rows,_Cols> mult(const SymMatQuant<_Integer>& m1,Eigen::Matrix<_Scalar,_Rows,_Cols>& m2)
+{
+	assert(m1.order==m2.rows());       //Condition for matrices to be conformable for multiplication
+	Eigen::Matrix<_Scalar,_Rows,_Cols> m3(m1.order,m2.cols());
+	SymMatInternal::symmLeft(Eigen::Index(m1.order),m1.packed(),m2,m3);
+	return m3;
+}
+
+template<typename _Integer,typename _Scalar,int _Rows,int _Cols>
+Eigen::Matrix<_Scalar,_Rows,_Cols> mult(Eigen::Matrix<_Scalar,_Rows,_Cols>& m2,const SymMatQuant<_Integer>& m1)
+{
+	assert(m1.order==m2.cols());       //Condition for matrices to be conformable for multiplication
+	Eigen::Matrix<_Scalar,_Rows,_Cols> m3(m2.rows(),m1.order);
+	SymMatInternal::symmRight(Eigen::Index(m1.order),m1.packed(),m2,m3);
+	return m3;
+}
+
+
+//------------------------------------------------------------------------------------------------
+#endif //SYMMAT_QUANT_H
+/*************************************************************************************************
+								SYMMAT QUANT HEADER FILE ENDED
+**************************************************************************************************/
@@ -0,0 +1,442 @@
+/***********************************************************************************************
+This header file contains SymMatSparse - a sparse symmetric matrix
+
+SymMat always stores all the n(n+1)/2 elements of the triangle. For matrices which are almost all
+zero(graph Laplacians, finite element stiffness matrices) SymMatSparse stores only the nonzero
+elements of the lower triangle, in compressed sparse row(CSR) format:-
+
+	rowptr	 n+1 positions, the elements of row i are rowptr[i]..rowptr[i+1]-1
+	col		 column of each element(j<=i), increasing inside a row
+	val		 value of each element
+
+Row i of the lower triangle is column i of the upper triangle, so the same arrays are also the upper
+triangle in compressed sparse column format(which is how they are given to Eigen).
+
+************************************************************************************************/
+//-----------------------------------------------------------------------------------------------
+
+
+/************************************************************************************************
+						INCLUDE GAURDS
+*************************************************************************************************/
+#ifndef SYMMAT_SPARSE_H
+#define SYMMAT_SPARSE_H
+
+
+/*************************************************************************************************
+						INCLUDING THE DEPENDENCIES
+**************************************************************************************************/
+#include "SymMat.h"				//packed SymMat
+#include <Eigen/Sparse>			//conversions to and from Eigen::SparseMatrix
+#include <climits>				//to use INT_MAX
+
+
+/*************************************************************************************************
+						CLASS DEFINITION
+**************************************************************************************************/
+template <typename _Scalar>
+class SymMatSparse
+{
+public:
+
+	typedef _Scalar Scalar;
+
+	//(i,j,v) triplet, one element for the assembly
+	typedef Eigen::Triplet<_Scalar> Triplet;
+
+	//Order of the matrix
+	int order;
+
+	//Lower triangle in CSR format
+	std::vector<Eigen::Index> rowptr;
+	std::vector<int> col;
+	std::vector<_Scalar> val;
+
+	//Default constructor(3x3 matrix of zeros, like SymMat)
+	SymMatSparse() { resize(3); }
+
+	//Parametrized constructor(parameter is order of matrice), no elements are stored
+	explicit SymMatSparse(int o) { resize(o); }
+
+	//Changes the order of the matrix and removes all the elements
+	void resize(int o)
+	{
+		order=o;
+		rowptr.assign(size_t(o)+1,0);
+		col.clear();
+		val.clear();
+	}
+
+	//Builds the matrix from (i,j,v) triplets, see ASSEMBLY
+	template<typename _Iterator>
+	void setFromTriplets(_Iterator,_Iterator);
+
+	//No. of elements stored(nonzeros of the lower triangle)
+	Eigen::Index nonZeros() const { return Eigen::Index(val.size()); }
+
+	//Element (i,j), zero when it is not stored
+	_Scalar coeff(int i,int j) const
+	{
+		if(i<j)  //only the lower triangle is stored
+		{
+			std::swap(i,j);
+		}
+		const int* first=col.data()+rowptr[i];
+		const int* last=col.data()+rowptr[i+1];
+		const int* p=std::lower_bound(first,last,j);
+		return (p!=last && *p==j) ? val[p-col.data()] : _Scalar(0);
+	}
+};
+
+
+/*************************************************************************************************
+						ASSEMBLY
+						--------
+The triplets can be in any order, have (i,j) or (j,i) for an off-diagonal element, and the same
+element can appear many times(the values are added, like the contributions of the elements of a
+finite element mesh).
+
+1)Every triplet is moved to the lower triangle and counted in its row.
+2)The rows are laid out with a prefix sum of the counts, and the triplets are scattered to their rows.
+3)Every row is sorted by column and its duplicates are summed.
+4)The rows are packed together without the space freed by the duplicates.
+
+Steps 1, 2 and 4 use atomic counters and steps 3 and 4 work on independent rows, so all of them are
+shared between the threads when OpenMP is used.
+**************************************************************************************************/
+template<typename _Scalar>
+template<typename _Iterator>
+void SymMatSparse<_Scalar>::setFromTriplets(_Iterator begin,_Iterator end)
+{
+	const std::vector<Triplet> triplets(begin,end);
+	const Eigen::Index n=order,count=Eigen::Index(triplets.size());
+
+	//1)No. of elements of each row
+	std::vector<Eigen::Index> start(size_t(n)+1,0);
+#ifdef _OPENMP
+	#pragma omp parallel for schedule(static)
+#endif
+	for(Eigen::Index t=0;t<count;t++)
+	{
+		const Eigen::Index i=std::max(triplets[t].row(),triplets[t].col());
+		assert(i<n && std::min(triplets[t].row(),triplets[t].col())>=0);
+#ifdef _OPENMP
+		#pragma omp atomic
+#endif
+		start[i+1]++;
+	}
+	for(Eigen::Index i=0;i<n;i++)
+	{
+		start[i+1]+=start[i];
+	}
+
+	//2)Scatter to the rows
+	std::vector<Eigen::Index> fill(start.begin(),start.end()-1);
+	std::vector<int> c(count);
+	std::vector<_Scalar> v(count);
+#ifdef _OPENMP
+	#pragma omp parallel for schedule(static)
+#endif
+	for(Eigen::Index t=0;t<count;t++)
+	{
+		const Eigen::Index i=std::max(triplets[t].row(),triplets[t].col());
+		Eigen::Index pos;
+#ifdef _OPENMP
+		#pragma omp atomic capture
+#endif
+		pos=fill[i]++;
+		c[pos]=int(std::min(triplets[t].row(),triplets[t].col()));
+		v[pos]=triplets[t].value();
+	}
+
+	//3)Sorts every row and sums the duplicates at its beginning, fill(i) becomes the new length
+#ifdef _OPENMP
+	#pragma omp parallel
+#endif
+	{
+		std::vector< std::pair<int,_Scalar> > row;		//one buffer per thread
+
+#ifdef _OPENMP
+		#pragma omp for schedule(dynamic,1024)
+#endif
+		for(Eigen::Index i=0;i<n;i++)
+		{
+			const Eigen::Index first=start[i],len=start[i+1]-first;
+			row.resize(len);
+			for(Eigen::Index k=0;k<len;k++)
+			{
+				row[k]=std::make_pair(c[first+k],v[first+k]);
+			}
+			std::sort(row.begin(),row.end(),[](const std::pair<int,_Scalar>& a,const std::pair<int,_Scalar>& b){ return a.first<b.first; });
+
+			Eigen::Index out=0;
+			for(Eigen::Index k=0;k<len;k++)
+			{
+				if(out>0 && c[first+out-1]==row[k].first)
+				{
+					v[first+out-1]+=row[k].second;
+				}
+				else
+				{
+					c[first+out]=row[k].first;
+					v[first+out]=row[k].second;
+					out++;
+				}
+			}
+			fill[i]=out;
+		}
+	}
+
+	//4)Packs the rows together
+	rowptr.assign(size_t(n)+1,0);
+	for(Eigen::Index i=0;i<n;i++)
+	{
+		rowptr[i+1]=rowptr[i]+fill[i];
+	}
+	col.resize(rowptr[n]);
+	val.resize(rowptr[n]);
+#ifdef _OPENMP
+	#pragma omp parallel for schedule(static)
+#endif
+	for(Eigen::Index i=0;i<n;i++)
+	{
+		std::copy(c.begin()+start[i],c.begin()+start[i]+fill[i],col.begin()+rowptr[i]);
+		std::copy(v.begin()+start[i],v.begin()+start[i]+fill[i],val.begin()+rowptr[i]);
+	}
+}
+
+
+/*************************************************************************************************
+						CONVERSIONS
+toSparse(S)			SymMat -> SymMatSparse(the elements equal to zero are not stored)
+toPacked(S)			SymMatSparse -> SymMat
+toSparseMatrix(S)	SymMatSparse -> Eigen::SparseMatrix holding the upper triangle(use it through
+					selfadjointView<Eigen::Upper>()), the arrays are copied as they are
+toSparse(A)			lower triangle(i>=j) of an Eigen::SparseMatrix -> SymMatSparse
+**************************************************************************************************/
+template<typename _Scalar>
+SymMatSparse<_Scalar> toSparse(SymMat<_Scalar>& m1)
+{
+	const Eigen::Index n=m1.order;
+	SymMatSparse<_Scalar> m2(m1.order);
+
+	//Packed row i is column i of the upper triangle = elements (j,i) of the lower rows j>=i
+	Eigen::Index k=0;
+	for(Eigen::Index i=0;i<n;i++)
+	{
+		for(Eigen::Index j=i;j<n;j++,k++)
+		{
+			if(m1.mat[k]!=_Scalar(0))
+			{
+				m2.rowptr[j+1]++;
+			}
+		}
+	}
+	for(Eigen::Index i=0;i<n;i++)
+	{
+		m2.rowptr[i+1]+=m2.rowptr[i];
+	}
+	m2.col.resize(m2.rowptr[n]);
+	m2.val.resize(m2.rowptr[n]);
+
+	//Going through the packed rows in order fills every lower row with increasing columns
+	std::vector<Eigen::Index> fill(m2.rowptr.begin(),m2.rowptr.end()-1);
+	k=0;
+	for(Eigen::Index i=0;i<n;i++)
+	{
+		for(Eigen::Index j=i;j<n;j++,k++)
+		{
+			if(m1.mat[k]!=_Scalar(0))
+			{
+				m2.col[fill[j]]=int(i);
+				m2.val[fill[j]++]=m1.mat[k];
+			}
+		}
+	}
+	return m2;
+}
+
+template<typename _Scalar>
+SymMat<_Scalar> toPacked(SymMatSparse<_Scalar>& m1)
+{
+	const Eigen::Index n=m1.order;
+	SymMat<_Scalar> m2(m1.order);
+	for(Eigen::Index i=0;i<n;i++)
+	{
+		for(Eigen::Index k=m1.rowptr[i];k<m1.rowptr[i+1];k++)
+		{
+			const Eigen::Index j=m1.col[k];
+			m2.mat[SymMatInternal::diagIndex(n,j)+(i-j)]=m1.val[k];
+		}
+	}
+	return m2;
+}
+
+template<typename _Scalar>
+Eigen::SparseMatrix<_Scalar> toSparseMatrix(SymMatSparse<_Scalar>& m1)
+{
+	assert(m1.nonZeros()<=Eigen::Index(INT_MAX));       //Eigen::SparseMatrix uses int positions
+	Eigen::SparseMatrix<_Scalar> m2(m1.order,m1.order);
+	m2.resizeNonZeros(m1.nonZeros());
+	std::copy(m1.rowptr.begin(),m1.rowptr.end(),m2.outerIndexPtr());
+	std::copy(m1.col.begin(),m1.col.end(),m2.innerIndexPtr());
+	std::copy(m1.val.begin(),m1.val.end(),m2.valuePtr());
+	return m2;
+}
+
+template<typename _Scalar,int _Options,typename _StorageIndex>
+SymMatSparse<_Scalar> toSparse(const Eigen::SparseMatrix<_Scalar,_Options,_StorageIndex>& m1)
+{
+	assert(m1.rows()==m1.cols());       //Condition for the matrix to be symmetric
+	typedef typename Eigen::SparseMatrix<_Scalar,_Options,_StorageIndex>::InnerIterator Iterator;
+	std::vector< Eigen::Triplet<_Scalar> > triplets;
+	triplets.reserve(m1.nonZeros());
+	for(Eigen::Index o=0;o<m1.outerSize();o++)
+	{
+		for(Iterator it(m1,o);it;++it)
+		{
+			if(it.row()>=it.col())
+			{
+				triplets.push_back(Eigen::Triplet<_Scalar>(it.row(),it.col(),it.value()));
+			}
+		}
+	}
+	SymMatSparse<_Scalar> m2(int(m1.rows()));
+	m2.setFromTriplets(triplets.begin(),triplets.end());
+	return m2;
+}
+
+
+/*************************************************************************************************
+						MATRIX-VECTOR PRODUCT
+					-----------------------------
+y = alpha*S*x + beta*y
+
+Every stored element (i,j), j<i, is used for both y(i)+=S(i,j)*x(j) and y(j)+=S(i,j)*x(i) while it is
+read, so every nonzero is read once, like the packed spmv.
+
+With OpenMP the rows are split between the threads so that each gets about the same number of nonzeros.
+The y(j) part of a thread only goes to the columns its rows touch, j = (first column of its rows) ..
+(last row), so each thread adds into its own buffer of that length, and the buffers are added into y at
+the end. For matrices with a small bandwidth the buffers are short.
+**************************************************************************************************/
+namespace SymMatInternal
+{
+
+//Adds alpha*(rows first..last-1 of S)*x and their transposed parts into y(offset by base)
+template<typename _Scalar>
+void sparseRows(const SymMatSparse<_Scalar>& m1,Eigen::Index first,Eigen::Index last,_Scalar alpha,const _Scalar* x,_Scalar* y,Eigen::Index base)
+{
+	const Eigen::Index* rowptr=m1.rowptr.data();
+	const int* col=m1.col.data();
+	const _Scalar* val=m1.val.data();
+	for(Eigen::Index i=first;i<last;i++)
+	{
+		const _Scalar xi=alpha*x[i];
+		_Scalar temp=0;
+		for(Eigen::Index k=rowptr[i];k<rowptr[i+1];k++)
+		{
+			const Eigen::Index j=col[k];
+			if(j!=i)
+			{
+				temp+=val[k]*x[j];
+				y[j-base]+=val[k]*xi;
+			}
+			else
+			{
+				y[i-base]+=val[k]*xi;
+			}
+		}
+		y[i-base]+=alpha*temp;
+	}
+}
+
+} //namespace SymMatInternal
+
+template<typename _Scalar>
+void spmv(_Scalar alpha,SymMatSparse<_Scalar>& m1,const _Scalar* x,_Scalar beta,_Scalar* y)
+{
+	const Eigen::Index n=m1.order;
+	for(Eigen::Index i=0;i<n;i++)
+	{
+		y[i]= beta==_Scalar(0) ? _Scalar(0) : beta*y[i];
+	}
+
+#ifdef _OPENMP
+	const int threads=omp_get_max_threads();
+	if(m1.nonZeros()>=Eigen::Index(SYMMAT_PARALLEL_THRESHOLD)*SYMMAT_PARALLEL_THRESHOLD/2 && threads>1 && !omp_in_parallel())
+	{
+		//Rows of each thread, with the same number of nonzeros
+		std::vector<Eigen::Index> bounds(threads+1,n);
+		bounds[0]=0;
+		for(int t=1,i=0;t<threads;t++)
+		{
+			const Eigen::Index target=(m1.nonZeros()*t)/threads;
+			while(i<n && m1.rowptr[i]<target)
+			{
+				i++;
+			}
+			bounds[t]=i;
+		}
+
+		std::vector< std::vector<_Scalar> > partial(threads);
+		std::vector<Eigen::Index> low(threads);
+		#pragma omp parallel num_threads(threads)
+		{
+			//The team can be smaller than asked for, so every part(and its buffer) is taken by some thread
+			for(int t=omp_get_thread_num();t<threads;t+=omp_get_num_threads())
+			{
+				const Eigen::Index first=bounds[t],last=std::max(bounds[t],bounds[t+1]);
+
+				//Smallest column of the rows(the first element of each row)
+				Eigen::Index lo=last;
+				for(Eigen::Index i=first;i<last;i++)
+				{
+					if(m1.rowptr[i+1]>m1.rowptr[i])
+					{
+						lo=std::min(lo,Eigen::Index(m1.col[m1.rowptr[i]]));
+					}
+				}
+				lo=std::min(lo,first);
+				low[t]=lo;
+				partial[t].assign(last-lo,_Scalar(0));
+				SymMatInternal::sparseRows(m1,first,last,alpha,x,partial[t].data(),lo);
+			}
+
+			//Adds the buffers of all the threads together, each thread doing a part of y
+			#pragma omp barrier
+			#pragma omp for schedule(static)
+			for(Eigen::Index i=0;i<n;i++)
+			{
+				_Scalar total=0;
+				for(int p=0;p<threads;p++)
+				{
+					const Eigen::Index k=i-low[p];
+					if(k>=0 && k<Eigen::Index(partial[p].size()))
+					{
+						total+=partial[p][k];
+					}
+				}
+				y[i]+=total;
+			}
+		}
+		return;
+	}
+#endif
+	SymMatInternal::sparseRows(m1,Eigen::Index(0),n,alpha,x,y,Eigen::Index(0));
+}
+
+template<typename _Scalar,int _Rows>
+void spmv(_Scalar alpha,SymMatSparse<_Scalar>& m1,const Eigen::Matrix<_Scalar,_Rows,1>& x,_Scalar beta,Eigen::Matrix<_Scalar,_Rows,1>& y)
+{
+	assert(m1.order==x.rows());       //Condition for the matrix and the vector to be conformable
+	y.resize(m1.order);
+	spmv(alpha,m1,x.data(),beta,y.data());
+}
+
+
+//------------------------------------------------------------------------------------------------
+#endif //SYMMAT_SPARSE_H
+/*************************************************************************************************
+								SYMMAT SPARSE HEADER FILE ENDED
+**************************************************************************************************/
@@ -0,0 +1,84 @@
+/**********************************************************************************************
+		THIS FILE TIMES SymMat AT LARGE ORDERS, WITH AND WITHOUT TRANSPARENT HUGE PAGES
+
+The packed vector of order n has n(n+1)/2 elements, so from order 65536 its positions do not fit
+in an int. For each memory resource(the heap and SymMatHugePages) it times the creation of the
+matrix(which touches every page), the sum of the packed vector, spmv, and the two sweeps which
+jump between rows: the trace(one element per row) and a sweep down some columns through
+operator(). Usage:  ./benchlarge [order] [repetitions]
+
+Order 100000 takes 20GB of floats per matrix, only one matrix is alive at a time.
+************************************************************************************************/
+
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <cstdlib>
+#include <Eigen/Eigen>
+#include "SymMat.h"
+
+//Time taken by f in milliseconds(best of the repetitions)
+template<typename F>
+double timeit(F f,int reps)
+{
+	double best=1e300;
+	for(int r=0;r<reps;r++)
+	{
+		std::chrono::steady_clock::time_point start=std::chrono::steady_clock::now();
+		f();
+		std::chrono::duration<double,std::milli> t=std::chrono::steady_clock::now()-start;
+		best=std::min(best,t.count());
+	}
+	return best;
+}
+
+//Reads 64 columns spread over the matrix from top to bottom, each element is in a different row
+double columnsweep(SymMat<float>& m)
+{
+	double total=0;
+	const int step=std::max(1,m.order/64);
+	for(int j=0;j<m.order;j+=step)
+	{
+		for(int i=0;i<m.order;i++)
+		{
+			total+=m(i,j);
+		}
+	}
+	return total;
+}
+
+void run(const char* name,SymMatResource* resource,int n,int reps)
+{
+	volatile double sink=0;
+	std::chrono::steady_clock::time_point start=std::chrono::steady_clock::now();
+	SymMat<float> S(n,resource);
+	std::chrono::duration<double,std::milli> create=std::chrono::steady_clock::now()-start;
+
+	for(Eigen::Index k=0;k<S.elemstored();k++)
+	{
+		S.mat[k]=float(k%17)/17.0f-0.5f;
+	}
+	Eigen::VectorXf x=Eigen::VectorXf::Random(n),y(n);
+
+	std::cout<<std::setw(10)<<name
+			 <<std::setw(10)<<create.count()
+			 <<std::setw(12)<<timeit([&]{ sink=sink+S.packedSum(); },reps)
+			 <<std::setw(10)<<timeit([&]{ spmv(1.0f,S,x.data(),0.0f,y.data()); },reps)
+			 <<std::setw(10)<<timeit([&]{ sink=sink+S.trace(); },reps)
+			 <<std::setw(14)<<timeit([&]{ sink=sink+columnsweep(S); },reps)<<std::endl;
+}
+
+int main(int argc,char** argv)
+{
+	int n= argc>1 ? std::atoi(argv[1]) : 100000;
+	int reps= argc>2 ? std::atoi(argv[2]) : 3;
+
+	std::cout<<"order "<<n<<", "<<SymMatInternal::packedElements<float>(n)<<" elements, best of "<<reps<<" runs(ms)"<<std::endl;
+	std::cout<<std::setw(10)<<"memory"<<std::setw(10)<<"create"<<std::setw(12)<<"packedSum"<<std::setw(10)<<"spmv"
+			 <<std::setw(10)<<"trace"<<std::setw(14)<<"column sweep"<<std::endl;
+
+	run("heap",SymMatHeap::instance(),n,reps);
+	run("huge",SymMatHugePages::instance(),n,reps);
+
+	return 0;
+}
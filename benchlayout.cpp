@@ -0,0 +1,83 @@
+/**********************************************************************************************
+		THIS FILE COMPARES THE STORAGE LAYOUTS OF SymMatLayout.h WITH THE PACKED SymMat
+		
+It times, for each layout, the matrix-vector product and a sweep down every column,
+and the conversion from the packed format. Usage:  ./benchlayout [order] [repetitions]
+************************************************************************************************/
+
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <cstdlib>
+#include <Eigen/Eigen>
+#include "SymMat.h"
+#include "SymMatLayout.h"
+
+//Time taken by f in milliseconds(best of the repetitions)
+template<typename F>
+double timeit(F f,int reps)
+{
+	double best=1e300;
+	for(int r=0;r<reps;r++)
+	{
+		std::chrono::steady_clock::time_point start=std::chrono::steady_clock::now();
+		f();
+		std::chrono::duration<double,std::milli> t=std::chrono::steady_clock::now()-start;
+		best=std::min(best,t.count());
+	}
+	return best;
+}
+
+//Reads every column from top to bottom through operator()
+template<typename M>
+double columnsweep(M& m)
+{
+	double total=0;
+	for(int j=0;j<m.order;j++)
+	{
+		for(int i=0;i<m.order;i++)
+		{
+			total+=m(i,j);
+		}
+	}
+	return total;
+}
+
+int main(int argc,char** argv)
+{
+	int n= argc>1 ? std::atoi(argv[1]) : 2000;
+	int reps= argc>2 ? std::atoi(argv[2]) : 5;
+
+	SymMat<double> S(n);
+	for(size_t k=0;k<S.mat.size();k++)
+	{
+		S.mat[k]=double(k%17)/17.0-0.5;
+	}
+	Eigen::VectorXd x=Eigen::VectorXd::Random(n),y(n);
+	volatile double sink=0;
+
+	SymMatBlocked<double,64> B;
+	SymMatRFP<double> R;
+	double tb=timeit([&]{ B=toBlocked<64>(S); },reps);
+	double tr=timeit([&]{ R=toRFP(S); },reps);
+
+	std::cout<<"order "<<n<<", best of "<<reps<<" runs(ms)"<<std::endl;
+	std::cout<<std::setw(10)<<"layout"<<std::setw(12)<<"spmv"<<std::setw(14)<<"column sweep"<<std::setw(12)<<"convert"<<std::endl;
+
+	std::cout<<std::setw(10)<<"packed"
+			 <<std::setw(12)<<timeit([&]{ spmv(1.0,S,x.data(),0.0,y.data()); },reps)
+			 <<std::setw(14)<<timeit([&]{ sink=sink+columnsweep(S); },reps)
+			 <<std::setw(12)<<"-"<<std::endl;
+
+	std::cout<<std::setw(10)<<"blocked"
+			 <<std::setw(12)<<timeit([&]{ spmv(1.0,B,x.data(),0.0,y.data()); },reps)
+			 <<std::setw(14)<<timeit([&]{ sink=sink+columnsweep(B); },reps)
+			 <<std::setw(12)<<tb<<std::endl;
+
+	std::cout<<std::setw(10)<<"rfp"
+			 <<std::setw(12)<<timeit([&]{ spmv(1.0,R,x.data(),0.0,y.data()); },reps)
+			 <<std::setw(14)<<timeit([&]{ sink=sink+columnsweep(R); },reps)
+			 <<std::setw(12)<<tr<<std::endl;
+
+	return 0;
+}
@@ -0,0 +1,295 @@
+/**********************************************************************************************
+		THIS FILE IS THE BENCHMARK SUITE OF SymMat AGAINST EIGEN
+
+Every operation of SymMat is timed for float and double at several orders, next to the same
+operation on an Eigen dense matrix(impl "dense") and, where Eigen has one, on its
+selfadjointView<Upper>(impl "selfadjoint"). Usage:-
+
+	./benchsuite [--json] [order ...]			(default orders 64 256 1024)
+
+One line(CSV, or one JSON object per line with --json) is written per operation:-
+
+	scalar,order,op,impl,ns_per_op,gflops,gbps,peak_rss_kb
+
+ns_per_op is the time of one call(for operator() and index() one element, they are timed over
+a sweep of the whole matrix). gflops and gbps come from the no. of floating point operations
+and bytes which the operation has to do/move at least, so the packed and the dense versions
+are compared on the same work. peak_rss_kb is the peak memory of the process so far.
+Each time is the best of SAMPLES runs, each run repeating the call for at least MIN_MS.
+************************************************************************************************/
+
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <sys/resource.h>
+#include <Eigen/Eigen>
+#include "SymMat.h"
+#include "SymMatCovariance.h"
+
+#define SAMPLES 3
+#define MIN_MS 20.0
+
+static bool json=false;
+static volatile double sink=0;
+
+//Makes the compiler keep the result of the operation
+template<typename T>
+void keep(const T& value)
+{
+	asm volatile("" : : "g"(&value) : "memory");
+}
+
+//Peak resident memory of the process in kB
+long peakRss()
+{
+	struct rusage usage;
+	getrusage(RUSAGE_SELF,&usage);
+	return long(usage.ru_maxrss);
+}
+
+//Best time of one call of f in nanoseconds
+template<typename F>
+double timeit(F f)
+{
+	typedef std::chrono::steady_clock Clock;
+	f();		//warm up(first touch of the memory, caches)
+	long calls=1;
+	double best=1e300;
+	for(int s=0;s<SAMPLES;)
+	{
+		Clock::time_point start=Clock::now();
+		for(long c=0;c<calls;c++)
+		{
+			f();
+		}
+		const double ms=std::chrono::duration<double,std::milli>(Clock::now()-start).count();
+		if(ms<MIN_MS && calls<(1L<<30))
+		{
+			calls*=2;
+			continue;
+		}
+		best=std::min(best,1e6*ms/calls);
+		s++;
+	}
+	return best;
+}
+
+//Writes one result, items is the no. of elements a sweep touches(1 for the other operations)
+void report(const char* scalar,int n,const char* op,const char* impl,double ns,double items,double flops,double bytes)
+{
+	const double t=ns/items;
+	const double gflops= flops>0 ? flops/ns : 0;
+	const double gbps= bytes>0 ? bytes/ns : 0;
+	std::ostringstream line;
+	line<<std::setprecision(6);
+	if(json)
+	{
+		line<<"{\"scalar\":\""<<scalar<<"\",\"order\":"<<n<<",\"op\":\""<<op<<"\",\"impl\":\""<<impl
+			<<"\",\"ns_per_op\":"<<t<<",\"gflops\":"<<gflops<<",\"gbps\":"<<gbps<<",\"peak_rss_kb\":"<<peakRss()<<"}";
+	}
+	else
+	{
+		line<<scalar<<","<<n<<","<<op<<","<<impl<<","<<t<<","<<gflops<<","<<gbps<<","<<peakRss();
+	}
+	std::cout<<line.str()<<std::endl;
+}
+
+template<typename _Scalar>
+void run(const char* scalar,int n)
+{
+	typedef Eigen::Matrix<_Scalar,Eigen::Dynamic,Eigen::Dynamic> Matrix;
+	typedef Eigen::Matrix<_Scalar,Eigen::Dynamic,1> Vector;
+
+	const double sz=sizeof(_Scalar);
+	const double nn=double(n)*n;
+	const double packed=double(SymMatInternal::packedElements<_Scalar>(n));
+
+	//Symmetric test matrices with values near one(so that prod() stays finite), and dense copies
+	SymMat<_Scalar> S(n),S2(n);
+	for(Eigen::Index k=0;k<S.elemstored();k++)
+	{
+		S.mat[k]=_Scalar(1)+_Scalar(k%13)*_Scalar(1e-4);
+		S2.mat[k]=_Scalar(1)-_Scalar(k%7)*_Scalar(1e-4);
+	}
+	Matrix D=S.dense(),D2=S2.dense();
+	Matrix M=Matrix::Random(n,n);
+	Vector x=Vector::Random(n),y(n);
+
+	//Positive definite matrix for the factorizations
+	SymMat<_Scalar> P(n);
+	for(int i=0;i<n;i++)
+	{
+		for(int j=i;j<n;j++)
+		{
+			P(i,j)= i==j ? _Scalar(n) : _Scalar(((i*7+j*3)%11))/_Scalar(11);
+		}
+	}
+	Matrix DP=P.dense();
+
+	//Construction and element access------------------------------------------------------------
+	report(scalar,n,"construct","symmat",timeit([&]{ SymMat<_Scalar> A(n); keep(A.mat[0]); }),1,0,packed*sz);
+	report(scalar,n,"construct","dense",timeit([&]{ Matrix A=Matrix::Zero(n,n); keep(A(0,0)); }),1,0,nn*sz);
+
+	report(scalar,n,"operator()","symmat",timeit([&]{
+		_Scalar t=0;
+		for(int i=0;i<n;i++) for(int j=0;j<n;j++) t+=S(i,j);
+		sink=sink+t; }),nn,nn,nn*sz);
+	report(scalar,n,"operator()","dense",timeit([&]{
+		_Scalar t=0;
+		for(int i=0;i<n;i++) for(int j=0;j<n;j++) t+=D(i,j);
+		sink=sink+t; }),nn,nn,nn*sz);
+	report(scalar,n,"index()","symmat",timeit([&]{
+		Eigen::Index t=0;
+		for(int i=0;i<n;i++) for(int j=0;j<n;j++) t+=S.index(i,j);
+		sink=sink+double(t); }),nn,0,0);
+
+	//Reductions(the dense matrix has to read all the n*n elements)-----------------------------
+	report(scalar,n,"sum","symmat",timeit([&]{ sink=sink+S.sum(); }),1,packed,packed*sz);
+	report(scalar,n,"sum","dense",timeit([&]{ sink=sink+D.sum(); }),1,packed,nn*sz);
+	report(scalar,n,"mean","symmat",timeit([&]{ sink=sink+S.mean(); }),1,packed,packed*sz);
+	report(scalar,n,"mean","dense",timeit([&]{ sink=sink+D.mean(); }),1,packed,nn*sz);
+	report(scalar,n,"packedSum","symmat",timeit([&]{ sink=sink+S.packedSum(); }),1,packed,packed*sz);
+	report(scalar,n,"packedProd","symmat",timeit([&]{ sink=sink+S.packedProd(); }),1,packed,packed*sz);
+	report(scalar,n,"packedMean","symmat",timeit([&]{ sink=sink+S.packedMean(); }),1,packed,packed*sz);
+	report(scalar,n,"prod","symmat",timeit([&]{ sink=sink+S.prod(); }),1,packed,packed*sz);
+	report(scalar,n,"prod","dense",timeit([&]{ sink=sink+D.prod(); }),1,packed,nn*sz);
+	report(scalar,n,"trace","symmat",timeit([&]{ sink=sink+S.trace(); }),1,n,n*sz);
+	report(scalar,n,"trace","dense",timeit([&]{ sink=sink+D.trace(); }),1,n,n*sz);
+	report(scalar,n,"diagprod","symmat",timeit([&]{ sink=sink+S.diagprod(); }),1,n,n*sz);
+	report(scalar,n,"diagprod","dense",timeit([&]{ sink=sink+D.diagonal().prod(); }),1,n,n*sz);
+	report(scalar,n,"minCoeff","symmat",timeit([&]{ sink=sink+S.minCoeff(); }),1,packed,packed*sz);
+	report(scalar,n,"minCoeff","dense",timeit([&]{ sink=sink+D.minCoeff(); }),1,packed,nn*sz);
+	report(scalar,n,"maxCoeff","symmat",timeit([&]{ sink=sink+S.maxCoeff(); }),1,packed,packed*sz);
+	report(scalar,n,"maxCoeff","dense",timeit([&]{ sink=sink+D.maxCoeff(); }),1,packed,nn*sz);
+
+	//Addition and subtraction-------------------------------------------------------------------
+	SymMat<_Scalar> C(n);
+	Matrix R(n,n);
+	report(scalar,n,"add(S,S)","symmat",timeit([&]{ C=add(S,S2); keep(C.mat[0]); }),1,packed,3*packed*sz);
+	report(scalar,n,"add(S,S)","dense",timeit([&]{ R.noalias()=D+D2; keep(R(0,0)); }),1,packed,3*nn*sz);
+	report(scalar,n,"sub(S,S)","symmat",timeit([&]{ C=sub(S,S2); keep(C.mat[0]); }),1,packed,3*packed*sz);
+	report(scalar,n,"sub(S,S)","dense",timeit([&]{ R.noalias()=D-D2; keep(R(0,0)); }),1,packed,3*nn*sz);
+	report(scalar,n,"add(S,M)","symmat",timeit([&]{ R=add(S,M); keep(R(0,0)); }),1,nn,(packed+2*nn)*sz);
+	report(scalar,n,"add(M,S)","symmat",timeit([&]{ R=add(M,S); keep(R(0,0)); }),1,nn,(packed+2*nn)*sz);
+	report(scalar,n,"add(S,M)","dense",timeit([&]{ R.noalias()=D+M; keep(R(0,0)); }),1,nn,(packed+2*nn)*sz);
+	report(scalar,n,"sub(S,M)","symmat",timeit([&]{ R=sub(S,M); keep(R(0,0)); }),1,nn,(packed+2*nn)*sz);
+	report(scalar,n,"sub(M,S)","symmat",timeit([&]{ R=sub(M,S); keep(R(0,0)); }),1,nn,(packed+2*nn)*sz);
+	report(scalar,n,"sub(S,M)","dense",timeit([&]{ R.noalias()=D-M; keep(R(0,0)); }),1,nn,(packed+2*nn)*sz);
+
+	//Conversions with Eigen matrices(copies of the upper or lower triangle, and the dense matrix)----
+	report(scalar,n,"fromDense","symmat",timeit([&]{ SymMat<_Scalar> A(D); keep(A.mat[0]); }),1,0,(nn+packed)*sz);
+	report(scalar,n,"fromLower","symmat",timeit([&]{ SymMat<_Scalar> A(D.template selfadjointView<Eigen::Lower>()); keep(A.mat[0]); }),1,0,(nn+packed)*sz);
+	report(scalar,n,"toDense","symmat",timeit([&]{ R=S.dense(); keep(R(0,0)); }),1,0,(packed+nn)*sz);
+	report(scalar,n,"toDense","dense",timeit([&]{ R=D2; keep(R(0,0)); }),1,0,2*nn*sz);
+
+	//Multiplication-----------------------------------------------------------------------------
+	const double mflops=2*nn*n;
+	report(scalar,n,"mult(S,S)","symmat",timeit([&]{ R=mult<_Scalar,Eigen::Dynamic,Eigen::Dynamic>(S,S2); keep(R(0,0)); }),1,mflops,(2*packed+nn)*sz);
+	report(scalar,n,"mult(S,S)","dense",timeit([&]{ R.noalias()=D*D2; keep(R(0,0)); }),1,mflops,3*nn*sz);
+	report(scalar,n,"mult(S,S)","selfadjoint",timeit([&]{ R.noalias()=D.template selfadjointView<Eigen::Upper>()*D2; keep(R(0,0)); }),1,mflops,3*nn*sz);
+	report(scalar,n,"mult(S,M)","symmat",timeit([&]{ R=mult(S,M); keep(R(0,0)); }),1,mflops,(packed+2*nn)*sz);
+	report(scalar,n,"mult(S,M)","dense",timeit([&]{ R.noalias()=D*M; keep(R(0,0)); }),1,mflops,3*nn*sz);
+	report(scalar,n,"mult(S,M)","selfadjoint",timeit([&]{ R.noalias()=D.template selfadjointView<Eigen::Upper>()*M; keep(R(0,0)); }),1,mflops,3*nn*sz);
+	report(scalar,n,"mult(M,S)","symmat",timeit([&]{ R=mult(M,S); keep(R(0,0)); }),1,mflops,(packed+2*nn)*sz);
+	report(scalar,n,"mult(M,S)","dense",timeit([&]{ R.noalias()=M*D; keep(R(0,0)); }),1,mflops,3*nn*sz);
+	report(scalar,n,"mult(M,S)","selfadjoint",timeit([&]{ R.noalias()=M*D.template selfadjointView<Eigen::Upper>(); keep(R(0,0)); }),1,mflops,3*nn*sz);
+
+	//Kernels------------------------------------------------------------------------------------
+	report(scalar,n,"spmv","symmat",timeit([&]{ spmv(_Scalar(1),S,x,_Scalar(0),y); keep(y(0)); }),1,2*nn,packed*sz);
+	report(scalar,n,"spmv","dense",timeit([&]{ y.noalias()=D*x; keep(y(0)); }),1,2*nn,nn*sz);
+	report(scalar,n,"spmv","selfadjoint",timeit([&]{ y.noalias()=D.template selfadjointView<Eigen::Upper>()*x; keep(y(0)); }),1,2*nn,packed*sz);
+
+	const int k=64;
+	const Matrix A=Matrix::Random(n,k);
+	Matrix RA(n,n);
+	report(scalar,n,"syrk","symmat",timeit([&]{ syrk(_Scalar(1),A,_Scalar(0),C); keep(C.mat[0]); }),1,packed*2*k,(packed+n*k)*sz);
+	report(scalar,n,"syrk","dense",timeit([&]{ RA.noalias()=A*A.transpose(); keep(RA(0,0)); }),1,packed*2*k,(nn+n*k)*sz);
+	report(scalar,n,"syrk","selfadjoint",timeit([&]{ RA.template selfadjointView<Eigen::Upper>().rankUpdate(A,_Scalar(1)); keep(RA(0,0)); }),1,packed*2*k,(packed+n*k)*sz);
+
+	//Distances between the rows of A(the dense version is the same |x|^2 + |y|^2 - 2*x.y on the whole matrix)
+	{
+		Vector sq=A.rowwise().squaredNorm();
+		report(scalar,n,"pairwise","symmat",timeit([&]{ pairwise(A,SymMatEuclidean,C); keep(C.mat[0]); }),1,packed*2*k,(packed+n*k)*sz);
+		report(scalar,n,"pairwise","dense",timeit([&]{ RA.noalias()=A*A.transpose(); RA=((-2*RA).colwise()+sq).rowwise()+sq.transpose(); RA=RA.cwiseMax(_Scalar(0)).cwiseSqrt(); keep(RA(0,0)); }),1,packed*2*k,(nn+n*k)*sz);
+	}
+
+	//Rank-1 update(the factor is updated in O(n^2), against the factorization in O(n^3) below)
+	report(scalar,n,"spr","symmat",timeit([&]{ spr(_Scalar(1e-6),x,C); keep(C.mat[0]); }),1,packed*2,2*packed*sz);
+	report(scalar,n,"spr","dense",timeit([&]{ RA.noalias()+=_Scalar(1e-6)*x*x.transpose(); keep(RA(0,0)); }),1,packed*2,2*nn*sz);
+	report(scalar,n,"spr","selfadjoint",timeit([&]{ RA.template selfadjointView<Eigen::Upper>().rankUpdate(x,_Scalar(1e-6)); keep(RA(0,0)); }),1,packed*2,2*packed*sz);
+
+	//A^T*S*A with a square A(the dense version is the two products)
+	const double gflops=3*nn*n;
+	report(scalar,n,"congruence","symmat",timeit([&]{ congruence(_Scalar(1),S,M,_Scalar(0),C); keep(C.mat[0]); }),1,gflops,(2*packed+nn)*sz);
+	report(scalar,n,"congruence","dense",timeit([&]{ RA.noalias()=D*M; R.noalias()=M.transpose()*RA; keep(R(0,0)); }),1,gflops,4*nn*sz);
+	report(scalar,n,"congruence","selfadjoint",timeit([&]{ RA.noalias()=D.template selfadjointView<Eigen::Upper>()*M; R.noalias()=M.transpose()*RA; keep(R(0,0)); }),1,gflops,4*nn*sz);
+
+	//The copy of the matrix is part of each factorization(the factorizations overwrite it)
+	const double cflops=nn*n/3;
+	report(scalar,n,"cholesky","symmat",timeit([&]{ C=P; cholesky(C); keep(C.mat[0]); }),1,cflops,packed*sz);
+	report(scalar,n,"cholesky","dense",timeit([&]{ Eigen::LLT<Matrix> llt(DP); keep(llt.matrixLLT()(0,0)); }),1,cflops,nn*sz);
+	report(scalar,n,"cholesky","selfadjoint",timeit([&]{ Eigen::LLT<Matrix,Eigen::Upper> llt(DP); keep(llt.matrixLLT()(0,0)); }),1,cflops,packed*sz);
+
+	//Update of the factor by a small x(against Eigen's LLT::rankUpdate of the same factor)
+	{
+		const Vector xs=x*_Scalar(1e-3);
+		SymMat<_Scalar> U=P;
+		cholesky(U);
+		Eigen::LLT<Matrix> llt(DP);
+		report(scalar,n,"cholupdate","symmat",timeit([&]{ cholupdate(U,xs); keep(U.mat[0]); }),1,4*packed,2*packed*sz);
+		report(scalar,n,"cholupdate","dense",timeit([&]{ llt.rankUpdate(xs); keep(llt.matrixLLT()(0,0)); }),1,4*packed,2*nn*sz);
+	}
+
+	//Covariance of the n rows of M added as one batch(the dense version centers the rows and multiplies)
+	{
+		SymMatCovariance<_Scalar> acc(n);
+		report(scalar,n,"covariance","symmat",timeit([&]{ acc.reset(); acc.add(M); keep(acc.partials[0].scatter.mat[0]); }),1,nn*n,(nn+packed)*sz);
+		report(scalar,n,"covariance","dense",timeit([&]{ Vector mu=M.colwise().mean().transpose(); RA.noalias()=(M.rowwise()-mu.transpose()).transpose()*(M.rowwise()-mu.transpose()); keep(RA(0,0)); }),1,nn*n,2*nn*sz);
+	}
+
+	if(n<=1024)
+	{
+		const double eflops=4*nn*n/3;
+		Vector values;
+		report(scalar,n,"eigenvalues","symmat",timeit([&]{ eigenvalues(S,values); keep(values(0)); }),1,eflops,packed*sz);
+		report(scalar,n,"eigenvalues","dense",timeit([&]{ Eigen::SelfAdjointEigenSolver<Matrix> es(D,Eigen::EigenvaluesOnly); keep(es.eigenvalues()(0)); }),1,eflops,nn*sz);
+	}
+}
+
+int main(int argc,char** argv)
+{
+	std::vector<int> orders;
+	for(int a=1;a<argc;a++)
+	{
+		if(std::strcmp(argv[a],"--json")==0)
+		{
+			json=true;
+		}
+		else
+		{
+			orders.push_back(std::atoi(argv[a]));
+		}
+	}
+	if(orders.empty())
+	{
+		orders.push_back(64);
+		orders.push_back(256);
+		orders.push_back(1024);
+	}
+
+	if(!json)
+	{
+		std::cout<<"scalar,order,op,impl,ns_per_op,gflops,gbps,peak_rss_kb"<<std::endl;
+	}
+	for(size_t o=0;o<orders.size();o++)
+	{
+		run<float>("float",orders[o]);
+		run<double>("double",orders[o]);
+	}
+	return 0;
+}
@@ -4,8 +4,16 @@
 
 #include <iostream>
 #include <iomanip>
+#include <cstdio>
 #include <Eigen/Eigen>
 #include "SymMat.h"
+#include "SymMatIO.h"
+#include "SymMatMapped.h"
+#include "SymMatBatch.h"
+#include "SymMatSparse.h"
+#include "SymMatHalf.h"
+#include "SymMatQuant.h"
+#include "SymMatCovariance.h"
 
 int main()
 {
@@ -25,10 +33,8 @@ int main()
 		std::cout<<std::endl;
 	}
 
-	//Creating a symmetric matrix from the elements of Eigen::Matrix
-	SymMat<float> S={M(0,0), M(0,1), M(0,2),
-					   		  M(1,1), M(1,2),
-					  				  M(2,2)};
+	//Creating a symmetric matrix from the upper triangle of Eigen::Matrix
+	SymMat<float> S(M);
 
 	std::cout<<"\nThis is the Symmetric matrix created from the Eigen matrix:"<<std::endl;
 	for(int i=0;i<3;i++)
@@ -69,6 +75,7 @@ int main()
 	std::cout<<"Element at (0,1) is: "<<S1(0,1)<<std::endl;
 	std::cout<<"Trace of the matrix is:"<<S1.trace()<<std::endl;
 	std::cout<<"Sum of all elements:"<<S1.sum()<<std::endl;
+	std::cout<<"Sum of the stored elements:"<<S1.packedSum()<<std::endl;
 	std::cout<<"Mean of all elements:"<<S1.mean()<<std::endl;
 	std::cout<<"Products of all elements:"<<S1.prod()<<std::endl;
 	std::cout<<"Products of diagonal elements:"<<S1.diagprod()<<std::endl;
@@ -80,6 +87,9 @@ int main()
 	S2=add(S1,S);
 	SymMat<float> S3(3);
 	S3=sub(S1,S);
+	//Chained expressions are computed in a single pass when they are assigned
+	SymMat<float> S5(3);
+	S5=2.0f*S1+S2-S3;
 	Eigen::Matrix<float,3,3> M1;
 	M1=mult<float,3,3> (S1,S);
 	
@@ -91,6 +101,9 @@ int main()
 	std::cout<<"\nThe Difference of the matrices is:"<<std::endl;
 	S3.print();
 
+	std::cout<<"\n2*S1 + Sum - Difference is:"<<std::endl;
+	S5.print();
+
 	std::cout<<"\nThe Multiplication of matrices is:"<<std::endl;
 	for(int i=0;i<3;i++)
 	{
@@ -168,6 +181,386 @@ int main()
 
 
 
+/************************************************************************
+		MATRICES TAKING THEIR MEMORY FROM A POOL
+*************************************************************************/
+	SymMatPool pool;
+	{
+		//Every matrix created in this block(and the results of the expressions) uses the pool
+		SymMatScope scope(&pool);
+		SymMat<float> P1(3);
+		P1=S1+S1;
+		SymMat<float> P2=P1-S1;
+		std::cout<<"Sum of S1+S1-S1 computed with matrices from the pool: "<<P2.sum()<<std::endl;
+	}
+	std::cout<<std::endl;
+
+
+/************************************************************************
+		SYMMETRIC MATRIX OF FIXED ORDER(NO HEAP ALLOCATION)
+*************************************************************************/
+	SymMat<float,3> F1={1, 4.3, 2,
+						   56,  9,
+								6};
+	SymMat<float,3> F2=2.0f*F1-F1;
+	std::cout<<"Trace of the fixed order matrix is: "<<F2.trace()<<std::endl;
+	std::cout<<"Sum of its elements is: "<<F2.sum()<<std::endl;
+	std::cout<<"Fixed order matrix * Eigen matrix is:"<<std::endl<<mult(F2,M)<<std::endl;
+	//The unrolled loops of a larger order(1024 products in mult)
+	Eigen::Matrix<double,32,32> D32=Eigen::Matrix<double,32,32>::Random();
+	D32=(D32+D32.transpose()).eval();
+	SymMat<double,32> F32;
+	for(int i=0;i<32;i++)
+	{
+		for(int j=i;j<32;j++)
+		{
+			F32(i,j)=D32(i,j);
+		}
+	}
+	std::cout<<"Order 32, largest error of the fixed order mult: "<<(mult(F32,D32)-D32*D32).cwiseAbs().maxCoeff()<<std::endl;
+	std::cout<<std::endl;
+
+
+/************************************************************************
+		BATCH OF SMALL SYMMETRIC MATRICES(STRUCTURE OF ARRAYS)
+*************************************************************************/
+	SymMatBatch<float,3> batch(2);
+	batch.set(0,F1);
+	batch.set(1,F2);
+	SymMatBatch<float,3>::Vectors batchvalues;
+	eigenvalues(batch,batchvalues);
+	std::cout<<"Determinants of the batch: "<<determinant(batch).transpose()<<std::endl;
+	std::cout<<"Eigenvalues of the batch(one matrix per row):"<<std::endl<<batchvalues<<std::endl;
+	std::cout<<std::endl;
+
+
+/************************************************************************
+		LARGE ORDER(SPLIT BETWEEN THE THREADS WITH OPENMP)
+*************************************************************************/
+	//Above SYMMAT_PARALLEL_THRESHOLD the kernels use all the threads(make testcases_omp.o)
+	const int big=SYMMAT_PARALLEL_THRESHOLD+88;
+	Eigen::MatrixXd Dbig=Eigen::MatrixXd::Random(big,big);
+	Dbig=(Dbig+Dbig.transpose()).eval();
+	SymMat<double> Sbig(Dbig.selfadjointView<Eigen::Upper>());
+	Eigen::VectorXd xbig=Eigen::VectorXd::Random(big),ybig;
+	spmv(1.0,Sbig,xbig,0.0,ybig);
+	std::cout<<"Order "<<big<<", largest error of spmv: "<<(ybig-Dbig*xbig).cwiseAbs().maxCoeff()<<std::endl;
+	spr(0.5,xbig,Sbig);
+	std::cout<<"Order "<<big<<", largest error of spr: "<<(Sbig.dense()-Dbig-0.5*xbig*xbig.transpose()).cwiseAbs().maxCoeff()<<std::endl;
+	//The partials of the threads are merged with spr of the same order
+	SymMatCovariance<double> Accbig(big);
+	Accbig.add(Dbig);
+	Eigen::MatrixXd Cbig=Dbig.rowwise()-Dbig.colwise().mean();
+	std::cout<<"Order "<<big<<", largest error of the covariance: "
+			 <<(Accbig.covariance().dense()-Cbig.transpose()*Cbig/double(big-1)).cwiseAbs().maxCoeff()<<std::endl;
+	//Every element is stored, so the rows are split by nonzeros as well
+	SymMatSparse<double> Pbig=toSparse(Sbig);
+	spmv(1.0,Pbig,xbig,0.0,ybig);
+	std::cout<<"Order "<<big<<", largest error of the sparse spmv: "<<(ybig-Sbig.dense()*xbig).cwiseAbs().maxCoeff()<<std::endl;
+	std::cout<<std::endl;
+
+
+/************************************************************************
+		SPARSE SYMMETRIC MATRIX(LOWER TRIANGLE IN CSR FORMAT)
+*************************************************************************/
+	//Path graph Laplacian assembled edge by edge, the diagonal contributions are added
+	std::vector< SymMatSparse<float>::Triplet > edges;
+	for(int i=0;i+1<6;i++)
+	{
+		edges.push_back(SymMatSparse<float>::Triplet(i,i,1));
+		edges.push_back(SymMatSparse<float>::Triplet(i+1,i+1,1));
+		edges.push_back(SymMatSparse<float>::Triplet(i,i+1,-1));
+	}
+	SymMatSparse<float> G(6);
+	G.setFromTriplets(edges.begin(),edges.end());
+	Eigen::VectorXf ones=Eigen::VectorXf::Ones(6),lx;
+	spmv(1.0f,G,ones,0.0f,lx);
+	std::cout<<"Stored elements of the sparse Laplacian: "<<G.nonZeros()<<std::endl;
+	std::cout<<"Laplacian * ones is: "<<lx.transpose()<<std::endl;
+	std::cout<<"As a packed matrix:"<<std::endl;
+	toPacked(G).print();
+	std::cout<<std::endl;
+
+
+/************************************************************************
+		CONVERSIONS WITH EIGEN(NO COPY WITH Map AND SymMatRef)
+*************************************************************************/
+	//The lower triangle of M, the dense matrix, and a view of a packed vector owned by the caller
+	SymMat<float> FromLower(M.selfadjointView<Eigen::Lower>());
+	Eigen::MatrixXf LowerDense=FromLower.dense();
+	std::vector<float> owned(FromLower.mat.begin(),FromLower.mat.end());
+	SymMatRef<float> View(owned.data(),3);
+	View=2.0f*FromLower;
+	std::cout<<"Matrix from the lower triangle of the Eigen matrix:"<<std::endl<<LowerDense<<std::endl;
+	std::cout<<"Packed vector seen as an Eigen vector: "<<FromLower.packed().transpose()<<std::endl;
+	std::cout<<"Buffer after writing 2*FromLower into its view: ";
+	for(size_t k=0;k<owned.size();k++)
+	{
+		std::cout<<owned[k]<<" ";
+	}
+	std::cout<<std::endl<<std::endl;
+
+
+/************************************************************************
+		IN PLACE ARITHMETIC(COMPOUND OPERATORS AND DESTINATIONS)
+*************************************************************************/
+	//An update loop which reuses the storage of A, of the temporary and of the destination D
+	SymMat<float> A=S1;
+	Eigen::Matrix<float,3,3> D;
+	for(int it=0;it<3;it++)
+	{
+		A*=0.5f;
+		A+=S;
+		A=std::move(A)-0.25f*S1;
+		add(A,M,D);
+	}
+	std::cout<<"A after the update loop:"<<std::endl;
+	A.print();
+	std::cout<<"A+M written into D:"<<std::endl<<D<<std::endl;
+	std::cout<<"M-A reusing a temporary:"<<std::endl<<sub(Eigen::Matrix<float,3,3>(M),A)<<std::endl<<std::endl;
+
+
+/************************************************************************
+		CONGRUENCE TRANSFORM(B^T*S1*B, SYMMETRIC RESULT)
+*************************************************************************/
+	Eigen::Matrix<float,3,2> B;
+	B<<1,0,
+	   2,1,
+	   0,3;
+	SymMat<float> Cong=congruence(S1,B);
+	std::cout<<"B^T*S1*B computed into a packed matrix of order 2:"<<std::endl;
+	Cong.print();
+	std::cout<<"The same with dense products:"<<std::endl<<B.transpose()*S1.dense()*B<<std::endl<<std::endl;
+
+
+/************************************************************************
+		PAIRWISE DISTANCES AND GAUSSIAN KERNEL OF A SET OF POINTS
+*************************************************************************/
+	Eigen::Matrix<float,4,2> Pts;
+	Pts<<0,0,
+		 3,4,
+		 1,0,
+		 0,2;
+	SymMat<float> Dist=pairwise(Pts,SymMatEuclidean);
+	std::cout<<"Distances between the rows of Pts:"<<std::endl;
+	Dist.print();
+	SymMat<float> Kern=pairwise(Pts,SymMatRbf,0.5f);
+	std::cout<<"Gaussian kernel exp(-0.5*|x-y|^2) of the rows of Pts:"<<std::endl;
+	Kern.print();
+	std::cout<<std::endl;
+
+
+/************************************************************************
+		16 BIT STORAGE(IEEE HALF AND BFLOAT16), COMPUTED IN FLOAT
+*************************************************************************/
+	//Each stored element is off by at most u times its magnitude, so is every row of spmv
+	SymMat<float> Hs(200);
+	for(Eigen::Index k=0;k<Hs.elemstored();k++)
+	{
+		Hs.mat[k]=float((k*37)%101)/101.0f-0.25f;
+	}
+	SymMatHalf<SymMatFp16> Fh=Hs;
+	SymMatHalf<SymMatBf16> Fb=Hs;
+	Eigen::VectorXf hx=Eigen::VectorXf::Random(200),fy,hy,by;
+	spmv(1.0f,Hs,hx,0.0f,fy);
+	spmv(1.0f,Fh,hx,0.0f,hy);
+	spmv(1.0f,Fb,hx,0.0f,by);
+	Eigen::VectorXf rowbound=Eigen::VectorXf::Zero(200);
+	float elemfp16=0,elembf16=0;
+	for(int i=0;i<200;i++)
+	{
+		for(int j=0;j<200;j++)
+		{
+			rowbound(i)+=std::abs(Hs(i,j)*hx(j));
+			elemfp16=std::max(elemfp16,std::abs(Fh(i,j)-Hs(i,j))/std::abs(Hs(i,j)));
+			elembf16=std::max(elembf16,std::abs(Fb(i,j)-Hs(i,j))/std::abs(Hs(i,j)));
+		}
+	}
+	const float ufp16=std::ldexp(1.0f,-11),ubf16=std::ldexp(1.0f,-8),ufloat=200*std::numeric_limits<float>::epsilon();
+	bool halfok=elemfp16<=ufp16 && elembf16<=ubf16;
+	for(int i=0;i<200;i++)
+	{
+		halfok=halfok && std::abs(hy(i)-fy(i))<=(ufp16+ufloat)*rowbound(i)
+					  && std::abs(by(i)-fy(i))<=(ubf16+ufloat)*rowbound(i);
+	}
+	std::cout<<"Bytes of the packed vector(float, fp16, bf16): "<<Hs.elemstored()*sizeof(float)<<" "
+			 <<Fh.elemstored()*sizeof(SymMatFp16)<<" "<<Fb.elemstored()*sizeof(SymMatBf16)<<std::endl;
+	std::cout<<"Largest relative error of an element(fp16, bf16): "<<elemfp16<<" "<<elembf16<<std::endl;
+	std::cout<<"Sum(float, fp16, bf16): "<<Hs.sum()<<" "<<Fh.sum()<<" "<<Fb.sum()<<std::endl;
+	std::cout<<"Stored and spmv errors within the bounds: "<<(halfok ? "yes" : "no")<<std::endl;
+	std::cout<<std::endl;
+
+
+/************************************************************************
+		QUANTIZED STORAGE(INT8 WITH A SCALE AND ZERO-POINT PER BLOCK)
+*************************************************************************/
+	//Similarity matrix of points on a line, each element is within half a level of the float value
+	SymMat<float> K(300);
+	for(int i=0;i<300;i++)
+	{
+		for(int j=i;j<300;j++)
+		{
+			K(i,j)=std::exp(-std::abs(i-j)/30.0f);
+		}
+	}
+	SymMatQuant<int8_t> Kq=K;
+	bool quantok=true;
+	for(Eigen::Index k=0;k<K.elemstored();k++)
+	{
+		const SymMatQuantBlock& block=Kq.blocks[k/SYMMAT_QUANT_BLOCK];
+		quantok=quantok && std::abs(Kq.coeff(k)-K.mat[k])<=0.5f*block.scale*(1+1e-3f);
+	}
+	Eigen::VectorXf kx=Eigen::VectorXf::Ones(300),ky,kqy;
+	spmv(1.0f,K,kx,0.0f,ky);
+	spmv(1.0f,Kq,kx,0.0f,kqy);
+	Eigen::VectorXi nearest;
+	Eigen::VectorXf similarity;
+	Kq.topk(100,4,nearest,similarity);
+	std::cout<<"Bytes of the packed vector(float, int8 with the scales): "<<K.elemstored()*sizeof(float)<<" "
+			 <<Kq.elemstored()*sizeof(int8_t)+Kq.blocks.size()*sizeof(SymMatQuantBlock)<<std::endl;
+	std::cout<<"Sum(float, int8): "<<K.sum()<<" "<<Kq.sum()<<std::endl;
+	std::cout<<"Largest error of a row sum: "<<(ky-kqy).cwiseAbs().maxCoeff()<<std::endl;
+	std::cout<<"Nearest points to point 100: "<<nearest.transpose()<<std::endl;
+	std::cout<<"Quantized elements within half a level: "<<(quantok ? "yes" : "no")<<std::endl;
+
+	//Blocks of equal values(a single level) and blocks shorter than a vector register
+	SymMat<float> Zq2(2),Zq(7),Cq(23);
+	std::fill(Cq.mat.begin(),Cq.mat.end(),2.5f);
+	SymMatQuant<int8_t> Zq8=Zq,Cq8=Cq,Zq28=Zq2;
+	SymMatQuant<int16_t> Zq16=Zq,Cq16=Cq,Zq216=Zq2;
+	std::cout<<"Min and max of the zero matrix of order 2(int8, int16): "<<Zq28.minCoeff()<<" "<<Zq28.maxCoeff()<<", "
+			 <<Zq216.minCoeff()<<" "<<Zq216.maxCoeff()<<std::endl;
+	std::cout<<"Min and max of the zero matrix of order 7(int8, int16): "<<Zq8.minCoeff()<<" "<<Zq8.maxCoeff()<<", "
+			 <<Zq16.minCoeff()<<" "<<Zq16.maxCoeff()<<std::endl;
+	std::cout<<"Min and max of the matrix of 2.5s of order 23(int8, int16): "<<Cq8.minCoeff()<<" "<<Cq8.maxCoeff()<<", "
+			 <<Cq16.minCoeff()<<" "<<Cq16.maxCoeff()<<std::endl;
+	std::cout<<std::endl;
+
+
+/************************************************************************
+		CHOLESKY FACTORIZATION OF A POSITIVE DEFINITE SYMMETRIC MATRIX
+*************************************************************************/
+	SymMat<float> P={4, 2, 2,
+					    5, 3,
+					       6};
+	SymMat<float> U=P;
+	if(cholesky(U)==0)
+	{
+		Eigen::Matrix<float,3,1> b,x;
+		b<<1,2,3;
+		x=b;
+		cholsolve(U,x);
+		std::cout<<"Solution of P*x=b is: "<<x.transpose()<<std::endl;
+		std::cout<<"Log of the determinant of P is: "<<chollogdet(U)<<std::endl;
+		std::cout<<"Inverse of P is:"<<std::endl;
+		SymMat<float> Pinv=cholinverse(U);
+		Pinv.print();
+	}
+	std::cout<<std::endl;
+
+
+/************************************************************************
+		RANK-1 UPDATES OF A MATRIX AND OF ITS CHOLESKY FACTOR
+*************************************************************************/
+	//One observation added to P and to its factor, then removed from the factor again
+	Eigen::Matrix<float,3,1> obs;
+	obs<<1,-1,2;
+	SymMat<float> Pobs=P;
+	spr(1.0f,obs,Pobs);
+	SymMat<float> Uobs=P;
+	cholesky(Uobs);
+	cholupdate(Uobs,obs);
+	Eigen::Matrix<float,3,3> Uup=Uobs.dense().triangularView<Eigen::Upper>();
+	std::cout<<"P + obs*obs^T is:"<<std::endl;
+	Pobs.print();
+	std::cout<<"U^T*U of the updated factor is:"<<std::endl<<Uup.transpose()*Uup<<std::endl;
+	std::cout<<"Downdate of the factor by obs: "<<(choldowndate(Uobs,obs)==0 ? "done" : "not positive definite")<<std::endl;
+	std::cout<<"Log of the determinant of P after the downdate is: "<<chollogdet(Uobs)<<std::endl;
+	std::cout<<std::endl;
+
+
+/************************************************************************
+		EIGENVALUES AND EIGENVECTORS OF A SYMMETRIC MATRIX
+*************************************************************************/
+	Eigen::Matrix<float,Eigen::Dynamic,1> values;
+	Eigen::Matrix<float,Eigen::Dynamic,Eigen::Dynamic> vectors;
+	if(eigenvectors(S1,values,vectors)==0)
+	{
+		std::cout<<"Eigenvalues of S1 are: "<<values.transpose()<<std::endl;
+		std::cout<<"Eigenvectors of S1(columns) are:"<<std::endl<<vectors<<std::endl;
+	}
+	std::cout<<std::endl;
+
+
+/************************************************************************
+		SYMMETRIC MATRIX STORED IN A FILE(MEMORY MAPPED)
+*************************************************************************/
+	SymMatMapped<float> F;
+	if(F.create("testcases_mapped.bin",3))
+	{
+		F=S1+S;
+		std::cout<<"Sum of all elements of the mapped matrix(S1+S) is: "<<F.sum()<<std::endl;
+		std::cout<<"Trace of the mapped matrix is: "<<F.trace()<<std::endl;
+		F.close();
+		std::remove("testcases_mapped.bin");
+	}
+	std::cout<<std::endl;
+
+
+/************************************************************************
+		SAVING AND LOADING A SYMMETRIC MATRIX(BINARY FORMAT)
+*************************************************************************/
+	SymMat<float> L;
+	if(save(S1,"testcases_saved.bin") && load(L,"testcases_saved.bin"))
+	{
+		std::cout<<"Matrix loaded from the file written by save(S1):"<<std::endl;
+		L.print();
+	}
+	//The header alone(the elements cut off) is not loaded
+	char page[SYMMAT_FILE_HEADER];
+	std::FILE* cut=std::fopen("testcases_saved.bin","rb");
+	bool read= cut && std::fread(page,1,sizeof(page),cut)==sizeof(page);
+	if(cut)
+	{
+		std::fclose(cut);
+	}
+	cut= read ? std::fopen("testcases_saved.bin","wb") : 0;
+	if(cut)
+	{
+		std::fwrite(page,1,sizeof(page),cut);
+		std::fclose(cut);
+		std::cout<<"File cut after the header loaded: "<<(load(L,"testcases_saved.bin") ? "yes" : "no")<<std::endl;
+	}
+	std::remove("testcases_saved.bin");
+	std::cout<<std::endl;
+
+
+/************************************************************************
+		MEAN AND COVARIANCE OF A STREAM OF ROWS(CSV FILE)
+*************************************************************************/
+	//Rows far from the origin, where x*x^T summed up and then centered would lose the digits
+	std::FILE* csv=std::fopen("testcases_rows.csv","w");
+	if(csv)
+	{
+		std::fprintf(csv,"x,y,z\n");
+		for(int r=0;r<1000;r++)
+		{
+			std::fprintf(csv,"%d,%d,%d\n",10000+r%7,20000-r%5,30000+(r%7)*(r%5));
+		}
+		std::fclose(csv);
+	}
+	SymMatCovariance<float> Acc(3);
+	SymMatRowReader<float> Rows("testcases_rows.csv",3,SymMatRowsCsvHeader);
+	if(accumulate(Rows,Acc,256))
+	{
+		std::cout<<"Mean of the "<<Acc.count()<<" rows is: "<<Acc.mean().transpose()<<std::endl;
+		std::cout<<"Their covariance is:"<<std::endl;
+		Acc.covariance().print();
+	}
+	std::remove("testcases_rows.csv");
+	std::cout<<std::endl;
+
+
 /************************************************************************
 						RAISING AN ERROR
 *************************************************************************/